@@ -1,6 +1,11 @@
 #ifndef LGFX_CROWPANEL_H
 #define LGFX_CROWPANEL_H
 
+#ifdef SIMULATOR
+// Native simulator build: in-memory framebuffer stand-in
+#include "SimLGFX.h"
+#else
+
 #define LGFX_USE_V1
 #include <LovyanGFX.hpp>
 #include <lgfx/v1/platforms/esp32s3/Panel_RGB.hpp>
@@ -99,4 +104,6 @@ public:
   }
 };
 
+#endif // SIMULATOR
+
 #endif // LGFX_CROWPANEL_H
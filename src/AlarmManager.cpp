@@ -0,0 +1,317 @@
+#include "AlarmManager.h"
+
+static const char* const DAY_ABBREVIATIONS[] = {"Su", "Mo", "Tu", "We", "Th", "Fr", "Sa"};
+static const time_t SECONDS_PER_DAY = 86400;
+
+AlarmManager::AlarmManager()
+    : _settings(nullptr),
+      _heapSize(0),
+      _rebuildPending(true),
+      _lastNow(0),
+      _snoozeUntil(0),
+      _snoozeAlarm(0),
+      _ringing(NONE),
+      _ringStart(0),
+      _ringFireTime(0),
+      _callback(nullptr),
+      _callbackContext(nullptr) {
+    memset(_heap, 0, sizeof(_heap));
+    memset(_lastFired, 0, sizeof(_lastFired));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool AlarmManager::begin(SettingsManager* settings) {
+    if (!settings) {
+        Serial.println("ERROR: AlarmManager needs a SettingsManager");
+        return false;
+    }
+
+    _settings = settings;
+    _rebuildPending = true;  // First update() with a known time builds the heap
+    Serial.printf("Alarms: %u configured\n", _settings->get().alarmCount);
+    return true;
+}
+
+void AlarmManager::onAlarm(AlarmCallback callback, void* context) {
+    _callback = callback;
+    _callbackContext = context;
+}
+
+void AlarmManager::update(time_t now) {
+    if (!_settings || now == 0) return;
+    _stats.updates++;
+
+    // A step backwards (resync, time zone change) leaves entries scheduled
+    // too late; forward steps are handled by the due check below
+    if (_rebuildPending || now < _lastNow) {
+        rebuild(now);
+    }
+    _lastNow = now;
+
+    if (_ringing != NONE && now - _ringStart >= (time_t)MAX_RING_S) {
+        Serial.println("Alarm: nobody answered, stopping");
+        dismiss();
+    }
+
+    while (_heapSize && _heap[0].fireTime <= now) {
+        HeapEntry entry = _heap[0];
+        pop();
+        fire(entry, now);
+    }
+}
+
+void AlarmManager::rebuild(time_t now) {
+    _heapSize = 0;
+    _rebuildPending = false;
+    _stats.rebuilds++;
+
+    // Anything within the grace period still rings, unless it already did
+    const SettingsData& data = _settings->get();
+    for (uint8_t i = 0; i < data.alarmCount; i++) {
+        schedule(i, max(now - (time_t)LATE_GRACE_S, _lastFired[i]));
+    }
+
+    if (_snoozeUntil) {
+        push({_snoozeUntil, _snoozeAlarm, true});
+    }
+}
+
+void AlarmManager::schedule(uint8_t index, time_t after) {
+    const AlarmConfig& alarm = _settings->get().alarms[index];
+    if (!(alarm.flags & ALARM_ENABLED)) return;
+
+    time_t next = nextOccurrence(alarm, after);
+    if (next) {
+        push({next, index, false});
+    }
+}
+
+void AlarmManager::fire(const HeapEntry& entry, time_t now) {
+    if (entry.snooze) {
+        _snoozeUntil = 0;
+    } else {
+        _lastFired[entry.index] = entry.fireTime;
+
+        const AlarmConfig& alarm = _settings->get().alarms[entry.index];
+        if (alarm.flags & ALARM_ONE_SHOT) {
+            // Turned off without a reindex - it just isn't rescheduled
+            _settings->edit(SETTINGS_ALARMS).alarms[entry.index].flags &= ~ALARM_ENABLED;
+        } else {
+            schedule(entry.index, entry.fireTime);
+        }
+    }
+
+    if (now - entry.fireTime > (time_t)LATE_GRACE_S) {
+        _stats.missed++;
+        notify(ALARM_EVT_MISSED, entry.index, entry.fireTime);
+        return;
+    }
+
+    if (_ringing != NONE) {
+        dismiss();  // The newer alarm takes over
+    }
+    _ringing = entry.index;
+    _ringStart = now;
+    _ringFireTime = entry.fireTime;
+    _stats.fired++;
+    notify(ALARM_EVT_RING, entry.index, entry.fireTime);
+}
+
+void AlarmManager::snooze(time_t now) {
+    if (_ringing == NONE) return;
+    if (now == 0) now = _lastNow;  // Clock lost since it started ringing
+
+    uint8_t minutes = _settings->get().alarms[_ringing].snoozeMinutes;
+    if (minutes == 0) minutes = 9;
+
+    // One snooze at a time; replacing a pending one means a reindex
+    if (_snoozeUntil) {
+        _rebuildPending = true;
+    }
+    _snoozeUntil = now + (time_t)minutes * 60;
+    _snoozeAlarm = _ringing;
+    if (!_rebuildPending) {
+        push({_snoozeUntil, _snoozeAlarm, true});
+    }
+
+    _stats.snoozed++;
+    _ringing = NONE;
+    notify(ALARM_EVT_SNOOZE, _snoozeAlarm, _snoozeUntil);
+}
+
+void AlarmManager::dismiss() {
+    if (_ringing == NONE) return;
+
+    uint8_t index = _ringing;
+    _ringing = NONE;
+    notify(ALARM_EVT_DISMISS, index, _ringFireTime);
+}
+
+void AlarmManager::notify(AlarmEventType type, uint8_t index, time_t fireTime) {
+    if (_callback) {
+        AlarmEvent event = {type, index, fireTime};
+        _callback(event, _callbackContext);
+    }
+}
+
+// Edits
+int8_t AlarmManager::addAlarm(const AlarmConfig& alarm) {
+    if (!_settings) return NONE;
+
+    int8_t spent = findSpentSlot();
+    if (spent == NONE && _settings->get().alarmCount >= SETTINGS_MAX_ALARMS) return NONE;
+
+    SettingsData& data = _settings->edit(SETTINGS_ALARMS);
+    uint8_t index = spent != NONE ? (uint8_t)spent : data.alarmCount++;
+    data.alarms[index] = alarm;
+    _lastFired[index] = 0;
+    _rebuildPending = true;
+    return index;
+}
+
+int8_t AlarmManager::findSpentSlot() const {
+    // fire() turns one-shot alarms off; once they've stopped ringing and
+    // have no snooze pending, nothing refers to the slot any more
+    const SettingsData& data = _settings->get();
+    for (uint8_t i = 0; i < data.alarmCount; i++) {
+        const AlarmConfig& alarm = data.alarms[i];
+        if (!(alarm.flags & ALARM_ONE_SHOT) || (alarm.flags & ALARM_ENABLED)) continue;
+        if (_ringing == (int8_t)i || (_snoozeUntil && _snoozeAlarm == i)) continue;
+        return i;
+    }
+    return NONE;
+}
+
+bool AlarmManager::setAlarm(uint8_t index, const AlarmConfig& alarm) {
+    if (!_settings || index >= _settings->get().alarmCount) return false;
+
+    _settings->edit(SETTINGS_ALARMS).alarms[index] = alarm;
+    _lastFired[index] = 0;
+    _rebuildPending = true;
+    return true;
+}
+
+bool AlarmManager::removeAlarm(uint8_t index) {
+    if (!_settings || index >= _settings->get().alarmCount) return false;
+
+    if (_ringing == (int8_t)index) dismiss();
+    if (_snoozeUntil && _snoozeAlarm == index) _snoozeUntil = 0;
+
+    // Later alarms move down one slot, along with their state
+    SettingsData& data = _settings->edit(SETTINGS_ALARMS);
+    for (uint8_t i = index; i + 1 < data.alarmCount; i++) {
+        data.alarms[i] = data.alarms[i + 1];
+        _lastFired[i] = _lastFired[i + 1];
+    }
+    data.alarmCount--;
+    _lastFired[data.alarmCount] = 0;
+
+    if (_ringing > (int8_t)index) _ringing--;
+    if (_snoozeUntil && _snoozeAlarm > index) _snoozeAlarm--;
+
+    _rebuildPending = true;
+    return true;
+}
+
+bool AlarmManager::setAlarmEnabled(uint8_t index, bool enabled) {
+    if (!_settings || index >= _settings->get().alarmCount) return false;
+
+    AlarmConfig& alarm = _settings->edit(SETTINGS_ALARMS).alarms[index];
+    if (enabled) {
+        alarm.flags |= ALARM_ENABLED;
+    } else {
+        alarm.flags &= ~ALARM_ENABLED;
+    }
+    _rebuildPending = true;
+    return true;
+}
+
+void AlarmManager::invalidate() {
+    _rebuildPending = true;
+}
+
+time_t AlarmManager::nextOccurrence(const AlarmConfig& alarm, time_t after) {
+    if (alarm.hour > 23 || alarm.minute > 59 || after < 0) return 0;
+
+    time_t day = after - after % SECONDS_PER_DAY;
+    time_t offset = (time_t)alarm.hour * 3600 + (time_t)alarm.minute * 60;
+
+    // Today's time may have passed, so look up to a week ahead
+    for (uint8_t d = 0; d <= 7; d++) {
+        time_t candidate = day + d * SECONDS_PER_DAY + offset;
+        if (candidate <= after) continue;
+
+        uint8_t weekday = (uint8_t)((day / SECONDS_PER_DAY + d + 4) % 7);  // 1970-01-01 was a Thursday
+        if (!alarm.days || (alarm.days & (1 << weekday))) {
+            return candidate;
+        }
+    }
+    return 0;
+}
+
+void AlarmManager::dump() {
+    if (!_settings) return;
+
+    const SettingsData& data = _settings->get();
+    Serial.printf("Alarms: %u configured, %u scheduled\n", data.alarmCount, _heapSize);
+    for (uint8_t i = 0; i < data.alarmCount; i++) {
+        const AlarmConfig& alarm = data.alarms[i];
+        char days[22] = "";
+        if (!alarm.days) {
+            strcpy(days, "any day");
+        }
+        for (uint8_t d = 0; d < 7; d++) {
+            if (alarm.days & (1 << d)) {
+                if (days[0]) strcat(days, " ");
+                strcat(days, DAY_ABBREVIATIONS[d]);
+            }
+        }
+        Serial.printf("  %u: %02u:%02u %s%s, snooze %u min%s\n", i, alarm.hour, alarm.minute, days,
+                      alarm.flags & ALARM_ONE_SHOT ? " (once)" : "", alarm.snoozeMinutes,
+                      alarm.flags & ALARM_ENABLED ? "" : ", off");
+    }
+
+    if (_heapSize && _lastNow) {
+        Serial.printf("  next: alarm %u%s in %ld s\n", _heap[0].index, _heap[0].snooze ? " (snooze)" : "",
+                      (long)(_heap[0].fireTime - _lastNow));
+    }
+    if (_ringing != NONE) {
+        Serial.printf("  ringing: alarm %d for %ld s\n", _ringing, (long)(_lastNow - _ringStart));
+    }
+    Serial.printf("  %lu updates, %lu rebuilds, %lu fired, %lu snoozed, %lu missed\n",
+                  (unsigned long)_stats.updates, (unsigned long)_stats.rebuilds, (unsigned long)_stats.fired,
+                  (unsigned long)_stats.snoozed, (unsigned long)_stats.missed);
+}
+
+// Min-heap on fireTime
+void AlarmManager::push(const HeapEntry& entry) {
+    if (_heapSize >= HEAP_CAPACITY) return;  // Can't happen: one entry per alarm plus the snooze
+
+    uint8_t pos = _heapSize++;
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (_heap[parent].fireTime <= entry.fireTime) break;
+        _heap[pos] = _heap[parent];
+        pos = parent;
+    }
+    _heap[pos] = entry;
+}
+
+void AlarmManager::pop() {
+    if (_heapSize == 0) return;
+    _heap[0] = _heap[--_heapSize];
+    siftDown(0);
+}
+
+void AlarmManager::siftDown(uint8_t pos) {
+    HeapEntry entry = _heap[pos];
+    for (;;) {
+        uint8_t child = pos * 2 + 1;
+        if (child >= _heapSize) break;
+        if (child + 1 < _heapSize && _heap[child + 1].fireTime < _heap[child].fireTime) child++;
+        if (entry.fireTime <= _heap[child].fireTime) break;
+        _heap[pos] = _heap[child];
+        pos = child;
+    }
+    _heap[pos] = entry;
+}
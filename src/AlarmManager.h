@@ -0,0 +1,124 @@
+#ifndef ALARM_MANAGER_H
+#define ALARM_MANAGER_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "SettingsManager.h"
+
+// Why an alarm callback ran
+enum AlarmEventType {
+    ALARM_EVT_RING,         // Alarm (or its snooze) went off
+    ALARM_EVT_SNOOZE,       // Ringing alarm snoozed
+    ALARM_EVT_DISMISS,      // Ringing alarm stopped (by the user or the ring timeout)
+    ALARM_EVT_MISSED        // Fire time passed while the clock jumped ahead
+};
+
+struct AlarmEvent {
+    AlarmEventType type;
+    uint8_t index;          // Into SettingsData::alarms
+    time_t fireTime;        // Scheduled local time
+};
+
+// Counters for diagnostics
+struct AlarmStats {
+    uint32_t updates;       // update() calls with a known time
+    uint32_t rebuilds;      // Full recomputes of the fire-time heap
+    uint32_t fired;
+    uint32_t snoozed;
+    uint32_t missed;
+};
+
+// Alarm engine over the alarms in SettingsData (stored by SettingsManager).
+// Upcoming fire times live in a min-heap keyed by local time, so update()
+// is a single comparison against the heap top unless something is due.
+// The heap is rebuilt only after an edit or when the clock steps backwards;
+// a forward step just finds the skipped entries due (or missed) at the top.
+//
+// All times are local time in seconds since the epoch, as shown on the
+// clock face. Everything runs on the UI task.
+class AlarmManager {
+public:
+    static const uint32_t LATE_GRACE_S = 120;     // Still ring this late (clock stepped, slow wake)
+    static const uint32_t MAX_RING_S = 10 * 60;   // Auto-dismiss after ringing this long
+    static const int8_t NONE = -1;
+
+    AlarmManager();
+
+    // Manager pattern
+    bool begin(SettingsManager* settings);
+    void update(time_t now);  // now = 0 while the time is unknown
+
+    // Edits go through SettingsManager (deferred write) and reindex on the
+    // next update(). Returns the alarm index, or NONE when full. addAlarm()
+    // reuses the slot of a one-shot alarm that has already gone off.
+    int8_t addAlarm(const AlarmConfig& alarm);
+    bool setAlarm(uint8_t index, const AlarmConfig& alarm);
+    bool removeAlarm(uint8_t index);
+    bool setAlarmEnabled(uint8_t index, bool enabled);
+    void invalidate();  // Alarms edited directly in SettingsData
+
+    // Ringing alarm
+    bool isRinging() const { return _ringing != NONE; }
+    int8_t getRingingAlarm() const { return _ringing; }
+    void snooze(time_t now);  // Ring again snoozeMinutes after now
+    void dismiss();
+
+    // Next alarm or snooze in local time, 0 if nothing is scheduled. The
+    // caller turns this into a scheduler wake-up, so nothing polls between
+    // alarms.
+    time_t getNextFireTime() const { return _heapSize ? _heap[0].fireTime : 0; }
+    int8_t getNextAlarm() const { return _heapSize ? (int8_t)_heap[0].index : NONE; }
+
+    // When a ringing alarm gives up (MAX_RING_S), 0 if none is ringing
+    time_t getRingTimeout() const { return _ringing != NONE ? _ringStart + (time_t)MAX_RING_S : 0; }
+
+    typedef void (*AlarmCallback)(const AlarmEvent& event, void* context);
+    void onAlarm(AlarmCallback callback, void* context = nullptr);
+
+    const AlarmStats& getStats() const { return _stats; }
+    void dump();  // Print alarms, the heap top and counters to Serial
+
+    // Next time after `after` that the alarm's hour:minute falls on one of
+    // its days (days = 0: any day). 0 if the alarm can't fire.
+    static time_t nextOccurrence(const AlarmConfig& alarm, time_t after);
+
+private:
+    static const uint8_t SNOOZE_SLOT = SETTINGS_MAX_ALARMS;  // _lastFired index of the snooze entry
+    static const uint8_t HEAP_CAPACITY = SETTINGS_MAX_ALARMS + 1;  // Every alarm plus one snooze
+
+    struct HeapEntry {
+        time_t fireTime;
+        uint8_t index;
+        bool snooze;
+    };
+
+    SettingsManager* _settings;
+    HeapEntry _heap[HEAP_CAPACITY];
+    uint8_t _heapSize;
+    time_t _lastFired[SETTINGS_MAX_ALARMS];  // Fire time already rung, per alarm
+    bool _rebuildPending;
+    time_t _lastNow;
+
+    // Snooze and ringing state
+    time_t _snoozeUntil;    // 0 = no snooze pending
+    uint8_t _snoozeAlarm;
+    int8_t _ringing;
+    time_t _ringStart;
+    time_t _ringFireTime;
+
+    AlarmCallback _callback;
+    void* _callbackContext;
+    AlarmStats _stats;
+
+    int8_t findSpentSlot() const;
+    void rebuild(time_t now);
+    void fire(const HeapEntry& entry, time_t now);
+    void schedule(uint8_t index, time_t after);
+    void notify(AlarmEventType type, uint8_t index, time_t fireTime);
+
+    void push(const HeapEntry& entry);
+    void pop();
+    void siftDown(uint8_t pos);
+};
+
+#endif // ALARM_MANAGER_H
@@ -0,0 +1,155 @@
+#include "ArduinoWiFiRadio.h"
+
+// Static member initialization
+ArduinoWiFiRadio* ArduinoWiFiRadio::_instance = nullptr;
+
+ArduinoWiFiRadio::ArduinoWiFiRadio()
+    : _callback(nullptr),
+      _context(nullptr) {
+    _instance = this;  // For static callback
+}
+
+ArduinoWiFiRadio::~ArduinoWiFiRadio() {
+    _instance = nullptr;
+}
+
+void ArduinoWiFiRadio::begin(EventCallback callback, void* context) {
+    _callback = callback;
+    _context = context;
+    WiFi.onEvent(wifiEventHandler);
+
+    // The retry policy owns reconnects; the core's auto-reconnect would
+    // retry immediately on every beacon timeout and defeat the backoff
+    WiFi.setAutoReconnect(false);
+    WiFi.mode(WIFI_STA);
+}
+
+void ArduinoWiFiRadio::connect(const char* ssid, const char* password, const WiFiFastConnect* fast) {
+    // Always DHCP: the scan is the slow part, and a reused address could
+    // have been leased to someone else while we were away
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    if (fast) {
+        WiFi.begin(ssid, password, fast->channel, fast->bssid);  // Known AP, no channel scan
+    } else {
+        WiFi.begin(ssid, password);
+    }
+}
+
+void ArduinoWiFiRadio::disconnect(bool radioOff) {
+    WiFi.disconnect(radioOff);
+}
+
+bool ArduinoWiFiRadio::getConnection(WiFiFastConnect& info) {
+    memset(&info, 0, sizeof(info));
+    if (WiFi.status() != WL_CONNECTED) return false;
+
+    String ssid = WiFi.SSID();
+    strncpy(info.ssid, ssid.c_str(), sizeof(info.ssid) - 1);
+    uint8_t* bssid = WiFi.BSSID();
+    if (bssid) {
+        memcpy(info.bssid, bssid, sizeof(info.bssid));
+    }
+    info.channel = WiFi.channel();
+    info.ip = WiFi.localIP();
+    info.gateway = WiFi.gatewayIP();
+    info.subnet = WiFi.subnetMask();
+    info.dns = WiFi.dnsIP(0);
+    return true;
+}
+
+void ArduinoWiFiRadio::startProvisioning() {
+    // Generate unique device name with chip MAC
+    uint64_t chipid = ESP.getEfuseMac();
+    String deviceName = "PROV_ALARM_" + String((uint32_t)(chipid >> 32), HEX);
+
+    const char* pop = "abcd1234";  // Proof of possession
+    const char* service_name = deviceName.c_str();
+
+    // Generate random UUID for this provisioning session
+    uint8_t uuid[16];
+    for (int i = 0; i < 16; i++) {
+        uuid[i] = random(0, 255);
+    }
+
+    Serial.printf("Starting BLE provisioning with device name: %s\n", service_name);
+    Serial.printf("Proof of Possession: %s\n", pop);
+
+    // Start WiFi provisioning via BLE
+    WiFiProv.beginProvision(
+        WIFI_PROV_SCHEME_BLE,
+        WIFI_PROV_SCHEME_HANDLER_FREE_BLE,  // Free BT memory after provisioning
+        WIFI_PROV_SECURITY_1,               // Encrypted provisioning
+        pop,
+        service_name,
+        NULL,          // service_key = NULL for BLE
+        uuid,
+        true           // reset_provisioned = true (clear old credentials)
+    );
+
+    // Note: WiFiProv.printQR() is not available in this version
+    // We're using our own QRCodeWidget to display the App Store URL instead
+    Serial.println("BLE provisioning started successfully");
+}
+
+const char* ArduinoWiFiRadio::getReasonName(uint8_t reason) {
+    return WiFi.disconnectReasonName((wifi_err_reason_t)reason);
+}
+
+// Static WiFi event handler - runs on the ESP-IDF event task, so it only
+// copies the event out for the callback to queue
+void ArduinoWiFiRadio::wifiEventHandler(arduino_event_t* event) {
+    if (!_instance || !_instance->_callback) return;
+
+    WiFiStackEvent queued;
+    memset(&queued, 0, sizeof(queued));
+    queued.timestamp = millis();
+
+    switch (event->event_id) {
+        case ARDUINO_EVENT_PROV_START:
+            Serial.println("[WiFi Event] Provisioning started");
+            return;
+
+        case ARDUINO_EVENT_PROV_CRED_RECV: {
+            Serial.println("[WiFi Event] Received WiFi credentials");
+            // Fixed-size fields, not necessarily NUL-terminated
+            const wifi_sta_config_t& cred = event->event_info.prov_cred_recv;
+            memcpy(queued.ssid, cred.ssid, min(sizeof(cred.ssid), sizeof(queued.ssid) - 1));
+            memcpy(queued.password, cred.password, min(sizeof(cred.password), sizeof(queued.password) - 1));
+            Serial.printf("  SSID: %s\n", queued.ssid);
+            // Don't log password for security
+            queued.type = WIFI_EVT_PROV_CRED_RECV;
+            break;
+        }
+
+        case ARDUINO_EVENT_PROV_CRED_SUCCESS:
+            Serial.println("[WiFi Event] Provisioning successful!");
+            queued.type = WIFI_EVT_PROV_SUCCESS;
+            break;
+
+        case ARDUINO_EVENT_PROV_CRED_FAIL:
+            Serial.println("[WiFi Event] Provisioning failed - invalid credentials");
+            queued.type = WIFI_EVT_PROV_FAIL;
+            break;
+
+        case ARDUINO_EVENT_PROV_END:
+            Serial.println("[WiFi Event] Provisioning ended");
+            return;
+
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            Serial.println("[WiFi Event] Got IP address");
+            Serial.printf("  IP: %s\n", WiFi.localIP().toString().c_str());
+            queued.type = WIFI_EVT_GOT_IP;
+            break;
+
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            Serial.println("[WiFi Event] Disconnected from WiFi");
+            queued.type = WIFI_EVT_DISCONNECTED;
+            queued.reason = event->event_info.wifi_sta_disconnected.reason;
+            break;
+
+        default:
+            return;
+    }
+
+    _instance->_callback(queued, _instance->_context);
+}
@@ -0,0 +1,38 @@
+#ifndef ARDUINO_WIFI_RADIO_H
+#define ARDUINO_WIFI_RADIO_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiProv.h>
+#include "WiFiRadio.h"
+
+// WiFiRadio on the arduino-esp32 WiFi and WiFiProv (BLE) libraries
+class ArduinoWiFiRadio : public WiFiRadio {
+public:
+    ArduinoWiFiRadio();
+    ~ArduinoWiFiRadio();
+
+    void begin(EventCallback callback, void* context) override;
+    uint32_t now() override { return millis(); }
+
+    void connect(const char* ssid, const char* password, const WiFiFastConnect* fast) override;
+    void disconnect(bool radioOff = false) override;
+    bool isConnected() override { return WiFi.status() == WL_CONNECTED; }
+    int getStatus() override { return WiFi.status(); }
+
+    bool getConnection(WiFiFastConnect& info) override;
+    int8_t getRSSI() override { return WiFi.RSSI(); }
+
+    void startProvisioning() override;
+    const char* getReasonName(uint8_t reason) override;
+
+private:
+    EventCallback _callback;
+    void* _context;
+
+    // Static callback for WiFi events
+    static void wifiEventHandler(arduino_event_t* event);
+    static ArduinoWiFiRadio* _instance;  // For static callback
+};
+
+#endif // ARDUINO_WIFI_RADIO_H
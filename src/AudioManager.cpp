@@ -0,0 +1,405 @@
+#include "AudioManager.h"
+#include <SPIFFS.h>
+
+// Samples buffered before a new sound starts, so it doesn't open on an underrun
+static const uint16_t PREFILL_SAMPLES = 512;
+
+AudioManager::AudioManager()
+    : _decodeTask(nullptr),
+      _outputTask(nullptr),
+      _i2sEvents(nullptr),
+      _source(nullptr),
+      _loop(false),
+      _haveFiles(false),
+      _session(0),
+      _outputSession(0),
+      _sessionRate(0),
+      _sourceDone(true),
+      _rampSequence(0),
+      _rampTarget(0),
+      _rampMs(0),
+      _rampFromSilence(false),
+      _playing(false),
+      _outputRate(DEFAULT_SAMPLE_RATE),
+      _gain(0),
+      _gainTarget(0),
+      _gainStep(0),
+      _gainFramesLeft(0),
+      _seenRampSequence(0) {
+    memset(&_stats, 0, sizeof(_stats));
+    _stats.ringLowWater = _ring.capacity();
+}
+
+AudioManager::~AudioManager() {
+    if (_decodeTask) {
+        vTaskDelete(_decodeTask);
+        _decodeTask = nullptr;
+    }
+    if (_outputTask) {
+        vTaskDelete(_outputTask);
+        _outputTask = nullptr;
+    }
+    if (_i2sEvents) {
+        i2s_driver_uninstall(I2S_PORT);
+        _i2sEvents = nullptr;
+    }
+}
+
+bool AudioManager::begin(BaseType_t core) {
+    // Sound files are optional - alarms fall back to the built-in beep
+    _haveFiles = SPIFFS.begin(false);
+    if (!_haveFiles) {
+        Serial.println("Audio: no sound files (upload with pio run -t uploadfs), using the built-in beep");
+    }
+
+    i2s_config_t config = {};
+    config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX);
+    config.sample_rate = DEFAULT_SAMPLE_RATE;
+    config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    config.channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT;
+    config.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    config.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    config.dma_buf_count = DMA_BUFFERS;
+    config.dma_buf_len = DMA_FRAMES;
+    config.use_apll = false;
+    config.tx_desc_auto_clear = true;  // Starved DMA sends silence, not the last buffer again
+
+    if (i2s_driver_install(I2S_PORT, &config, 8, &_i2sEvents) != ESP_OK) {
+        Serial.println("ERROR: I2S driver install failed, audio disabled");
+        _i2sEvents = nullptr;
+        return false;
+    }
+
+    i2s_pin_config_t pins = {};
+    pins.mck_io_num = I2S_PIN_NO_CHANGE;
+    pins.bck_io_num = PIN_BCLK;
+    pins.ws_io_num = PIN_LRCLK;
+    pins.data_out_num = PIN_DOUT;
+    pins.data_in_num = I2S_PIN_NO_CHANGE;
+    if (i2s_set_pin(I2S_PORT, &pins) != ESP_OK) {
+        Serial.println("ERROR: I2S pin setup failed, audio disabled");
+        i2s_driver_uninstall(I2S_PORT);
+        _i2sEvents = nullptr;
+        return false;
+    }
+    i2s_zero_dma_buffer(I2S_PORT);
+    i2s_stop(I2S_PORT);  // Amplifier idles without a clock until something plays
+
+    // The output task outranks the decode task: it has one DMA buffer's
+    // time to refill, while the decoder has the whole ring
+    BaseType_t created = xTaskCreatePinnedToCore(outputTaskMain, "audio-out", OUTPUT_STACK_SIZE, this, 5,
+                                                 &_outputTask, core);
+    if (created == pdPASS) {
+        created = xTaskCreatePinnedToCore(decodeTaskMain, "audio-dec", DECODE_STACK_SIZE, this, 2,
+                                          &_decodeTask, core);
+    }
+    if (created != pdPASS) {
+        Serial.println("ERROR: Failed to create audio tasks, audio disabled");
+        if (_outputTask) {
+            vTaskDelete(_outputTask);
+            _outputTask = nullptr;
+        }
+        _decodeTask = nullptr;
+        i2s_driver_uninstall(I2S_PORT);
+        _i2sEvents = nullptr;
+        return false;
+    }
+
+    Serial.printf("Audio tasks started on core %d (%u x %u frame DMA buffers, %u sample ring)\n", (int)core,
+                  (unsigned)DMA_BUFFERS, (unsigned)DMA_FRAMES, (unsigned)_ring.capacity());
+    return true;
+}
+
+// UI side
+bool AudioManager::play(const char* path, bool loop, uint8_t volume, uint32_t rampMs) {
+    AudioCommand command = {};
+    command.type = AUDIO_CMD_PLAY;
+    if (path) {
+        strncpy(command.path, path, sizeof(command.path) - 1);
+    }
+    command.loop = loop;
+    command.volume = volume;
+    command.rampMs = rampMs;
+    return postCommand(command);
+}
+
+bool AudioManager::stop() {
+    AudioCommand command = {};
+    command.type = AUDIO_CMD_STOP;
+    return postCommand(command);
+}
+
+bool AudioManager::setVolume(uint8_t volume, uint32_t rampMs) {
+    AudioCommand command = {};
+    command.type = AUDIO_CMD_VOLUME;
+    command.volume = volume;
+    command.rampMs = rampMs;
+    return postCommand(command);
+}
+
+bool AudioManager::dumpStats() {
+    AudioCommand command = {};
+    command.type = AUDIO_CMD_DUMP_STATS;
+    return postCommand(command);
+}
+
+bool AudioManager::postCommand(const AudioCommand& command) {
+    if (!_decodeTask) return false;
+
+    if (!_commands.push(command)) {
+        Serial.println("WARNING: Audio command queue full, command dropped");
+        return false;
+    }
+    xTaskNotifyGive(_decodeTask);
+    return true;
+}
+
+// Decode task
+void AudioManager::decodeTaskMain(void* arg) {
+    AudioManager* self = static_cast<AudioManager*>(arg);
+
+    for (;;) {
+        self->processCommands();
+        if (self->_source) {
+            self->decode();
+        }
+
+        // Woken by commands and by the output task freeing ring space
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IDLE_WAIT_MS));
+    }
+}
+
+void AudioManager::processCommands() {
+    AudioCommand command;
+    while (_commands.pop(command)) {
+        switch (command.type) {
+            case AUDIO_CMD_PLAY:
+                startSound(command);
+                break;
+
+            case AUDIO_CMD_STOP:
+                stopSound();
+                break;
+
+            case AUDIO_CMD_VOLUME:
+                setRamp(command.volume, command.rampMs, false);
+                break;
+
+            case AUDIO_CMD_DUMP_STATS:
+                dumpStatsNow();
+                break;
+        }
+    }
+}
+
+void AudioManager::startSound(const AudioCommand& command) {
+    _source = nullptr;
+
+    AudioSource* source = &_tone;
+    if (command.path[0] && _haveFiles && _wav.open(SPIFFS, command.path)) {
+        source = &_wav;
+    } else {
+        if (command.path[0]) {
+            _stats.openFailures++;
+            Serial.printf("Audio: %s unavailable, playing the built-in beep\n", command.path);
+        }
+        _wav.close();
+        _tone.rewind();
+    }
+
+    _loop = command.loop;
+    setRamp(command.volume, command.rampMs, command.rampMs > 0);
+    newSession(source->getSampleRate());
+
+    _source = source;
+    _stats.plays++;
+    decode();
+}
+
+void AudioManager::stopSound() {
+    _source = nullptr;
+    _wav.close();
+    newSession(0);
+}
+
+void AudioManager::newSession(uint32_t sampleRate) {
+    _sourceDone.store(sampleRate == 0, std::memory_order_relaxed);
+    _sessionRate.store(sampleRate, std::memory_order_relaxed);
+    uint32_t session = _session.load(std::memory_order_relaxed) + 1;
+    _session.store(session, std::memory_order_release);
+    xTaskNotifyGive(_outputTask);
+
+    // The ring still belongs to the old sound until the output task has
+    // dropped it - at most one DMA buffer's time
+    while (_outputSession.load(std::memory_order_acquire) != session) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(5));
+    }
+}
+
+void AudioManager::setRamp(uint8_t volume, uint32_t rampMs, bool fromSilence) {
+    _rampTarget.store(volumeToGain(volume), std::memory_order_relaxed);
+    _rampMs.store(rampMs, std::memory_order_relaxed);
+    _rampFromSilence.store(fromSilence, std::memory_order_relaxed);
+    _rampSequence.fetch_add(1, std::memory_order_release);
+}
+
+void AudioManager::decode() {
+    // Whole chunks only, so a write never comes up short
+    while (_source && _ring.space() >= DECODE_CHUNK) {
+        uint32_t start = micros();
+        size_t got = _source->read(_decodeBuffer, DECODE_CHUNK);
+
+        // Gapless loop: the start of the next pass goes in the same chunk
+        while (got < DECODE_CHUNK && _loop) {
+            if (!_source->rewind()) break;
+            size_t more = _source->read(_decodeBuffer + got, DECODE_CHUNK - got);
+            if (more == 0) break;  // Empty sound
+            got += more;
+            _stats.loops++;
+        }
+        _stats.maxDecodeUs = max(_stats.maxDecodeUs, (uint32_t)(micros() - start));
+
+        _ring.write(_decodeBuffer, got);
+        if (got < DECODE_CHUNK) {
+            // Ring contents first, then the flag (release) - see refill()
+            _sourceDone.store(true, std::memory_order_release);
+            _source = nullptr;
+            _wav.close();
+        }
+        xTaskNotifyGive(_outputTask);
+    }
+}
+
+void AudioManager::dumpStatsNow() {
+    Serial.printf("Audio: %s, ring %u/%u samples (low %u), files %s\n", isPlaying() ? "playing" : "idle",
+                  (unsigned)_ring.size(), (unsigned)_ring.capacity(), (unsigned)_stats.ringLowWater,
+                  _haveFiles ? "mounted" : "none");
+    Serial.printf("  %lu plays, %lu loops, %lu completed, %lu open failures\n", (unsigned long)_stats.plays,
+                  (unsigned long)_stats.loops, (unsigned long)_stats.completed,
+                  (unsigned long)_stats.openFailures);
+    Serial.printf("  %lu underruns, %lu DMA underruns, max decode %lu us, %lu dropped commands\n",
+                  (unsigned long)_stats.underruns, (unsigned long)_stats.dmaUnderruns,
+                  (unsigned long)_stats.maxDecodeUs, (unsigned long)getDroppedCommands());
+}
+
+// Output task
+void AudioManager::outputTaskMain(void* arg) {
+    AudioManager* self = static_cast<AudioManager*>(arg);
+
+    for (;;) {
+        uint32_t session = self->_session.load(std::memory_order_acquire);
+        if (session != self->_outputSession.load(std::memory_order_relaxed)) {
+            self->_ring.clear();
+            uint32_t rate = self->_sessionRate.load(std::memory_order_relaxed);
+            self->_outputSession.store(session, std::memory_order_release);
+            xTaskNotifyGive(self->_decodeTask);
+
+            if (rate == 0) {
+                self->_playing.store(false, std::memory_order_release);
+                i2s_zero_dma_buffer(I2S_PORT);
+                i2s_stop(I2S_PORT);
+                continue;
+            }
+
+            if (rate != self->_outputRate) {
+                i2s_set_sample_rates(I2S_PORT, rate);
+                self->_outputRate = rate;
+            }
+
+            // Let the decoder get ahead before the first refill
+            while (self->_ring.size() < PREFILL_SAMPLES && !self->_sourceDone.load(std::memory_order_acquire) &&
+                   self->_session.load(std::memory_order_acquire) == session) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+            }
+            xQueueReset(self->_i2sEvents);
+            i2s_start(I2S_PORT);
+            self->_playing.store(true, std::memory_order_release);
+            continue;
+        }
+
+        if (!self->_playing.load(std::memory_order_relaxed)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        if (!self->refill()) {
+            // Played out: push silence through both DMA buffers, then idle
+            memset(self->_stereo, 0, sizeof(self->_stereo));
+            for (uint8_t i = 0; i < DMA_BUFFERS; i++) {
+                size_t written;
+                i2s_write(I2S_PORT, self->_stereo, sizeof(self->_stereo), &written, portMAX_DELAY);
+            }
+            i2s_stop(I2S_PORT);
+            self->_stats.completed++;
+            self->_playing.store(false, std::memory_order_release);
+        }
+    }
+}
+
+bool AudioManager::refill() {
+    // Read the flag before the ring: if the decoder was done by then,
+    // everything it wrote is already visible
+    bool done = _sourceDone.load(std::memory_order_acquire);
+    uint16_t buffered = _ring.size();
+    uint16_t got = _ring.read(_mono, DMA_FRAMES);
+    if (got < DMA_FRAMES) {
+        if (done && got == 0) return false;
+        if (!done) _stats.underruns++;
+        memset(_mono + got, 0, (DMA_FRAMES - got) * sizeof(int16_t));
+    }
+    if (!done && buffered < _stats.ringLowWater) {  // A finished sound drains the ring on purpose
+        _stats.ringLowWater = buffered;
+    }
+    xTaskNotifyGive(_decodeTask);  // Room for another chunk
+
+    applyRamp();
+
+    // Blocks until the DMA has a free buffer - this is the task's pacing
+    size_t written;
+    i2s_write(I2S_PORT, _stereo, sizeof(_stereo), &written, portMAX_DELAY);
+    drainEvents();
+    return true;
+}
+
+void AudioManager::applyRamp() {
+    uint32_t sequence = _rampSequence.load(std::memory_order_acquire);
+    if (sequence != _seenRampSequence) {
+        _seenRampSequence = sequence;
+        _gainTarget = _rampTarget.load(std::memory_order_relaxed);
+        if (_rampFromSilence.load(std::memory_order_relaxed)) {
+            _gain = 0;
+        }
+        _gainFramesLeft = (uint32_t)((uint64_t)_rampMs.load(std::memory_order_relaxed) * _outputRate / 1000);
+        if (_gainFramesLeft == 0) {
+            _gain = _gainTarget;
+        } else {
+            _gainStep = (int32_t)(((int64_t)_gainTarget - (int64_t)_gain) / (int64_t)_gainFramesLeft);
+        }
+    }
+
+    // Mono to both channels; the MAX98357A plays (L+R)/2 by default
+    for (uint16_t i = 0; i < DMA_FRAMES; i++) {
+        if (_gainFramesLeft) {
+            _gain += _gainStep;
+            if (--_gainFramesLeft == 0) _gain = _gainTarget;
+        }
+        int16_t sample = (int16_t)(((int32_t)_mono[i] * (int32_t)(_gain >> 15)) >> 15);
+        _stereo[i * 2] = sample;
+        _stereo[i * 2 + 1] = sample;
+    }
+}
+
+void AudioManager::drainEvents() {
+    i2s_event_t event;
+    while (xQueueReceive(_i2sEvents, &event, 0) == pdTRUE) {
+        if (event.type == I2S_EVENT_TX_Q_OVF) {
+            _stats.dmaUnderruns++;  // Every DMA buffer was empty - silence went out
+        }
+    }
+}
+
+uint32_t AudioManager::volumeToGain(uint8_t volume) {
+    // Squared, so the 0-100 scale sounds roughly even
+    uint32_t v = min(volume, (uint8_t)100);
+    return (uint32_t)((uint64_t)GAIN_UNITY * v * v / 10000);
+}
@@ -0,0 +1,155 @@
+#ifndef AUDIO_MANAGER_H
+#define AUDIO_MANAGER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <driver/i2s.h>
+#include "AudioSource.h"
+#include "WavSource.h"
+#include "RingBuffer.h"
+
+// Commands from the UI to the decode task
+enum AudioCommandType {
+    AUDIO_CMD_PLAY,
+    AUDIO_CMD_STOP,
+    AUDIO_CMD_VOLUME,
+    AUDIO_CMD_DUMP_STATS        // Print AudioStats to Serial from the decode task
+};
+
+struct AudioCommand {
+    AudioCommandType type;
+    char path[32];              // Sound file; empty = built-in beep
+    bool loop;
+    uint8_t volume;             // 0-100
+    uint32_t rampMs;            // Fade to volume over this long
+};
+
+// Counters for diagnostics. Each field is written by one task only, so a
+// snapshot read from the UI may be a little stale but never corrupt.
+struct AudioStats {
+    uint32_t plays;
+    uint32_t loops;             // Gapless restarts of a looping sound
+    uint32_t completed;         // Sounds that played to the end
+    uint32_t openFailures;      // Missing or unplayable files (played the beep instead)
+    uint32_t underruns;         // DMA refills short of decoded samples while playing
+    uint32_t dmaUnderruns;      // DMA ran dry and sent silence (I2S_EVENT_TX_Q_OVF)
+    uint32_t maxDecodeUs;       // Longest single decode chunk, flash reads included
+    uint16_t ringLowWater;      // Fewest buffered samples seen at a refill while playing
+};
+
+// Alarm sound playback over I2S to the MAX98357A amplifier. Sounds stream
+// from the flash filesystem (the "spiffs" partition in partitions.csv,
+// uploaded with `pio run -t uploadfs`) through two tasks:
+//
+//   decode task:  AudioSource -> sample ring   (flash reads, decoding)
+//   output task:  sample ring -> I2S DMA       (volume, stereo, underruns)
+//
+// The ring holds a few hundred ms of decoded samples, so a slow flash read
+// never reaches the speaker. The output task refills one DMA buffer at a
+// time against a pair of them (double buffering): while the hardware plays
+// one, the task fills the other. Looping sounds rewind inside the decode
+// task without draining the ring, so there is no gap at the loop point.
+//
+// The UI only posts commands and reads status; nothing here blocks it.
+class AudioManager {
+public:
+    static const uint32_t DEFAULT_RAMP_MS = 30000;  // Alarms fade in over this long
+
+    AudioManager();
+    ~AudioManager();
+
+    // Core 1 by default: the tasks mostly sleep in i2s_write(), and the
+    // WiFi stack's bursts on core 0 run at a far higher priority
+    bool begin(BaseType_t core = 1);
+    bool isRunning() const { return _decodeTask != nullptr; }
+
+    // UI side. path = nullptr plays the built-in beep. Starting from
+    // silence with rampMs > 0 fades in; otherwise the volume is immediate.
+    bool play(const char* path, bool loop = false, uint8_t volume = 70, uint32_t rampMs = 0);
+    bool stop();
+    bool setVolume(uint8_t volume, uint32_t rampMs = 0);
+    bool dumpStats();
+
+    bool isPlaying() const { return _playing.load(std::memory_order_acquire); }
+    AudioStats getStats() const { return _stats; }
+    uint32_t getDroppedCommands() const { return _commands.getOverflowCount(); }
+
+private:
+    static const i2s_port_t I2S_PORT = I2S_NUM_0;
+    static const int PIN_BCLK = 42;
+    static const int PIN_LRCLK = 17;
+    static const int PIN_DOUT = 18;
+
+    static const uint16_t DMA_FRAMES = 256;        // Per DMA buffer: 11.6 ms at 22.05 kHz
+    static const uint8_t DMA_BUFFERS = 2;
+    static const uint16_t RING_SAMPLES = 8192;     // ~370 ms at 22.05 kHz
+    static const uint16_t DECODE_CHUNK = 512;
+    static const uint32_t DEFAULT_SAMPLE_RATE = 22050;
+    static const uint32_t IDLE_WAIT_MS = 100;
+    static const uint32_t DECODE_STACK_SIZE = 4096;
+    static const uint32_t OUTPUT_STACK_SIZE = 3072;
+    static const uint32_t GAIN_UNITY = 1UL << 30;  // Q30
+
+    TaskHandle_t _decodeTask;
+    TaskHandle_t _outputTask;
+    QueueHandle_t _i2sEvents;
+
+    RingBuffer<AudioCommand, 8> _commands;      // UI -> decode
+    RingBuffer<int16_t, RING_SAMPLES> _ring;    // Decode -> output
+
+    // Decode task state
+    AudioSource* _source;   // _wav or _tone while playing, else nullptr
+    WavSource _wav;
+    ToneSource _tone;
+    bool _loop;
+    bool _haveFiles;        // Filesystem mounted
+    int16_t _decodeBuffer[DECODE_CHUNK];
+
+    // Decode -> output handoff. A new session (play/stop) makes the output
+    // task drop whatever is still in the ring and switch sample rate; the
+    // decode task waits for that before writing the new sound.
+    std::atomic<uint32_t> _session;
+    std::atomic<uint32_t> _outputSession;
+    std::atomic<uint32_t> _sessionRate;        // 0 = stopped
+    std::atomic<bool> _sourceDone;             // No more samples coming this session
+    std::atomic<uint32_t> _rampSequence;       // Bumped for each volume change
+    std::atomic<uint32_t> _rampTarget;         // Q30 gain
+    std::atomic<uint32_t> _rampMs;
+    std::atomic<bool> _rampFromSilence;
+    std::atomic<bool> _playing;
+
+    // Output task state
+    uint32_t _outputRate;
+    uint32_t _gain;                            // Q30
+    uint32_t _gainTarget;
+    int32_t _gainStep;                         // Per frame, Q30
+    uint32_t _gainFramesLeft;
+    uint32_t _seenRampSequence;
+    int16_t _mono[DMA_FRAMES];
+    int16_t _stereo[DMA_FRAMES * 2];
+
+    AudioStats _stats;
+
+    bool postCommand(const AudioCommand& command);
+
+    // Decode task
+    void processCommands();
+    void startSound(const AudioCommand& command);
+    void stopSound();
+    void newSession(uint32_t sampleRate);
+    void setRamp(uint8_t volume, uint32_t rampMs, bool fromSilence);
+    void decode();
+    void dumpStatsNow();
+
+    // Output task
+    bool refill();
+    void applyRamp();
+    void drainEvents();
+
+    static uint32_t volumeToGain(uint8_t volume);
+
+    static void decodeTaskMain(void* arg);
+    static void outputTaskMain(void* arg);
+};
+
+#endif // AUDIO_MANAGER_H
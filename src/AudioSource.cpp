@@ -0,0 +1,52 @@
+#include "AudioSource.h"
+
+// One sine period at half scale, leaving headroom for the volume stage
+static const int16_t SINE_TABLE[64] = {
+        0,   1606,   3196,   4756,   6270,   7723,   9102,  10394,
+    11585,  12665,  13623,  14449,  15137,  15679,  16069,  16305,
+    16384,  16305,  16069,  15679,  15137,  14449,  13623,  12665,
+    11585,  10394,   9102,   7723,   6270,   4756,   3196,   1606,
+        0,  -1606,  -3196,  -4756,  -6270,  -7723,  -9102, -10394,
+   -11585, -12665, -13623, -14449, -15137, -15679, -16069, -16305,
+   -16384, -16305, -16069, -15679, -15137, -14449, -13623, -12665,
+   -11585, -10394,  -9102,  -7723,  -6270,  -4756,  -3196,  -1606
+};
+
+// Beep edges fade over this many frames instead of clicking
+static const uint32_t EDGE_FRAMES = 32;
+
+ToneSource::ToneSource(uint16_t frequency)
+    : _phaseStep((uint32_t)(((uint64_t)frequency << 32) / SAMPLE_RATE)),
+      _phase(0),
+      _position(0) {
+}
+
+size_t ToneSource::read(int16_t* out, size_t frames) {
+    size_t count = 0;
+    while (count < frames && _position < TOTAL_FRAMES) {
+        uint32_t inBeep = _position % (BEEP_FRAMES * 2);
+        bool on = _position < BEEP_FRAMES * 2 * BEEPS && inBeep < BEEP_FRAMES;
+
+        int32_t sample = 0;
+        if (on) {
+            sample = SINE_TABLE[_phase >> 26];
+            uint32_t edge = min(inBeep, BEEP_FRAMES - 1 - inBeep);
+            if (edge < EDGE_FRAMES) {
+                sample = sample * (int32_t)edge / (int32_t)EDGE_FRAMES;
+            }
+            _phase += _phaseStep;
+        } else {
+            _phase = 0;  // Every beep starts at a zero crossing
+        }
+
+        out[count++] = (int16_t)sample;
+        _position++;
+    }
+    return count;
+}
+
+bool ToneSource::rewind() {
+    _position = 0;
+    _phase = 0;
+    return true;
+}
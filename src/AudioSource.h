@@ -0,0 +1,46 @@
+#ifndef AUDIO_SOURCE_H
+#define AUDIO_SOURCE_H
+
+#include <Arduino.h>
+
+// Incremental decoder feeding the audio pipeline. Sources hand out mono
+// 16-bit samples a chunk at a time, so nothing is ever loaded whole.
+// Sources are driven only from the audio decode task.
+class AudioSource {
+public:
+    virtual ~AudioSource() {}
+
+    virtual uint32_t getSampleRate() const = 0;
+
+    // Decode up to `frames` samples into out. Fewer than asked means the
+    // sound ended (0 once it has).
+    virtual size_t read(int16_t* out, size_t frames) = 0;
+
+    // Back to the first sample, for looping
+    virtual bool rewind() = 0;
+};
+
+// Built-in alarm beep (four short beeps, then a pause) synthesized on the
+// fly. Always available, so an alarm still sounds with no files uploaded.
+class ToneSource : public AudioSource {
+public:
+    static const uint32_t SAMPLE_RATE = 16000;
+
+    explicit ToneSource(uint16_t frequency = 880);
+
+    uint32_t getSampleRate() const override { return SAMPLE_RATE; }
+    size_t read(int16_t* out, size_t frames) override;
+    bool rewind() override;
+
+private:
+    static const uint32_t BEEP_FRAMES = SAMPLE_RATE / 10;  // 100 ms on, 100 ms off
+    static const uint8_t BEEPS = 4;
+    static const uint32_t PAUSE_FRAMES = SAMPLE_RATE * 6 / 10;
+    static const uint32_t TOTAL_FRAMES = BEEP_FRAMES * 2 * BEEPS + PAUSE_FRAMES;
+
+    uint32_t _phaseStep;  // Phase accumulator step, 2^32 = one period
+    uint32_t _phase;
+    uint32_t _position;   // Frames into the pattern
+};
+
+#endif // AUDIO_SOURCE_H
@@ -0,0 +1,194 @@
+#include "BrightnessManager.h"
+
+BrightnessManager::BrightnessManager()
+    : _display(nullptr),
+      _settings(nullptr),
+      _touch(nullptr),
+      _sensor(SENSOR_ADDRESS),
+      _sensorOk(false),
+      _readErrors(0),
+      _nextSampleMs(0),
+      _nextRetryMs(0),
+      _active(false),
+      _haveFilter(false),
+      _lastLux(0),
+      _filteredLux(0),
+      _anchorLux(-1),
+      _target(0),
+      _level(0),
+      _fadeStep(0),
+      _output(0) {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool BrightnessManager::begin(DisplayManager* display, SettingsManager* settings, TouchManager* touch) {
+    if (!display || !settings) {
+        Serial.println("ERROR: BrightnessManager needs a DisplayManager and a SettingsManager");
+        return false;
+    }
+
+    _display = display;
+    _settings = settings;
+    _touch = touch;  // Optional: bus lock and touch state
+
+    // Wire is set up by TouchManager::begin()
+    if (!initSensor()) {
+        Serial.println("WARNING: BH1750 not found, backlight stays manual until it answers");
+        return false;
+    }
+    Serial.println("BH1750 light sensor ready");
+    return true;
+}
+
+bool BrightnessManager::initSensor() {
+    if (_touch && !_touch->lockBus(pdMS_TO_TICKS(50))) return false;
+    _sensorOk = _sensor.begin(BH1750::CONTINUOUS_HIGH_RES_MODE, SENSOR_ADDRESS, &Wire);
+    if (_touch) _touch->unlockBus();
+
+    _readErrors = 0;
+    _nextRetryMs = millis() + RETRY_MS;
+    return _sensorOk;
+}
+
+void BrightnessManager::invalidate() {
+    _anchorLux = -1;
+}
+
+uint32_t BrightnessManager::update() {
+    if (!_display || !_settings) return IDLE_PERIOD_MS;
+
+    if (!_settings->get().autoBrightness) {
+        _active = false;
+        return IDLE_PERIOD_MS;
+    }
+
+    uint32_t now = millis();
+    if (!_active) {
+        // Taking over from manual: fade from wherever the user left it
+        _active = true;
+        _output = _display->getBrightness();
+        _target = _output;
+        _level = (uint16_t)_output << 8;
+        _haveFilter = false;
+        _anchorLux = -1;
+        _nextSampleMs = now;
+    }
+
+    if (!_sensorOk && (int32_t)(now - _nextRetryMs) >= 0 && initSensor()) {
+        Serial.println("BH1750 light sensor ready");
+        _nextSampleMs = now;
+    }
+
+    if (_sensorOk && (int32_t)(now - _nextSampleMs) >= 0) {
+        sample();
+        _nextSampleMs = now + SAMPLE_PERIOD_MS;
+    }
+
+    if (fade()) return FADE_STEP_MS;
+    if (!_sensorOk) return min((uint32_t)RETRY_MS, _nextRetryMs - now);
+    return min((uint32_t)SAMPLE_PERIOD_MS, _nextSampleMs - now);
+}
+
+void BrightnessManager::sample() {
+    if (_touch && _touch->isTouched()) {
+        _stats.skippedTouch++;
+        return;
+    }
+    if (_touch && !_touch->lockBus(0)) {
+        _stats.skippedBusy++;
+        return;
+    }
+    // Continuous mode: a new conversion every 120 ms, read in one short transaction
+    float lux = _sensor.measurementReady() ? _sensor.readLightLevel() : -1;
+    if (_touch) _touch->unlockBus();
+
+    if (lux < 0) {
+        _stats.readErrors++;
+        if (++_readErrors >= MAX_READ_ERRORS) {
+            Serial.println("WARNING: BH1750 stopped answering, holding the backlight level");
+            _sensorOk = false;
+            _nextRetryMs = millis() + RETRY_MS;
+        }
+        return;
+    }
+    _readErrors = 0;
+    _stats.samples++;
+    _lastLux = lux;
+
+    if (!_haveFilter) {
+        _filteredLux = lux;  // First sample seeds the average
+        _haveFilter = true;
+    } else {
+        _filteredLux += FILTER_ALPHA * (lux - _filteredLux);
+    }
+
+    // Re-target only once the light has really changed
+    float band = max(MIN_HYSTERESIS_LUX, _anchorLux * HYSTERESIS_RATIO);
+    if (_anchorLux < 0 || fabsf(_filteredLux - _anchorLux) > band) {
+        _anchorLux = _filteredLux;
+        const SettingsData& config = _settings->get();
+        setTarget(levelForLux(_filteredLux, config.brightnessCurve, BRIGHTNESS_CURVE_POINTS));
+        _stats.retargets++;
+    }
+}
+
+void BrightnessManager::setTarget(uint8_t level) {
+    if (level == _target) return;
+    _target = level;
+
+    // Big and small changes alike take about FADE_MS
+    uint16_t distance = abs((int32_t)((uint16_t)level << 8) - (int32_t)_level);
+    _fadeStep = max((uint32_t)1, (uint32_t)distance * FADE_STEP_MS / FADE_MS);
+}
+
+bool BrightnessManager::fade() {
+    uint16_t goal = (uint16_t)_target << 8;
+    if (_level == goal) return false;
+
+    if (_level < goal) {
+        _level = (uint16_t)min((uint32_t)_level + _fadeStep, (uint32_t)goal);  // Goal 65280 + a step overflows 16 bits
+    } else {
+        _level = _level > goal + _fadeStep ? _level - _fadeStep : goal;
+    }
+
+    uint8_t output = (uint8_t)min(((uint32_t)_level + 128) >> 8, (uint32_t)255);
+    if (output == _output) {
+        _stats.skippedWrites++;
+    } else {
+        _display->setBrightness(output);
+        _output = output;
+        _stats.writes++;
+    }
+    return _level != goal;
+}
+
+uint8_t BrightnessManager::levelForLux(float lux, const BrightnessPoint* curve, uint8_t count) {
+    if (count == 0) return 255;
+    if (lux <= curve[0].lux) return curve[0].level;
+
+    for (uint8_t i = 1; i < count; i++) {
+        if (lux < curve[i].lux) {
+            const BrightnessPoint& a = curve[i - 1];
+            const BrightnessPoint& b = curve[i];
+            float t = (lux - a.lux) / (float)(b.lux - a.lux);
+            return (uint8_t)(a.level + t * ((int16_t)b.level - (int16_t)a.level) + 0.5f);
+        }
+    }
+    return curve[count - 1].level;
+}
+
+void BrightnessManager::dump() {
+    if (!_settings) return;
+
+    Serial.printf("Backlight: %s, sensor %s, level %u -> %u\n",
+                  _settings->get().autoBrightness ? "auto" : "manual", _sensorOk ? "ok" : "missing",
+                  (unsigned)_output, (unsigned)_target);
+    if (_haveFilter) {
+        Serial.printf("  lux %.1f raw, %.1f filtered, target picked at %.1f\n", _lastLux, _filteredLux, _anchorLux);
+    }
+    Serial.printf("  %lu samples, %lu skipped (touch), %lu skipped (bus), %lu errors\n",
+                  (unsigned long)_stats.samples, (unsigned long)_stats.skippedTouch,
+                  (unsigned long)_stats.skippedBusy, (unsigned long)_stats.readErrors);
+    Serial.printf("  %lu retargets, %lu PWM writes, %lu unchanged fade steps\n", (unsigned long)_stats.retargets,
+                  (unsigned long)_stats.writes, (unsigned long)_stats.skippedWrites);
+}
@@ -0,0 +1,96 @@
+#ifndef BRIGHTNESS_MANAGER_H
+#define BRIGHTNESS_MANAGER_H
+
+#include <Arduino.h>
+#include <BH1750.h>
+#include "DisplayManager.h"
+#include "TouchManager.h"
+#include "SettingsManager.h"
+
+// Counters for diagnostics
+struct BrightnessStats {
+    uint32_t samples;           // Good sensor reads
+    uint32_t skippedTouch;      // Samples skipped under a finger (shadow, busy bus)
+    uint32_t skippedBusy;       // Samples skipped because the touch reader held the bus
+    uint32_t readErrors;
+    uint32_t retargets;         // Lux left the hysteresis band, new target level
+    uint32_t writes;            // setBrightness() calls
+    uint32_t skippedWrites;     // Fade steps that left the PWM level unchanged
+};
+
+// Automatic backlight from the BH1750 ambient light sensor (Phase 7).
+// Raw lux readings are smoothed with an exponential moving average; a new
+// backlight target is only picked once the smoothed value leaves a band
+// around the lux of the last target, so a level near a curve point doesn't
+// flicker. Targets come from SettingsData::brightnessCurve (piecewise
+// linear) and are reached with a fade, not a step. The PWM is only
+// written when the 0-255 level actually changes.
+//
+// The sensor sits on the GT911's I2C bus. Reads try the TouchManager bus
+// lock without waiting and are skipped while a finger is down - the hand
+// shadows the sensor anyway - so a touch read waits for at most one short
+// sensor transaction.
+//
+// Runs on the UI task. update() returns how long it can sleep: a fade
+// step while fading, else the next sample.
+class BrightnessManager {
+public:
+    static const uint32_t SAMPLE_PERIOD_MS = 500;
+    static const uint32_t FADE_STEP_MS = 20;        // 50 Hz fade steps
+    static const uint32_t FADE_MS = 1500;           // Any fade takes about this long
+    static const uint32_t IDLE_PERIOD_MS = 1000;    // Manual mode: watch for auto coming back
+    static const uint32_t RETRY_MS = 30000;         // Sensor missing or lost
+    static const uint8_t MAX_READ_ERRORS = 5;       // In a row before the sensor counts as lost
+
+    BrightnessManager();
+
+    // Manager pattern
+    bool begin(DisplayManager* display, SettingsManager* settings, TouchManager* touch);
+    uint32_t update();  // Returns ms until it wants to run again
+
+    void invalidate();  // Curve edited: pick a target on the next sample
+
+    bool isSensorPresent() const { return _sensorOk; }
+    float getLux() const { return _filteredLux; }
+    uint8_t getTargetLevel() const { return _target; }
+    const BrightnessStats& getStats() const { return _stats; }
+    void dump();  // Print state and counters to Serial
+
+    // Piecewise-linear lookup; points below/above the curve clamp to its ends
+    static uint8_t levelForLux(float lux, const BrightnessPoint* curve, uint8_t count);
+
+private:
+    static const uint8_t SENSOR_ADDRESS = 0x23;     // ADDR pin low
+    static constexpr float FILTER_ALPHA = 0.25f;    // EMA weight of a new sample (~2 s time constant)
+    static constexpr float HYSTERESIS_RATIO = 0.15f;  // Band: +/-15% of the target's lux...
+    static constexpr float MIN_HYSTERESIS_LUX = 3.0f; // ...but never narrower than this
+
+    DisplayManager* _display;
+    SettingsManager* _settings;
+    TouchManager* _touch;
+    BH1750 _sensor;
+    bool _sensorOk;
+    uint8_t _readErrors;        // In a row
+    uint32_t _nextSampleMs;
+    uint32_t _nextRetryMs;
+    bool _active;               // Auto brightness in control
+
+    bool _haveFilter;
+    float _lastLux;
+    float _filteredLux;
+    float _anchorLux;           // Lux the current target was picked at, < 0 = none
+
+    uint8_t _target;
+    uint16_t _level;            // Fade position, 8.8 fixed point
+    uint16_t _fadeStep;         // Per FADE_STEP_MS, 8.8 fixed point
+    uint8_t _output;            // Last level written to the display
+
+    BrightnessStats _stats;
+
+    bool initSensor();
+    void sample();
+    void setTarget(uint8_t level);
+    bool fade();  // One step; false once at the target
+};
+
+#endif // BRIGHTNESS_MANAGER_H
@@ -1,18 +1,151 @@
 #include "DisplayManager.h"
 #include <Arduino.h>
+#include <esp_timer.h>
+
+// CrowPanel LCD VSYNC output (see LGFX_CrowPanel.h), sampled for present()
+#define LCD_VSYNC     41
+
+#ifdef DISPLAY_PROFILER
+#ifdef SIMULATOR
+#include <chrono>
+#endif
+
+// Wall-clock microseconds for draw timing (the simulator's clock is
+// virtual and doesn't advance while drawing)
+static uint32_t profilerMicros() {
+#ifdef SIMULATOR
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    return (uint32_t)esp_timer_get_time();
+#endif
+}
+
+// Times one draw call; nested calls count once
+class DisplayManager::ProfileScope {
+public:
+    explicit ProfileScope(DisplayManager* dm) : _dm(dm), _start(0) {
+        if (_dm->_profSuspended || _dm->_profDepth++ > 0) return;
+        _start = profilerMicros();
+    }
+    ~ProfileScope() {
+        if (_dm->_profSuspended || --_dm->_profDepth > 0) return;
+        _dm->_profUs += profilerMicros() - _start;
+        _dm->_profPrimitives++;
+    }
+
+private:
+    DisplayManager* _dm;
+    uint32_t _start;
+};
+
+#define PROFILE_PRIMITIVE() ProfileScope _profileScope(this)
+#else
+#define PROFILE_PRIMITIVE()
+#endif
+
+// Rectangle helpers for dirty-region coalescing
+static bool rectsTouch(const DirtyRect& a, const DirtyRect& b) {
+    // Overlapping or edge-adjacent rectangles are merged
+    return a.x <= b.x + b.w && b.x <= a.x + a.w &&
+           a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+static DirtyRect rectUnion(const DirtyRect& a, const DirtyRect& b) {
+    int32_t x0 = min(a.x, b.x);
+    int32_t y0 = min(a.y, b.y);
+    int32_t x1 = max(a.x + a.w, b.x + b.w);
+    int32_t y1 = max(a.y + a.h, b.y + b.h);
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+static uint32_t rectArea(const DirtyRect& r) {
+    return (uint32_t)r.w * (uint32_t)r.h;
+}
+
+// Add a rect to a coalesced list of at most maxCount rects
+static void insertRect(DirtyRect* list, uint8_t& count, uint8_t maxCount, DirtyRect rect) {
+    // Merge with every rect it touches; a merge can grow the rect into
+    // others, so rescan until nothing else overlaps
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (uint8_t i = 0; i < count; i++) {
+            if (rectsTouch(rect, list[i])) {
+                rect = rectUnion(rect, list[i]);
+                list[i] = list[--count];
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    if (count < maxCount) {
+        list[count++] = rect;
+        return;
+    }
+
+    // List full - fold into the rect whose area grows the least
+    uint8_t best = 0;
+    uint32_t bestGrowth = UINT32_MAX;
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t growth = rectArea(rectUnion(rect, list[i])) - rectArea(list[i]);
+        if (growth < bestGrowth) {
+            bestGrowth = growth;
+            best = i;
+        }
+    }
+    DirtyRect grown = rectUnion(rect, list[best]);
+    list[best] = list[--count];
+    insertRect(list, count, maxCount, grown);
+}
 
 DisplayManager::DisplayManager()
-    : _brightness(255), _initialized(false) {
+    : _gfx(nullptr), _brightness(255), _initialized(false),
+      _dirtyCount(0), _clip({0, 0, 0, 0}),
+      _mode(RENDER_DIRECT), _backBuffer(nullptr), _damageCount(0),
+      _vsyncSem(nullptr), _vsyncCount(0),
+      _labelClock(0),
+      _frameBytes(0), _lastFrameBytes(0) {
     _display = nullptr;
+    memset(_labels, 0, sizeof(_labels));
+    memset(_digitSets, 0, sizeof(_digitSets));
+    memset(&_labelStats, 0, sizeof(_labelStats));
+    memset(&_presentStats, 0, sizeof(_presentStats));
+#ifdef DISPLAY_PROFILER
+    memset(&_profile, 0, sizeof(_profile));
+    memset(_profWindowUs, 0, sizeof(_profWindowUs));
+    _profWindowPos = 0;
+    _profWindowCount = 0;
+    _profPrimitives = 0;
+    _profPixels = 0;
+    _profUs = 0;
+    _profDepth = 0;
+    _profSuspended = false;
+    _profOverlay = false;
+#endif
 }
 
 DisplayManager::~DisplayManager() {
+    clearLabelCache();
+    for (uint8_t i = 0; i < MAX_DIGIT_SETS; i++) {
+        freeDigitSet(_digitSets[i]);
+    }
+    if (_vsyncSem) {
+        detachInterrupt(digitalPinToInterrupt(LCD_VSYNC));
+        vSemaphoreDelete(_vsyncSem);
+        _vsyncSem = nullptr;
+    }
+    if (_backBuffer) {
+        delete _backBuffer;
+        _backBuffer = nullptr;
+    }
     if (_display) {
         delete _display;
     }
 }
 
-bool DisplayManager::begin() {
+bool DisplayManager::begin(RenderMode mode) {
     Serial.println("DisplayManager::begin() - Starting initialization");
 
     if (_initialized) {
@@ -51,14 +184,103 @@ bool DisplayManager::begin() {
     Serial.println("Setting brightness...");
     _display->setBrightness(_brightness);
 
+    _gfx = _display;
+    if (mode == RENDER_DOUBLE_BUFFERED && !startDoubleBuffering()) {
+        Serial.println("WARNING: Double buffering unavailable, drawing directly");
+    }
+
     Serial.println("DisplayManager initialized successfully!");
     Serial.printf("Display size: %d x %d\n", _display->width(), _display->height());
+    Serial.printf("Render mode: %s\n", _mode == RENDER_DOUBLE_BUFFERED ? "double-buffered" : "direct");
     Serial.printf("PSRAM free after init: %d bytes\n", ESP.getFreePsram());
 
     _initialized = true;
     return true;
 }
 
+bool DisplayManager::startDoubleBuffering() {
+    _backBuffer = new LGFX_Sprite(_display);
+    if (!_backBuffer) {
+        Serial.println("ERROR: Failed to allocate back buffer sprite");
+        return false;
+    }
+
+    _backBuffer->setColorDepth(16);
+    _backBuffer->setPsram(true);
+    if (!_backBuffer->createSprite(_display->width(), _display->height())) {
+        Serial.println("ERROR: Not enough PSRAM for the back buffer");
+        delete _backBuffer;
+        _backBuffer = nullptr;
+        return false;
+    }
+    _backBuffer->fillScreen(TFT_BLACK);
+
+    // VSYNC is an LCD peripheral output; attaching an interrupt enables the
+    // pin's input path without changing its function
+    _vsyncSem = xSemaphoreCreateBinary();
+    if (_vsyncSem) {
+        attachInterruptArg(digitalPinToInterrupt(LCD_VSYNC), vsyncISR, this, FALLING);
+    } else {
+        Serial.println("WARNING: No VSYNC semaphore, presenting unsynchronized");
+    }
+
+    _gfx = _backBuffer;
+    _mode = RENDER_DOUBLE_BUFFERED;
+    return true;
+}
+
+void IRAM_ATTR DisplayManager::vsyncISR(void* arg) {
+    DisplayManager* self = static_cast<DisplayManager*>(arg);
+    self->_vsyncCount++;
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(self->_vsyncSem, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void DisplayManager::present() {
+    if (!_backBuffer || _damageCount == 0) return;
+
+    DirtyRect rects[MAX_DIRTY_RECTS];
+    uint8_t count = _damageCount;
+    memcpy(rects, _damageRects, sizeof(DirtyRect) * count);
+    _damageCount = 0;
+
+    // Start copying at the top of a refresh; the copy runs ahead of the
+    // scanout, so the panel shows either the old frame or the new one
+    bool synced = false;
+    if (_vsyncSem) {
+        xSemaphoreTake(_vsyncSem, 0);  // Drop a VSYNC that has already passed
+        synced = xSemaphoreTake(_vsyncSem, pdMS_TO_TICKS(VSYNC_TIMEOUT_MS)) == pdTRUE;
+        if (!synced) {
+            _presentStats.vsyncTimeouts++;
+        }
+    }
+    uint32_t vsyncAtStart = _vsyncCount;
+    int64_t start = esp_timer_get_time();
+
+    uint32_t pixels = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const DirtyRect& r = rects[i];
+        _display->setClipRect(r.x, r.y, r.w, r.h);
+        _backBuffer->pushSprite(_display, 0, 0);
+        pixels += rectArea(r);
+    }
+    _display->clearClipRect();
+    _display->display();
+
+    uint32_t copyUs = (uint32_t)(esp_timer_get_time() - start);
+    if (synced && _vsyncCount != vsyncAtStart) {
+        _presentStats.missedVsyncs++;
+    }
+    _presentStats.presents++;
+    _presentStats.lastCopyUs = copyUs;
+    _presentStats.lastCopyPixels = pixels;
+    if (copyUs > _presentStats.maxCopyUs) {
+        _presentStats.maxCopyUs = copyUs;
+    }
+}
+
 void DisplayManager::setBrightness(uint8_t brightness) {
     _brightness = brightness;
     if (_display) {
@@ -79,126 +301,684 @@ void DisplayManager::backlightOff() {
 }
 
 void DisplayManager::clear(uint32_t color) {
-    if (_display) _display->fillScreen(color);
+    PROFILE_PRIMITIVE();
+    if (!_gfx) return;
+    _gfx->fillScreen(color);
+    accountArea(0, 0, _gfx->width(), _gfx->height());
 }
 
 void DisplayManager::fillScreen(uint32_t color) {
-    if (_display) _display->fillScreen(color);
+    PROFILE_PRIMITIVE();
+    if (!_gfx) return;
+    _gfx->fillScreen(color);
+    accountArea(0, 0, _gfx->width(), _gfx->height());
 }
 
 void DisplayManager::drawPixel(int32_t x, int32_t y, uint32_t color) {
-    _display->drawPixel(x, y, color);
+    PROFILE_PRIMITIVE();
+    _gfx->drawPixel(x, y, color);
+    accountArea(x, y, 1, 1);
 }
 
 void DisplayManager::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
-    _display->drawLine(x0, y0, x1, y1, color);
+    PROFILE_PRIMITIVE();
+    _gfx->drawLine(x0, y0, x1, y1, color);
+    accountPixels(max(abs(x1 - x0), abs(y1 - y0)) + 1);
+    damage(min(x0, x1), min(y0, y1), abs(x1 - x0) + 1, abs(y1 - y0) + 1);
 }
 
 void DisplayManager::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
-    _display->drawRect(x, y, w, h, color);
+    PROFILE_PRIMITIVE();
+    _gfx->drawRect(x, y, w, h, color);
+    accountPixels(2 * (w + h));
+    damage(x, y, w, h);
 }
 
 void DisplayManager::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
-    _display->fillRect(x, y, w, h, color);
+    PROFILE_PRIMITIVE();
+    _gfx->fillRect(x, y, w, h, color);
+    accountArea(x, y, w, h);
 }
 
 void DisplayManager::drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
-    _display->drawCircle(x, y, r, color);
+    PROFILE_PRIMITIVE();
+    _gfx->drawCircle(x, y, r, color);
+    accountPixels((44 * r) / 7);  // ~2*pi*r
+    damage(x - r, y - r, 2 * r + 1, 2 * r + 1);
 }
 
 void DisplayManager::fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
-    _display->fillCircle(x, y, r, color);
+    PROFILE_PRIMITIVE();
+    _gfx->fillCircle(x, y, r, color);
+    accountPixels((22 * r * r) / 7);  // ~pi*r^2
+    damage(x - r, y - r, 2 * r + 1, 2 * r + 1);
 }
 
 void DisplayManager::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t radius, uint32_t color) {
-    _display->drawRoundRect(x, y, w, h, radius, color);
+    PROFILE_PRIMITIVE();
+    _gfx->drawRoundRect(x, y, w, h, radius, color);
+    accountPixels(2 * (w + h));
+    damage(x, y, w, h);
 }
 
 void DisplayManager::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t radius, uint32_t color) {
-    _display->fillRoundRect(x, y, w, h, radius, color);
+    PROFILE_PRIMITIVE();
+    _gfx->fillRoundRect(x, y, w, h, radius, color);
+    accountArea(x, y, w, h);
 }
 
 void DisplayManager::setTextColor(uint32_t color) {
-    _display->setTextColor(color);
+    _gfx->setTextColor(color);
 }
 
 void DisplayManager::setTextColor(uint32_t fgColor, uint32_t bgColor) {
-    _display->setTextColor(fgColor, bgColor);
+    _gfx->setTextColor(fgColor, bgColor);
 }
 
 void DisplayManager::setTextSize(float size) {
-    _display->setTextSize(size);
+    _gfx->setTextSize(size);
 }
 
 void DisplayManager::setCursor(int32_t x, int32_t y) {
-    _display->setCursor(x, y);
+    _gfx->setCursor(x, y);
 }
 
 void DisplayManager::setTextDatum(uint8_t datum) {
-    _display->setTextDatum(datum);
+    _gfx->setTextDatum(datum);
 }
 
 void DisplayManager::print(const char* text) {
-    _display->print(text);
+    PROFILE_PRIMITIVE();
+    int32_t x = _gfx->getCursorX();
+    int32_t y = _gfx->getCursorY();
+    _gfx->print(text);
+    accountText(text, x, y, TL_DATUM);
 }
 
 void DisplayManager::print(int value) {
-    _display->print(value);
+    char text[12];
+    snprintf(text, sizeof(text), "%d", value);
+    print(text);
 }
 
 void DisplayManager::println(const char* text) {
-    _display->println(text);
+    PROFILE_PRIMITIVE();
+    int32_t x = _gfx->getCursorX();
+    int32_t y = _gfx->getCursorY();
+    _gfx->println(text);
+    accountText(text, x, y, TL_DATUM);
 }
 
 void DisplayManager::println(int value) {
-    _display->println(value);
+    char text[12];
+    snprintf(text, sizeof(text), "%d", value);
+    println(text);
 }
 
 void DisplayManager::drawString(const char* text, int32_t x, int32_t y) {
-    _display->drawString(text, x, y);
+    PROFILE_PRIMITIVE();
+    _gfx->drawString(text, x, y);
+    accountText(text, x, y, _gfx->getTextDatum());
 }
 
 void DisplayManager::drawCentreString(const char* text, int32_t x, int32_t y) {
-    _display->drawCentreString(text, x, y);
+    PROFILE_PRIMITIVE();
+    _gfx->drawCentreString(text, x, y);
+    accountText(text, x, y, TC_DATUM);
 }
 
 void DisplayManager::drawRightString(const char* text, int32_t x, int32_t y) {
-    _display->drawRightString(text, x, y);
+    PROFILE_PRIMITIVE();
+    _gfx->drawRightString(text, x, y);
+    accountText(text, x, y, TR_DATUM);
 }
 
 void DisplayManager::setFont(const lgfx::IFont* font) {
-    _display->setFont(font);
+    _gfx->setFont(font);
 }
 
 void DisplayManager::setTextFont(uint8_t font) {
+    _gfx->setFont(fontForNumber(font));
+}
+
+const lgfx::IFont* DisplayManager::fontForNumber(uint8_t font) {
     // LovyanGFX uses different font system
     // Map common font sizes to LovyanGFX fonts
     switch(font) {
-        case 1: _display->setFont(&fonts::Font0); break;
-        case 2: _display->setFont(&fonts::Font2); break;
-        case 4: _display->setFont(&fonts::Font4); break;
-        case 6: _display->setFont(&fonts::Font6); break;
-        case 7: _display->setFont(&fonts::Font7); break;
-        case 8: _display->setFont(&fonts::Font8); break;
-        default: _display->setFont(&fonts::Font4); break;
+        case 1: return &fonts::Font0;
+        case 2: return &fonts::Font2;
+        case 4: return &fonts::Font4;
+        case 6: return &fonts::Font6;
+        case 7: return &fonts::Font7;
+        case 8: return &fonts::Font8;
+        default: return &fonts::Font4;
     }
 }
 
 int16_t DisplayManager::textWidth(const char* text) {
-    return _display->textWidth(text);
+    return _gfx->textWidth(text);
 }
 
 int16_t DisplayManager::fontHeight() {
-    return _display->fontHeight();
+    return _gfx->fontHeight();
 }
 
 void DisplayManager::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data) {
-    _display->pushImage(x, y, w, h, data);
+    PROFILE_PRIMITIVE();
+    _gfx->pushImage(x, y, w, h, data);
+    accountArea(x, y, w, h);
 }
 
 void DisplayManager::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
-    _display->pushImage(x, y, w, h, data);
+    PROFILE_PRIMITIVE();
+    _gfx->pushImage(x, y, w, h, data);
+    accountArea(x, y, w, h);
+}
+
+void DisplayManager::pushImageRGB565(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* pixels) {
+    PROFILE_PRIMITIVE();
+    // Typed pointer so LovyanGFX doesn't apply its byte-swapped uint16_t default
+    _gfx->pushImage(x, y, w, h, reinterpret_cast<const lgfx::rgb565_t*>(pixels));
+    accountArea(x, y, w, h);
+}
+
+// Move a datum-anchored position to the top-left corner of a w x h box
+// (horizontal in the low bits, vertical in bits 2-3, as in textdatum_t)
+static void applyDatum(uint8_t datum, int32_t w, int32_t h, int32_t& x, int32_t& y) {
+    if ((datum & 3) == 1) x -= w / 2;
+    else if ((datum & 3) == 2) x -= w;
+    if ((datum & 12) == 4) y -= h / 2;
+    else if ((datum & 12) == 8) y -= h;
+}
+
+// Label cache
+static uint32_t labelHash(const char* text) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char* p = text; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 16777619u;
+    }
+    return hash;
+}
+
+void DisplayManager::drawCachedString(const char* text, int32_t x, int32_t y, uint8_t font,
+                                      uint32_t fgColor, uint32_t bgColor, uint8_t datum) {
+    if (!text || !*text) return;
+
+    LabelEntry* entry = nullptr;
+    if (strlen(text) < sizeof(_labels[0].text)) {
+        uint32_t hash = labelHash(text);
+        entry = findLabel(text, hash, font, fgColor, bgColor);
+        if (entry) {
+            _labelStats.hits++;
+        } else {
+            _labelStats.misses++;
+            entry = renderLabel(text, hash, font, fgColor, bgColor);
+        }
+    }
+
+    if (!entry) {
+        // Too long to cache, or no sprite memory - draw directly
+        setTextFont(font);
+        setTextColor(fgColor, bgColor);
+        setTextDatum(datum);
+        drawString(text, x, y);
+        return;
+    }
+
+    entry->lastUsed = ++_labelClock;
+
+    int32_t w = entry->sprite->width();
+    int32_t h = entry->sprite->height();
+    applyDatum(datum, w, h, x, y);
+
+    PROFILE_PRIMITIVE();
+    entry->sprite->pushSprite(_gfx, x, y);
+    accountArea(x, y, w, h);
+}
+
+DisplayManager::LabelEntry* DisplayManager::findLabel(const char* text, uint32_t hash, uint8_t font,
+                                                      uint32_t fgColor, uint32_t bgColor) {
+    for (uint8_t i = 0; i < MAX_LABELS; i++) {
+        LabelEntry& entry = _labels[i];
+        if (entry.sprite && entry.hash == hash && entry.font == font &&
+            entry.fgColor == fgColor && entry.bgColor == bgColor &&
+            strcmp(entry.text, text) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+DisplayManager::LabelEntry* DisplayManager::renderLabel(const char* text, uint32_t hash, uint8_t font,
+                                                        uint32_t fgColor, uint32_t bgColor) {
+    // Take a free slot, or evict the least recently used label
+    LabelEntry* slot = nullptr;
+    for (uint8_t i = 0; i < MAX_LABELS; i++) {
+        if (!_labels[i].sprite) {
+            slot = &_labels[i];
+            break;
+        }
+        if (!slot || _labels[i].lastUsed < slot->lastUsed) {
+            slot = &_labels[i];
+        }
+    }
+
+    if (slot->sprite) {
+        _labelStats.bytes -= slot->sprite->width() * slot->sprite->height() * 2;
+        _labelStats.evictions++;
+    } else {
+        slot->sprite = new LGFX_Sprite(_display);
+        if (!slot->sprite) {
+            Serial.println("ERROR: Failed to allocate label sprite");
+            return nullptr;
+        }
+        _labelStats.entries++;
+    }
+
+    LGFX_Sprite* sprite = slot->sprite;
+    sprite->setColorDepth(16);
+    sprite->setPsram(true);
+    sprite->setFont(fontForNumber(font));
+
+    int32_t w = sprite->textWidth(text);
+    int32_t h = sprite->fontHeight();
+    if (!sprite->createSprite(w, h)) {
+        Serial.println("ERROR: Failed to allocate label sprite buffer");
+        delete sprite;
+        slot->sprite = nullptr;
+        _labelStats.entries--;
+        return nullptr;
+    }
+
+    sprite->fillScreen(bgColor);
+    sprite->setTextColor(fgColor, bgColor);
+    sprite->setTextDatum(TL_DATUM);
+    sprite->drawString(text, 0, 0);
+
+    slot->hash = hash;
+    slot->font = font;
+    slot->fgColor = fgColor;
+    slot->bgColor = bgColor;
+    strcpy(slot->text, text);
+    _labelStats.bytes += w * h * 2;
+
+    return slot;
+}
+
+void DisplayManager::clearLabelCache() {
+    for (uint8_t i = 0; i < MAX_LABELS; i++) {
+        if (_labels[i].sprite) {
+            delete _labels[i].sprite;
+            _labels[i].sprite = nullptr;
+        }
+    }
+    _labelStats.entries = 0;
+    _labelStats.bytes = 0;
+}
+
+// Digit sets
+const char* const DisplayManager::DIGIT_GLYPHS = "0123456789:- ";
+
+int8_t DisplayManager::digitGlyphIndex(char c) {
+    if (!c) return -1;
+    const char* p = strchr(DIGIT_GLYPHS, c);
+    return p ? (int8_t)(p - DIGIT_GLYPHS) : -1;
+}
+
+int8_t DisplayManager::createDigitSet(uint8_t font, uint8_t scale, uint32_t fgColor, uint32_t bgColor) {
+    if (!_display || scale == 0) return -1;
+
+    // Share an identical set, or take a free slot
+    int8_t slot = -1;
+    for (uint8_t i = 0; i < MAX_DIGIT_SETS; i++) {
+        DigitSet& set = _digitSets[i];
+        if (set.refs && set.font == font && set.scale == scale &&
+            set.fgColor == fgColor && set.bgColor == bgColor) {
+            set.refs++;
+            return i;
+        }
+        if (!set.refs && slot < 0) slot = i;
+    }
+    if (slot < 0) {
+        Serial.println("ERROR: Digit set limit reached");
+        return -1;
+    }
+
+    DigitSet& set = _digitSets[slot];
+    set.font = font;
+    set.scale = scale;
+    set.fgColor = fgColor;
+    set.bgColor = bgColor;
+
+    // The cell is as wide as the widest digit, so proportional fonts line up too
+    LGFX_Sprite measure(_display);
+    measure.setFont(fontForNumber(font));
+    measure.setTextSize(scale);
+    char glyph[2] = {0, 0};
+    set.digitWidth = 0;
+    for (glyph[0] = '0'; glyph[0] <= '9'; glyph[0]++) {
+        set.digitWidth = max(set.digitWidth, (int32_t)measure.textWidth(glyph));
+    }
+    set.height = measure.fontHeight();
+
+    uint32_t bytes = 0;
+    for (uint8_t i = 0; i < DIGIT_GLYPH_COUNT; i++) {
+        glyph[0] = DIGIT_GLYPHS[i];
+        if (glyph[0] == ' ') continue;  // Drawn as a fill
+
+        int32_t w = glyph[0] == ':' ? measure.textWidth(glyph) : set.digitWidth;
+        LGFX_Sprite* sprite = new LGFX_Sprite(_display);
+        sprite->setColorDepth(16);
+        sprite->setPsram(true);
+        if (!sprite->createSprite(w, set.height)) {
+            Serial.println("ERROR: Failed to allocate digit sprite buffer");
+            delete sprite;
+            freeDigitSet(set);
+            return -1;
+        }
+        set.glyphs[i] = sprite;
+        bytes += w * set.height * 2;
+
+        sprite->setFont(fontForNumber(font));
+        sprite->setTextSize(scale);
+        sprite->fillScreen(bgColor);
+        sprite->setTextColor(fgColor, bgColor);
+        sprite->setTextDatum(TC_DATUM);
+        sprite->drawString(glyph, w / 2, 0);
+    }
+
+    set.refs = 1;
+    Serial.printf("Digit set %d: font %u x%u, %ldx%ld cells, %lu KB\n", slot, font, scale,
+                  (long)set.digitWidth, (long)set.height, (unsigned long)(bytes / 1024));
+    return slot;
+}
+
+void DisplayManager::releaseDigitSet(int8_t set) {
+    if (set < 0 || set >= MAX_DIGIT_SETS || !_digitSets[set].refs) return;
+    if (--_digitSets[set].refs == 0) {
+        freeDigitSet(_digitSets[set]);
+    }
+}
+
+void DisplayManager::freeDigitSet(DigitSet& set) {
+    for (uint8_t i = 0; i < DIGIT_GLYPH_COUNT; i++) {
+        if (set.glyphs[i]) {
+            delete set.glyphs[i];
+        }
+    }
+    memset(&set, 0, sizeof(set));
+}
+
+int32_t DisplayManager::getDigitWidth(int8_t set, char c) const {
+    if (set < 0 || set >= MAX_DIGIT_SETS || !_digitSets[set].refs) return 0;
+    int8_t index = digitGlyphIndex(c);
+    if (index < 0) return 0;
+    const DigitSet& digits = _digitSets[set];
+    return digits.glyphs[index] ? digits.glyphs[index]->width() : digits.digitWidth;
+}
+
+int32_t DisplayManager::getDigitHeight(int8_t set) const {
+    if (set < 0 || set >= MAX_DIGIT_SETS || !_digitSets[set].refs) return 0;
+    return _digitSets[set].height;
+}
+
+bool DisplayManager::drawDigit(int8_t set, char c, int32_t x, int32_t y) {
+    if (set < 0 || set >= MAX_DIGIT_SETS || !_digitSets[set].refs) return false;
+    int8_t index = digitGlyphIndex(c);
+    if (index < 0) return false;
+
+    DigitSet& digits = _digitSets[set];
+    LGFX_Sprite* sprite = digits.glyphs[index];
+    if (!sprite) {
+        fillRect(x, y, digits.digitWidth, digits.height, digits.bgColor);
+        return true;
+    }
+
+    PROFILE_PRIMITIVE();
+    sprite->pushSprite(_gfx, x, y);
+    accountArea(x, y, sprite->width(), sprite->height());
+    return true;
+}
+
+// Dirty-rectangle tracking
+void DisplayManager::invalidate(int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (!_display) return;
+
+    // Clip to screen
+    int32_t x1 = min(x + w, (int32_t)_display->width());
+    int32_t y1 = min(y + h, (int32_t)_display->height());
+    x = max(x, (int32_t)0);
+    y = max(y, (int32_t)0);
+    if (x1 <= x || y1 <= y) return;
+
+    insertRect(_dirtyRects, _dirtyCount, MAX_DIRTY_RECTS, {x, y, x1 - x, y1 - y});
+}
+
+void DisplayManager::invalidateAll() {
+    if (!_display) return;
+    _dirtyRects[0] = {0, 0, _display->width(), _display->height()};
+    _dirtyCount = 1;
+}
+
+DirtyRect DisplayManager::getDirtyRect(uint8_t index) const {
+    if (index < _dirtyCount) {
+        return _dirtyRects[index];
+    }
+    return {0, 0, 0, 0};
+}
+
+void DisplayManager::flush(RepaintCallback callback, void* context, uint32_t bgColor) {
+    if (!_display || _dirtyCount == 0) return;
+
+    // Copy the list so callbacks may invalidate regions for the next flush
+    DirtyRect rects[MAX_DIRTY_RECTS];
+    uint8_t count = _dirtyCount;
+    memcpy(rects, _dirtyRects, sizeof(DirtyRect) * count);
+    _dirtyCount = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const DirtyRect& r = rects[i];
+        _clip = r;
+        _gfx->setClipRect(r.x, r.y, r.w, r.h);
+
+        fillRect(r.x, r.y, r.w, r.h, bgColor);
+        if (callback) {
+            callback(this, r, context);
+        }
+
+        _gfx->clearClipRect();
+        _clip = {0, 0, 0, 0};
+    }
+}
+
+void DisplayManager::endFrame() {
+#ifdef DISPLAY_PROFILER
+    bool drew = _frameBytes > 0 || _profPrimitives > 0;
+    if (drew) {
+        recordFrame();
+    }
+#endif
+
+    // Every frame, idle ones included: 0 means nothing was pushed
+    _lastFrameBytes = _frameBytes;
+    _frameBytes = 0;
+
+#ifdef DISPLAY_PROFILER
+    // Only refresh the overlay when its numbers changed
+    if (drew && _profOverlay) {
+        drawProfilerOverlay();
+    }
+#endif
+}
+
+void DisplayManager::accountArea(int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (!_display) return;
+
+    // Clip to screen, or to the active dirty rect while flushing
+    int32_t cx0 = 0, cy0 = 0;
+    int32_t cx1 = _display->width(), cy1 = _display->height();
+    if (_clip.w > 0) {
+        cx0 = _clip.x;
+        cy0 = _clip.y;
+        cx1 = _clip.x + _clip.w;
+        cy1 = _clip.y + _clip.h;
+    }
+
+    int32_t x0 = max(x, cx0);
+    int32_t y0 = max(y, cy0);
+    int32_t x1 = min(x + w, cx1);
+    int32_t y1 = min(y + h, cy1);
+    if (x1 <= x0 || y1 <= y0) return;
+
+    accountPixels((uint32_t)(x1 - x0) * (uint32_t)(y1 - y0));
+    damage(x0, y0, x1 - x0, y1 - y0);
+}
+
+void DisplayManager::accountText(const char* text, int32_t x, int32_t y, uint8_t datum) {
+    if (!text) return;
+    int32_t w = _gfx->textWidth(text);
+    int32_t h = _gfx->fontHeight();
+    applyDatum(datum, w, h, x, y);
+    accountArea(x, y, w, h);
+}
+
+void DisplayManager::damage(int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (!_backBuffer) return;
+
+    // Areas the back buffer changed in, for present() to copy out
+    int32_t x0 = max(x, (int32_t)0);
+    int32_t y0 = max(y, (int32_t)0);
+    int32_t x1 = min(x + w, (int32_t)_backBuffer->width());
+    int32_t y1 = min(y + h, (int32_t)_backBuffer->height());
+    if (x1 <= x0 || y1 <= y0) return;
+
+    insertRect(_damageRects, _damageCount, MAX_DIRTY_RECTS, {x0, y0, x1 - x0, y1 - y0});
+}
+
+void DisplayManager::accountPixels(uint32_t pixels) {
+#ifdef DISPLAY_PROFILER
+    if (_profSuspended) return;
+    _profPixels += pixels;
+#endif
+    _frameBytes += pixels * 2;  // RGB565
+}
+
+#ifdef DISPLAY_PROFILER
+// Upper bounds (µs) of the histogram buckets; the last is open-ended
+static const uint32_t PROFILE_BUCKET_US[DisplayProfile::BUCKETS] = {
+    250, 500, 1000, 2000, 4000, 8000, 16000, 33000, UINT32_MAX
+};
+
+static uint8_t profileBucket(uint32_t us) {
+    uint8_t b = 0;
+    while (us >= PROFILE_BUCKET_US[b] && b < DisplayProfile::BUCKETS - 1) b++;
+    return b;
+}
+
+void DisplayManager::recordFrame() {
+    // Evict the oldest frame from the window once it is full
+    if (_profWindowCount == PROFILE_WINDOW) {
+        _profile.histogram[profileBucket(_profWindowUs[_profWindowPos])]--;
+    } else {
+        _profWindowCount++;
+    }
+    _profWindowUs[_profWindowPos] = _profUs;
+    _profWindowPos = (_profWindowPos + 1) % PROFILE_WINDOW;
+    _profile.histogram[profileBucket(_profUs)]++;
+
+    uint64_t total = 0;
+    uint32_t peak = 0;
+    for (uint8_t i = 0; i < _profWindowCount; i++) {
+        total += _profWindowUs[i];
+        peak = max(peak, _profWindowUs[i]);
+    }
+
+    _profile.frames++;
+    _profile.lastPrimitives = _profPrimitives;
+    _profile.lastPixels = _profPixels;
+    _profile.lastDrawUs = _profUs;
+    _profile.avgDrawUs = (uint32_t)(total / _profWindowCount);
+    _profile.maxDrawUs = peak;
+
+    _profPrimitives = 0;
+    _profPixels = 0;
+    _profUs = 0;
+}
+
+void DisplayManager::setProfilerOverlay(bool enabled) {
+    _profOverlay = enabled;
+    if (_display && !enabled) {
+        // The active screen's next render() repaints what was underneath
+        invalidate(width() - 200, height() - 36, 200, 36);
+    } else if (_display) {
+        drawProfilerOverlay();
+    }
+}
+
+void DisplayManager::drawProfilerOverlay() {
+    if (!_display) return;
+
+    // The overlay's own drawing is not profiled or counted
+    _profSuspended = true;
+
+    int32_t x = width() - 200;
+    int32_t y = height() - 36;
+    char line[48];
+
+    _gfx->fillRect(x, y, 200, 36, TFT_NAVY);
+    damage(x, y, 200, 36);
+    _gfx->setFont(&fonts::Font0);
+    _gfx->setTextDatum(TL_DATUM);
+    _gfx->setTextColor(TFT_WHITE, TFT_NAVY);
+
+    snprintf(line, sizeof(line), "draw %luus avg %lu max %lu",
+             (unsigned long)_profile.lastDrawUs, (unsigned long)_profile.avgDrawUs,
+             (unsigned long)_profile.maxDrawUs);
+    _gfx->drawString(line, x + 4, y + 4);
+
+    snprintf(line, sizeof(line), "prims %lu px %lu",
+             (unsigned long)_profile.lastPrimitives, (unsigned long)_profile.lastPixels);
+    _gfx->drawString(line, x + 4, y + 14);
+
+    snprintf(line, sizeof(line), "frames %lu", (unsigned long)_profile.frames);
+    _gfx->drawString(line, x + 4, y + 24);
+
+    _profSuspended = false;
+}
+
+void DisplayManager::dumpProfile() {
+    Serial.printf("Display profile: %lu frames\n", (unsigned long)_profile.frames);
+    Serial.printf("  last frame: %lu primitives, %lu pixels, %lu us\n",
+                  (unsigned long)_profile.lastPrimitives, (unsigned long)_profile.lastPixels,
+                  (unsigned long)_profile.lastDrawUs);
+    Serial.printf("  last %u frames: avg %lu us, max %lu us\n", _profWindowCount,
+                  (unsigned long)_profile.avgDrawUs, (unsigned long)_profile.maxDrawUs);
+
+    uint32_t lower = 0;
+    for (uint8_t b = 0; b < DisplayProfile::BUCKETS; b++) {
+        if (b < DisplayProfile::BUCKETS - 1) {
+            Serial.printf("  %6lu-%6lu us: %u\n", (unsigned long)lower,
+                          (unsigned long)PROFILE_BUCKET_US[b], _profile.histogram[b]);
+        } else {
+            Serial.printf("  %6lu+      us: %u\n", (unsigned long)lower, _profile.histogram[b]);
+        }
+        lower = PROFILE_BUCKET_US[b];
+    }
+
+    Serial.printf("  label cache: %u entries, %lu bytes, %lu hits, %lu misses, %lu evictions\n",
+                  _labelStats.entries, (unsigned long)_labelStats.bytes,
+                  (unsigned long)_labelStats.hits, (unsigned long)_labelStats.misses,
+                  (unsigned long)_labelStats.evictions);
+
+    if (_mode == RENDER_DOUBLE_BUFFERED) {
+        Serial.printf("  present: %lu copies, %lu missed vsyncs, %lu vsync timeouts, last %lu us (%lu px), max %lu us\n",
+                      (unsigned long)_presentStats.presents, (unsigned long)_presentStats.missedVsyncs,
+                      (unsigned long)_presentStats.vsyncTimeouts, (unsigned long)_presentStats.lastCopyUs,
+                      (unsigned long)_presentStats.lastCopyPixels, (unsigned long)_presentStats.maxCopyUs);
+    }
 }
+#endif
 
 int32_t DisplayManager::width() const {
     return _display->width();
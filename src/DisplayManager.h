@@ -3,13 +3,69 @@
 
 #include "LGFX_CrowPanel.h"
 
+// Screen region that needs repainting
+struct DirtyRect {
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+};
+
+// Where drawing lands
+enum RenderMode {
+    RENDER_DIRECT,          // Straight into the framebuffer the panel scans out
+    RENDER_DOUBLE_BUFFERED  // Into a PSRAM back buffer, copied out by present()
+};
+
+// present() counters (double-buffered mode)
+struct PresentStats {
+    uint32_t presents;        // Presents that copied something
+    uint32_t missedVsyncs;    // Copies that ran past the next VSYNC
+    uint32_t vsyncTimeouts;   // No VSYNC seen; copied unsynchronized
+    uint32_t lastCopyUs;
+    uint32_t maxCopyUs;
+    uint32_t lastCopyPixels;
+};
+
+// Label cache counters
+struct LabelCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t bytes;     // Sprite memory currently held
+    uint8_t entries;
+};
+
+#ifdef DISPLAY_PROFILER
+// Rolling draw-cost statistics (DISPLAY_PROFILER builds only)
+struct DisplayProfile {
+    static const uint8_t BUCKETS = 9;  // <0.25, <0.5, <1, <2, <4, <8, <16, <33, >=33 ms
+
+    uint32_t frames;           // Frames recorded since boot
+    uint32_t lastPrimitives;   // Draw calls in the last frame
+    uint32_t lastPixels;       // Pixels touched in the last frame
+    uint32_t lastDrawUs;       // Time spent in draw calls in the last frame
+    uint32_t avgDrawUs;        // Over the rolling window
+    uint32_t maxDrawUs;        // Over the rolling window
+    uint16_t histogram[BUCKETS];  // Frame draw times over the rolling window
+};
+#endif
+
 class DisplayManager {
 public:
     DisplayManager();
     ~DisplayManager();
 
-    // Initialization
-    bool begin();
+    // Initialization. Double-buffered mode needs a second 768KB PSRAM
+    // buffer and falls back to direct rendering if it can't get one.
+    bool begin(RenderMode mode = RENDER_DIRECT);
+    RenderMode getRenderMode() const { return _mode; }
+
+    // Copy everything drawn since the last present() to the panel, starting
+    // on VSYNC so the scanout never shows a half-drawn frame. No-op in
+    // direct mode.
+    void present();
+    const PresentStats& getPresentStats() const { return _presentStats; }
 
     // Backlight control
     void setBrightness(uint8_t brightness);  // 0-255
@@ -51,9 +107,63 @@ public:
     int16_t textWidth(const char* text);
     int16_t fontHeight();
 
+    // Label cache - renders a string once into a PSRAM sprite keyed by
+    // (text, font, colors) and blits it on later draws. The label is opaque:
+    // its text box is filled with bgColor. Least recently used entries are
+    // evicted when the cache is full; long strings are drawn uncached.
+    void drawCachedString(const char* text, int32_t x, int32_t y, uint8_t font,
+                          uint32_t fgColor, uint32_t bgColor, uint8_t datum = TL_DATUM);
+    const LabelCacheStats& getLabelCacheStats() const { return _labelStats; }
+    void clearLabelCache();
+
+    // Digit sets - DIGIT_GLYPHS rendered once per (font, scale, colors) into
+    // PSRAM sprites for large numeric displays. Every digit gets a cell of
+    // the same width, so changing one digit is a single opaque blit over
+    // the old one with nothing to erase. Meant for the 7-segment fonts
+    // (7 and 8) scaled up; ' ' draws as a background-filled digit cell.
+    static const char* const DIGIT_GLYPHS;
+    int8_t createDigitSet(uint8_t font, uint8_t scale, uint32_t fgColor, uint32_t bgColor);  // -1 on failure
+    void releaseDigitSet(int8_t set);
+    int32_t getDigitWidth(int8_t set, char c) const;  // Cell width, 0 if c isn't in the set
+    int32_t getDigitHeight(int8_t set) const;
+    bool drawDigit(int8_t set, char c, int32_t x, int32_t y);
+
     // Advanced features
     void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data);
     void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+    // Blit native-order RGB565 pixels (see color565()) in a single push
+    void pushImageRGB565(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* pixels);
+
+    // Convert a drawing color to the RGB565 value LovyanGFX writes for it
+    // (uint32_t color arguments are interpreted as RGB888)
+    static uint16_t color565(uint32_t color) {
+        return ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+    }
+
+    // Dirty-rectangle tracking
+    // Invalidated regions are coalesced and repainted by flush(), which clips
+    // drawing to each region so only those pixels are rewritten.
+    typedef void (*RepaintCallback)(DisplayManager* display, const DirtyRect& rect, void* context);
+    void invalidate(int32_t x, int32_t y, int32_t w, int32_t h);
+    void invalidateAll();
+    bool isDirty() const { return _dirtyCount > 0; }
+    uint8_t getDirtyCount() const { return _dirtyCount; }
+    DirtyRect getDirtyRect(uint8_t index) const;
+    void flush(RepaintCallback callback, void* context = nullptr, uint32_t bgColor = TFT_BLACK);
+    void endFrame();  // Closes the frame for bytes-written accounting
+
+    // Framebuffer bytes written (RGB565, estimated from clipped primitive area)
+    uint32_t getFrameBytesWritten() const { return _lastFrameBytes; }  // By the last endFrame()
+    uint32_t getPendingBytesWritten() const { return _frameBytes; }
+
+#ifdef DISPLAY_PROFILER
+    // Profiler - counts primitives, pixels and draw time per frame (frames
+    // end at endFrame()). Compiled out entirely without DISPLAY_PROFILER.
+    const DisplayProfile& getProfile() const { return _profile; }
+    void dumpProfile();                       // Print stats and histogram to Serial
+    void setProfilerOverlay(bool enabled);    // Draw stats in the corner each frame
+    bool isProfilerOverlayEnabled() const { return _profOverlay; }
+#endif
 
     // Display dimensions
     int32_t width() const;
@@ -64,8 +174,95 @@ public:
 
 private:
     LGFX* _display;
+    lgfx::LovyanGFX* _gfx;  // Draw target: the panel, or the back buffer
     uint8_t _brightness;
     bool _initialized;
+
+    // Dirty-rectangle list (coalesced on insert)
+    static const uint8_t MAX_DIRTY_RECTS = 16;
+    DirtyRect _dirtyRects[MAX_DIRTY_RECTS];
+    uint8_t _dirtyCount;
+
+    // Active clip while flushing (w == 0 when not clipping)
+    DirtyRect _clip;
+
+    // Double buffering
+    static const uint32_t VSYNC_TIMEOUT_MS = 50;  // ~35Hz refresh
+    RenderMode _mode;
+    LGFX_Sprite* _backBuffer;
+    DirtyRect _damageRects[MAX_DIRTY_RECTS];
+    uint8_t _damageCount;
+    SemaphoreHandle_t _vsyncSem;
+    volatile uint32_t _vsyncCount;
+    PresentStats _presentStats;
+
+    bool startDoubleBuffering();
+    void damage(int32_t x, int32_t y, int32_t w, int32_t h);
+    static void IRAM_ATTR vsyncISR(void* arg);
+
+    // Label cache
+    struct LabelEntry {
+        LGFX_Sprite* sprite;  // nullptr when the slot is free
+        uint32_t hash;
+        uint32_t lastUsed;
+        uint32_t fgColor;
+        uint32_t bgColor;
+        uint8_t font;
+        char text[48];
+    };
+    static const uint8_t MAX_LABELS = 24;
+    LabelEntry _labels[MAX_LABELS];
+    uint32_t _labelClock;
+    LabelCacheStats _labelStats;
+
+    LabelEntry* findLabel(const char* text, uint32_t hash, uint8_t font, uint32_t fgColor, uint32_t bgColor);
+    LabelEntry* renderLabel(const char* text, uint32_t hash, uint8_t font, uint32_t fgColor, uint32_t bgColor);
+    static const lgfx::IFont* fontForNumber(uint8_t font);
+
+    // Digit sets
+    static const uint8_t MAX_DIGIT_SETS = 2;
+    static const uint8_t DIGIT_GLYPH_COUNT = 13;  // strlen(DIGIT_GLYPHS)
+    struct DigitSet {
+        LGFX_Sprite* glyphs[DIGIT_GLYPH_COUNT];  // nullptr for ' '
+        uint16_t refs;      // 0 when the slot is free
+        int32_t digitWidth;
+        int32_t height;
+        uint32_t fgColor;
+        uint32_t bgColor;
+        uint8_t font;
+        uint8_t scale;
+    };
+    DigitSet _digitSets[MAX_DIGIT_SETS];
+
+    void freeDigitSet(DigitSet& set);
+    static int8_t digitGlyphIndex(char c);
+
+    // Bytes-written accounting
+    uint32_t _frameBytes;
+    uint32_t _lastFrameBytes;
+
+#ifdef DISPLAY_PROFILER
+    class ProfileScope;
+    static const uint8_t PROFILE_WINDOW = 64;  // Frames in the rolling window
+
+    DisplayProfile _profile;
+    uint32_t _profWindowUs[PROFILE_WINDOW];
+    uint8_t _profWindowPos;
+    uint8_t _profWindowCount;
+    uint32_t _profPrimitives;
+    uint32_t _profPixels;
+    uint32_t _profUs;
+    uint8_t _profDepth;
+    bool _profSuspended;  // While drawing the overlay itself
+    bool _profOverlay;
+
+    void recordFrame();
+    void drawProfilerOverlay();
+#endif
+
+    void accountArea(int32_t x, int32_t y, int32_t w, int32_t h);
+    void accountText(const char* text, int32_t x, int32_t y, uint8_t datum);
+    void accountPixels(uint32_t pixels);
 };
 
 #endif // DISPLAY_MANAGER_H
@@ -0,0 +1,62 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Arduino.h>
+#include "RingBuffer.h"
+
+// Typed publish/subscribe on top of RingBuffer. publish() only copies the
+// event into the queue - no locks, no heap - so it is safe from a callback
+// running on another task (one producer per bus). dispatch() runs on the
+// consuming task and hands each queued event to every subscriber in turn.
+// T must be a plain struct; QUEUE_SIZE must be a power of two.
+template <typename T, uint16_t QUEUE_SIZE = 16, uint8_t MAX_SUBSCRIBERS = 4>
+class EventBus {
+public:
+    typedef void (*Callback)(const T& event, void* context);
+
+    EventBus() : _subscriberCount(0) {}
+
+    // Register before the producer starts publishing; not thread-safe
+    bool subscribe(Callback callback, void* context = nullptr) {
+        if (!callback) return false;
+        if (_subscriberCount >= MAX_SUBSCRIBERS) {
+            Serial.println("ERROR: EventBus subscriber limit reached");
+            return false;
+        }
+        _subscribers[_subscriberCount].callback = callback;
+        _subscribers[_subscriberCount].context = context;
+        _subscriberCount++;
+        return true;
+    }
+
+    // Producer side - returns false when the queue is full
+    bool publish(const T& event) { return _queue.push(event); }
+
+    // Consumer side - delivers everything queued so far, returns the count
+    uint16_t dispatch() {
+        uint16_t count = 0;
+        T event;
+        while (_queue.pop(event)) {
+            for (uint8_t i = 0; i < _subscriberCount; i++) {
+                _subscribers[i].callback(event, _subscribers[i].context);
+            }
+            count++;
+        }
+        return count;
+    }
+
+    bool isEmpty() const { return _queue.isEmpty(); }
+    uint32_t getDroppedCount() const { return _queue.getOverflowCount(); }
+
+private:
+    struct Subscriber {
+        Callback callback;
+        void* context;
+    };
+
+    RingBuffer<T, QUEUE_SIZE> _queue;
+    Subscriber _subscribers[MAX_SUBSCRIBERS];
+    uint8_t _subscriberCount;
+};
+
+#endif // EVENT_BUS_H
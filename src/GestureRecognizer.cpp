@@ -0,0 +1,163 @@
+#include "GestureRecognizer.h"
+
+GestureRecognizer::GestureRecognizer() {
+    reset();
+}
+
+void GestureRecognizer::reset() {
+    for (uint8_t i = 0; i < MAX_FINGERS; i++) {
+        _fingers[i] = {0, false, false, 0, 0, 0, 0};
+    }
+    _downCount = 0;
+    _maxFingers = 0;
+    _moved = false;
+    _longPressFired = false;
+    _startUs = 0;
+    _startSpread = 0;
+}
+
+GestureRecognizer::Finger* GestureRecognizer::findFinger(uint8_t id) {
+    for (uint8_t i = 0; i < MAX_FINGERS; i++) {
+        if (_fingers[i].active && _fingers[i].down && _fingers[i].id == id) {
+            return &_fingers[i];
+        }
+    }
+    return nullptr;
+}
+
+void GestureRecognizer::processEvent(const TouchEvent& event) {
+    switch (event.type) {
+        case TOUCH_DOWN: {
+            if (_downCount == 0) {
+                // New sequence
+                _maxFingers = 0;
+                _moved = false;
+                _longPressFired = false;
+                _startUs = event.timestampUs;
+            }
+
+            // Claim a free slot; extra fingers are ignored
+            for (uint8_t i = 0; i < MAX_FINGERS; i++) {
+                if (!_fingers[i].active) {
+                    _fingers[i] = {event.id, true, true, event.x, event.y, event.x, event.y};
+                    _downCount++;
+                    break;
+                }
+            }
+            if (_downCount > _maxFingers) {
+                _maxFingers = _downCount;
+                if (_downCount == 2) {
+                    _startSpread = spread(true);
+                }
+            }
+            break;
+        }
+
+        case TOUCH_MOVE: {
+            Finger* f = findFinger(event.id);
+            if (!f) break;
+            f->lastX = event.x;
+            f->lastY = event.y;
+            if (abs(f->lastX - f->startX) > TAP_SLOP_PX || abs(f->lastY - f->startY) > TAP_SLOP_PX) {
+                _moved = true;
+            }
+            break;
+        }
+
+        case TOUCH_UP: {
+            Finger* f = findFinger(event.id);
+            if (!f) break;
+            f->lastX = event.x;
+            f->lastY = event.y;
+
+            f->down = false;
+            _downCount--;
+
+            // Lifted fingers keep their slot (and final position) until the
+            // last finger is up, then the whole sequence is classified
+            if (_downCount == 0) {
+                endSequence(event.timestampUs);
+                for (uint8_t i = 0; i < MAX_FINGERS; i++) {
+                    _fingers[i].active = false;
+                }
+            }
+            break;
+        }
+    }
+}
+
+void GestureRecognizer::update(int64_t nowUs) {
+    // Long press fires while the single finger is still held
+    if (_downCount == 1 && _maxFingers == 1 && !_moved && !_longPressFired &&
+        (uint64_t)(nowUs - _startUs) >= LONG_PRESS_US) {
+        _longPressFired = true;
+        emit(GESTURE_LONG_PRESS, 0, 0, nowUs);
+    }
+}
+
+void GestureRecognizer::endSequence(int64_t nowUs) {
+    uint32_t duration = (uint32_t)(nowUs - _startUs);
+
+    if (_maxFingers >= 2) {
+        int32_t change = spread(false) - _startSpread;
+        if (change <= -PINCH_MIN_PX) {
+            emit(GESTURE_PINCH_IN, change, 0, nowUs);
+        } else if (change >= PINCH_MIN_PX) {
+            emit(GESTURE_PINCH_OUT, change, 0, nowUs);
+        } else if (!_moved && duration <= TAP_MAX_US) {
+            emit(GESTURE_TWO_FINGER_TAP, 0, 0, nowUs);
+        }
+        return;
+    }
+
+    if (_longPressFired) return;
+
+    const Finger& f = _fingers[0];
+    int16_t dx = f.lastX - f.startX;
+    int16_t dy = f.lastY - f.startY;
+
+    if (_moved) {
+        if (duration <= SWIPE_MAX_US && max(abs(dx), abs(dy)) >= SWIPE_MIN_PX) {
+            if (abs(dx) >= abs(dy)) {
+                emit(dx < 0 ? GESTURE_SWIPE_LEFT : GESTURE_SWIPE_RIGHT, dx, dy, nowUs);
+            } else {
+                emit(dy < 0 ? GESTURE_SWIPE_UP : GESTURE_SWIPE_DOWN, dx, dy, nowUs);
+            }
+        }
+    } else if (duration < LONG_PRESS_US) {
+        emit(GESTURE_TAP, 0, 0, nowUs);
+    }
+}
+
+int32_t GestureRecognizer::spread(bool useStart) const {
+    const Finger& a = _fingers[0];
+    const Finger& b = _fingers[1];
+    int32_t dx = useStart ? (b.startX - a.startX) : (b.lastX - a.lastX);
+    int32_t dy = useStart ? (b.startY - a.startY) : (b.lastY - a.lastY);
+    return (int32_t)sqrtf((float)(dx * dx + dy * dy));
+}
+
+void GestureRecognizer::emit(GestureType type, int16_t dx, int16_t dy, int64_t nowUs) {
+    const Finger& f = _fingers[0];  // First finger of the sequence
+    Gesture gesture = {type, f.startX, f.startY, dx, dy, (uint32_t)(nowUs - _startUs), nowUs};
+    _gestures.push(gesture);
+}
+
+bool GestureRecognizer::pollGesture(Gesture& gesture) {
+    return _gestures.pop(gesture);
+}
+
+const char* GestureRecognizer::getTypeString(GestureType type) {
+    switch (type) {
+        case GESTURE_TAP: return "Tap";
+        case GESTURE_LONG_PRESS: return "Long press";
+        case GESTURE_SWIPE_LEFT: return "Swipe left";
+        case GESTURE_SWIPE_RIGHT: return "Swipe right";
+        case GESTURE_SWIPE_UP: return "Swipe up";
+        case GESTURE_SWIPE_DOWN: return "Swipe down";
+        case GESTURE_TWO_FINGER_TAP: return "Two-finger tap";
+        case GESTURE_PINCH_IN: return "Pinch in";
+        case GESTURE_PINCH_OUT: return "Pinch out";
+        default: return "Unknown";
+    }
+}
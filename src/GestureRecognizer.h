@@ -0,0 +1,78 @@
+#ifndef GESTURE_RECOGNIZER_H
+#define GESTURE_RECOGNIZER_H
+
+#include <Arduino.h>
+#include "TouchManager.h"
+#include "RingBuffer.h"
+
+enum GestureType {
+    GESTURE_TAP,
+    GESTURE_LONG_PRESS,
+    GESTURE_SWIPE_LEFT,
+    GESTURE_SWIPE_RIGHT,
+    GESTURE_SWIPE_UP,
+    GESTURE_SWIPE_DOWN,
+    GESTURE_TWO_FINGER_TAP,
+    GESTURE_PINCH_IN,
+    GESTURE_PINCH_OUT
+};
+
+struct Gesture {
+    GestureType type;
+    int16_t x;            // Where the gesture started (first finger)
+    int16_t y;
+    int16_t dx;           // Net movement (swipes) or spread change (pinches)
+    int16_t dy;
+    uint32_t durationUs;
+    int64_t timestampUs;  // When it was recognized
+};
+
+// Turns TouchManager's event stream into tap, long-press, swipe and
+// two-finger gestures. Feed every event, call update() each loop so long
+// presses fire while the finger is still down, then pull with pollGesture().
+class GestureRecognizer {
+public:
+    GestureRecognizer();
+
+    void processEvent(const TouchEvent& event);
+    void update(int64_t nowUs);
+    bool pollGesture(Gesture& gesture);
+    void reset();
+
+    static const char* getTypeString(GestureType type);
+
+    // Tuning
+    static const int16_t TAP_SLOP_PX = 20;          // Max drift for tap / long-press
+    static const int16_t SWIPE_MIN_PX = 80;         // Min travel for a swipe
+    static const int16_t PINCH_MIN_PX = 40;         // Min spread change for a pinch
+    static const uint32_t TAP_MAX_US = 300000;      // 300 ms, two-finger tap
+    static const uint32_t LONG_PRESS_US = 600000;   // 600 ms
+    static const uint32_t SWIPE_MAX_US = 800000;    // 800 ms
+
+private:
+    struct Finger {
+        uint8_t id;
+        bool active;  // Slot used in the current sequence
+        bool down;    // Finger still on the panel
+        int16_t startX, startY;
+        int16_t lastX, lastY;
+    };
+
+    static const uint8_t MAX_FINGERS = 2;  // Extra fingers are ignored
+    Finger _fingers[MAX_FINGERS];
+    uint8_t _downCount;
+    uint8_t _maxFingers;     // Peak fingers in the current sequence
+    bool _moved;             // Any finger left the tap slop
+    bool _longPressFired;
+    int64_t _startUs;
+    int32_t _startSpread;    // Finger distance when the second finger landed
+
+    RingBuffer<Gesture, 8> _gestures;
+
+    Finger* findFinger(uint8_t id);
+    void endSequence(int64_t nowUs);
+    void emit(GestureType type, int16_t dx, int16_t dy, int64_t nowUs);
+    int32_t spread(bool useStart) const;
+};
+
+#endif // GESTURE_RECOGNIZER_H
@@ -0,0 +1,117 @@
+#include "LocalClock.h"
+#include <esp_timer.h>
+
+LocalClock::LocalClock()
+    : _sequence(0),
+      _lastOffsetUs(0),
+      _correctedUs(0),
+      _samples(0),
+      _driftEstimates(0) {
+    memset(&_model, 0, sizeof(_model));
+}
+
+bool LocalClock::isSynced() const {
+    return readModel().synced;
+}
+
+int64_t LocalClock::nowUs() const {
+    Model model = readModel();
+    if (!model.synced) return 0;
+    return predict(model, esp_timer_get_time());
+}
+
+time_t LocalClock::now() const {
+    return (time_t)(nowUs() / 1000000);
+}
+
+int32_t LocalClock::getDriftPpb() const {
+    return readModel().driftPpb;
+}
+
+int64_t LocalClock::applySample(int64_t utcUs, int64_t localUs, uint32_t uncertaintyUs) {
+    Model model = _model;  // Only this task writes, no need for readModel()
+    _samples++;
+
+    if (!model.synced) {
+        model.synced = true;
+        model.baseLocalUs = localUs;
+        model.baseUtcUs = utcUs;
+        model.driftPpb = 0;
+        writeModel(model);
+        _lastOffsetUs = 0;
+        return 0;
+    }
+
+    int64_t offset = utcUs - predict(model, localUs);
+    int64_t span = localUs - model.baseLocalUs;
+    _lastOffsetUs = offset;
+
+    if (offset > STEP_RESET_US || offset < -STEP_RESET_US) {
+        // Someone changed the time or the sample is garbage - either way
+        // the drift measured so far says nothing about it
+        Serial.printf("Clock: %lld ms step, restarting drift estimate\n", (long long)(offset / 1000));
+        model.driftPpb = 0;
+        _driftEstimates = 0;
+    } else if (span >= (int64_t)MIN_DRIFT_SPAN_S * 1000000 && (int64_t)uncertaintyUs * 4 < span / 1000) {
+        // Whatever error built up since the base is drift the model missed.
+        // Take the first estimate whole, then move halfway to each new one
+        // so a single noisy round trip can't swing it.
+        int64_t residual = (offset + _correctedUs) * 1000000000LL / span;
+        int64_t drift = model.driftPpb + (_driftEstimates ? residual / 2 : residual);
+        if (drift > MAX_DRIFT_PPB) drift = MAX_DRIFT_PPB;
+        if (drift < -MAX_DRIFT_PPB) drift = -MAX_DRIFT_PPB;
+        model.driftPpb = (int32_t)drift;
+        _driftEstimates++;
+    } else {
+        // Too soon (or too noisy) to measure drift; just correct the offset
+        // and keep measuring from the original base
+        model.baseUtcUs += offset;
+        _correctedUs += offset;
+        writeModel(model);
+        return offset;
+    }
+
+    // Restart the model from this sample
+    _correctedUs = 0;
+    model.baseLocalUs = localUs;
+    model.baseUtcUs = utcUs;
+    writeModel(model);
+    return offset;
+}
+
+void LocalClock::dump() {
+    Model model = readModel();
+    if (!model.synced) {
+        Serial.println("Clock: not synced");
+        return;
+    }
+
+    int64_t since = (esp_timer_get_time() - model.baseLocalUs) / 1000000;
+    Serial.printf("Clock: %lu UTC, drift %+ld ppb (%s), last offset %+lld ms, %u samples, base %lld s ago\n",
+                  (unsigned long)now(), (long)model.driftPpb,
+                  _driftEstimates ? "measured" : "not measured yet", (long long)(_lastOffsetUs / 1000),
+                  _samples, (long long)since);
+}
+
+LocalClock::Model LocalClock::readModel() const {
+    Model model;
+    uint32_t before;
+    do {
+        before = _sequence.load(std::memory_order_acquire);
+        model = _model;
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((before & 1) || before != _sequence.load(std::memory_order_relaxed));
+    return model;
+}
+
+void LocalClock::writeModel(const Model& model) {
+    _sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _model = model;
+    _sequence.fetch_add(1, std::memory_order_release);
+}
+
+int64_t LocalClock::predict(const Model& model, int64_t localUs) {
+    int64_t elapsed = localUs - model.baseLocalUs;
+    return model.baseUtcUs + elapsed + elapsed * model.driftPpb / 1000000000LL;
+}
@@ -0,0 +1,65 @@
+#ifndef LOCAL_CLOCK_H
+#define LOCAL_CLOCK_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Wall clock disciplined by time samples (NTP). Between samples it runs on
+// esp_timer, corrected by the measured crystal drift, so it stays accurate
+// for hours without asking the network.
+//
+// One task applies samples; any task may read. Reads retry around a
+// sequence counter instead of taking a lock, so the UI never blocks on the
+// network task.
+class LocalClock {
+public:
+    // Drift is only estimated across at least this much local time; shorter
+    // spans are dominated by network jitter
+    static const uint32_t MIN_DRIFT_SPAN_S = 600;
+    static const int32_t MAX_DRIFT_PPB = 200000;     // 200 ppm - anything more is a bad sample
+    static const int64_t STEP_RESET_US = 2000000;    // Offsets this large restart the model
+
+    LocalClock();
+
+    // Reads - any task
+    bool isSynced() const;
+    int64_t nowUs() const;   // UTC microseconds since the Unix epoch, 0 before the first sample
+    time_t now() const;      // UTC seconds since the Unix epoch, 0 before the first sample
+    int32_t getDriftPpb() const;  // Correction applied to esp_timer (+ = crystal runs slow)
+
+    // Writer - one task. utcUs is the true time at local esp_timer reading
+    // localUs; uncertaintyUs bounds its error (half the round trip).
+    // Returns the model's error at that instant (true - predicted), or 0
+    // for the first sample.
+    int64_t applySample(int64_t utcUs, int64_t localUs, uint32_t uncertaintyUs);
+
+    // Writer-side diagnostics (read them from the writing task)
+    int64_t getLastOffsetUs() const { return _lastOffsetUs; }
+    uint16_t getSampleCount() const { return _samples; }
+    bool hasDriftEstimate() const { return _driftEstimates > 0; }
+    void dump();  // Print the model to Serial
+
+private:
+    // The model: utc = baseUtc + elapsed + elapsed * drift / 1e9, where
+    // elapsed = local - baseLocal
+    struct Model {
+        bool synced;
+        int64_t baseLocalUs;
+        int64_t baseUtcUs;
+        int32_t driftPpb;
+    };
+
+    Model _model;
+    std::atomic<uint32_t> _sequence;  // Odd while the model is being written
+
+    int64_t _lastOffsetUs;
+    int64_t _correctedUs;       // Offsets folded into the base since it was set
+    uint16_t _samples;
+    uint16_t _driftEstimates;
+
+    Model readModel() const;
+    void writeModel(const Model& model);
+    static int64_t predict(const Model& model, int64_t localUs);
+};
+
+#endif // LOCAL_CLOCK_H
@@ -0,0 +1,179 @@
+#include "NetworkTask.h"
+
+// Static member initialization
+NetworkTask* NetworkTask::_instance = nullptr;
+
+NetworkTask::NetworkTask()
+    : _wifi(nullptr),
+      _time(nullptr),
+      _task(nullptr),
+      _commandTaskId(Scheduler::INVALID_TASK) {
+    _instance = this;  // For static callback
+}
+
+NetworkTask::~NetworkTask() {
+    if (_task) {
+        vTaskDelete(_task);
+        _task = nullptr;
+    }
+    _instance = nullptr;
+}
+
+bool NetworkTask::begin(WiFiManager* wifi, TimeManager* time, BaseType_t core) {
+    if (!wifi) {
+        Serial.println("ERROR: NetworkTask needs a WiFiManager");
+        return false;
+    }
+
+    _wifi = wifi;
+    _wifi->onStateChange(onStateChange);
+    _time = time;
+
+    // Registered before the task exists, so a command posted the moment
+    // begin() returns already has a valid task id to signal
+    _scheduler.addPeriodic("wifi", UPDATE_PERIOD_MS, updateTask, this);
+    _commandTaskId = _scheduler.addEvent("commands", commandTask, this);
+    if (_time) {
+        _scheduler.addPeriodic("time", TIME_PERIOD_MS, timeTask, this);
+    }
+
+    BaseType_t created = xTaskCreatePinnedToCore(taskMain, "network", STACK_SIZE, this, 1, &_task, core);
+    if (created != pdPASS) {
+        Serial.println("ERROR: Failed to create network task, WiFi will run from the UI loop");
+        _task = nullptr;
+
+        if (!_wifi->begin()) {
+            Serial.println("ERROR: WiFi initialization failed!");
+        }
+        return false;
+    }
+
+    Serial.printf("Network task started on core %d\n", (int)core);
+    return true;
+}
+
+void NetworkTask::taskMain(void* arg) {
+    NetworkTask* self = static_cast<NetworkTask*>(arg);
+
+    // WiFiManager is only ever touched from this task from here on
+    if (!self->_wifi->begin()) {
+        Serial.println("ERROR: WiFi initialization failed!");
+        // Continue anyway - the UI shows the setup screen
+    }
+
+    self->_scheduler.begin();
+
+    for (;;) {
+        self->_scheduler.run();
+    }
+}
+
+void NetworkTask::updateTask(void* context) {
+    static_cast<NetworkTask*>(context)->poll();
+}
+
+void NetworkTask::commandTask(void* context) {
+    // Same work as the periodic pass, run as soon as a command arrives
+    static_cast<NetworkTask*>(context)->poll();
+}
+
+void NetworkTask::timeTask(void* context) {
+    NetworkTask* self = static_cast<NetworkTask*>(context);
+    self->_time->update();
+}
+
+void NetworkTask::poll() {
+    if (!_wifi) return;
+    processCommands();
+    _wifi->update();
+
+    // Without the task there is no separate time slot; update() is cheap
+    // unless a sync is due
+    if (!_task && _time) {
+        _time->update();
+    }
+}
+
+void NetworkTask::processCommands() {
+    WiFiCommand command;
+    while (_commands.pop(command)) {
+        switch (command.type) {
+            case WIFI_CMD_RECONNECT:
+                _wifi->reconnect();
+                break;
+
+            case WIFI_CMD_RESET_CREDENTIALS:
+                _wifi->resetCredentials();
+                break;
+
+            case WIFI_CMD_DUMP_METRICS:
+                _wifi->dumpMetrics();
+                break;
+
+            case WIFI_CMD_REQUEST_METRICS:
+                _metrics.push(_wifi->getMetrics());  // Dropped if the last one wasn't read
+                break;
+
+            case WIFI_CMD_DUMP_TIME:
+                if (_time) {
+                    _time->dumpMetrics();
+                } else {
+                    Serial.println("Time: no TimeManager");
+                }
+                break;
+
+            case WIFI_CMD_SYNC_TIME:
+                if (_time) _time->requestSync();
+                break;
+        }
+    }
+}
+
+bool NetworkTask::postCommand(WiFiCommandType type) {
+    WiFiCommand command = {type};
+    if (!_commands.push(command)) {
+        Serial.println("WARNING: WiFi command queue full, command dropped");
+        return false;
+    }
+
+    // signal() is safe from the UI task; before the network task's
+    // scheduler starts it only marks the command task, which its first
+    // run() then picks up
+    if (_task) {
+        _scheduler.signal(_commandTaskId);
+    }
+    return true;
+}
+
+bool NetworkTask::pollStatus(WiFiStatus& status) {
+    return _status.pop(status);
+}
+
+bool NetworkTask::pollMetrics(WiFiMetrics& metrics) {
+    return _metrics.pop(metrics);
+}
+
+void NetworkTask::onStateChange(WiFiState state) {
+    if (_instance) {
+        _instance->publishState(state);
+    }
+}
+
+void NetworkTask::publishState(WiFiState state) {
+    if (_time) {
+        _time->setNetworkAvailable(state == WIFI_CONNECTED);
+    }
+
+    WiFiStatus status;
+    status.state = state;
+    status.ip = state == WIFI_CONNECTED ? _wifi->getIP() : 0;
+    status.rssi = _wifi->getRSSI();
+
+    String ssid = _wifi->getSSID();
+    strncpy(status.ssid, ssid.c_str(), sizeof(status.ssid) - 1);
+    status.ssid[sizeof(status.ssid) - 1] = '\0';
+
+    if (!_status.push(status)) {
+        Serial.println("WARNING: WiFi status queue full, state change dropped");
+    }
+}
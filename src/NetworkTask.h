@@ -0,0 +1,87 @@
+#ifndef NETWORK_TASK_H
+#define NETWORK_TASK_H
+
+#include <Arduino.h>
+#include "WiFiManager.h"
+#include "TimeManager.h"
+#include "RingBuffer.h"
+#include "Scheduler.h"
+
+// Commands from the UI to the network task
+enum WiFiCommandType {
+    WIFI_CMD_RECONNECT,
+    WIFI_CMD_RESET_CREDENTIALS,
+    WIFI_CMD_DUMP_METRICS,      // Print WiFiManager metrics to Serial
+    WIFI_CMD_REQUEST_METRICS,   // Post a WiFiMetrics snapshot for pollMetrics()
+    WIFI_CMD_DUMP_TIME,         // Print TimeManager metrics and the clock model to Serial
+    WIFI_CMD_SYNC_TIME          // Query NTP now instead of at the next interval
+};
+
+struct WiFiCommand {
+    WiFiCommandType type;
+};
+
+// State change snapshot from the network task to the UI. Carries what the
+// UI shows so it never has to read WiFiManager across cores.
+struct WiFiStatus {
+    WiFiState state;
+    uint32_t ip;       // IPv4, network order as in IPAddress; 0 when not connected
+    int8_t rssi;
+    char ssid[33];
+};
+
+// Runs WiFiManager on its own FreeRTOS task pinned to core 0 (next to the
+// WiFi/BLE stacks), away from the UI on the Arduino loop task (core 1).
+// The two sides only talk through single-producer/single-consumer queues:
+// the UI posts commands and polls status; the network task does the rest.
+// If the task can't be created, call poll() from the UI loop instead.
+//
+// An optional TimeManager rides along: it is told when WiFi comes and goes
+// and syncs from this task, so its blocking NTP queries never stall the UI.
+// The UI reads the time straight from the LocalClock, which is safe from
+// any task.
+class NetworkTask {
+public:
+    NetworkTask();
+    ~NetworkTask();
+
+    bool begin(WiFiManager* wifi, TimeManager* time = nullptr, BaseType_t core = 0);
+    bool isRunning() const { return _task != nullptr; }
+
+    // UI side
+    bool postCommand(WiFiCommandType type);
+    bool pollStatus(WiFiStatus& status);
+    bool pollMetrics(WiFiMetrics& metrics);  // After WIFI_CMD_REQUEST_METRICS
+    uint32_t getDroppedStatus() const { return _status.getOverflowCount(); }
+    uint32_t getDroppedCommands() const { return _commands.getOverflowCount(); }
+
+    // Network side - one pass of commands plus the state machine
+    void poll();
+
+private:
+    static const uint32_t STACK_SIZE = 8192;
+    static const uint32_t UPDATE_PERIOD_MS = 500;  // 2 Hz - WiFi timeouts are in seconds
+    static const uint32_t TIME_PERIOD_MS = 1000;   // Sync intervals are minutes to hours
+
+    WiFiManager* _wifi;
+    TimeManager* _time;
+    TaskHandle_t _task;
+    Scheduler _scheduler;  // Network task's own timing
+    int8_t _commandTaskId;
+
+    RingBuffer<WiFiCommand, 8> _commands;  // UI -> network
+    RingBuffer<WiFiStatus, 8> _status;     // Network -> UI
+    RingBuffer<WiFiMetrics, 2> _metrics;   // Network -> UI, on request
+
+    void processCommands();
+    void publishState(WiFiState state);
+
+    static void taskMain(void* arg);
+    static void updateTask(void* context);
+    static void commandTask(void* context);
+    static void timeTask(void* context);
+    static void onStateChange(WiFiState state);
+    static NetworkTask* _instance;  // For the WiFiManager callback
+};
+
+#endif // NETWORK_TASK_H
@@ -0,0 +1,36 @@
+#include "RetryPolicy.h"
+
+FixedRetryPolicy::FixedRetryPolicy(uint16_t maxAttempts, uint32_t delayMs)
+    : _maxAttempts(maxAttempts),
+      _delayMs(delayMs) {
+}
+
+bool FixedRetryPolicy::nextDelay(uint16_t attempt, uint32_t& delayMs) {
+    if (attempt > _maxAttempts) return false;
+    delayMs = _delayMs;
+    return true;
+}
+
+BackoffRetryPolicy::BackoffRetryPolicy(uint32_t baseMs, uint32_t maxMs, uint8_t jitterPercent, uint16_t maxAttempts)
+    : _baseMs(baseMs),
+      _maxMs(maxMs),
+      _jitterPercent(min(jitterPercent, (uint8_t)100)),
+      _maxAttempts(maxAttempts) {
+}
+
+bool BackoffRetryPolicy::nextDelay(uint16_t attempt, uint32_t& delayMs) {
+    if (_maxAttempts && attempt > _maxAttempts) return false;
+
+    // Double per attempt until the cap (shift limited so it can't overflow)
+    uint8_t shift = attempt > 1 ? min(attempt - 1, 20) : 0;
+    int64_t wait = min((int64_t)_baseMs << shift, (int64_t)_maxMs);
+
+    if (_jitterPercent) {
+        int32_t spread = (int32_t)(wait * _jitterPercent / 100);
+        wait += random(-spread, spread + 1);
+        wait = min(wait, (int64_t)_maxMs);  // The cap is a hard limit
+    }
+
+    delayMs = (uint32_t)wait;
+    return true;
+}
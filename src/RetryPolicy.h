@@ -0,0 +1,45 @@
+#ifndef RETRY_POLICY_H
+#define RETRY_POLICY_H
+
+#include <Arduino.h>
+
+// Decides how long to wait before each automatic retry and when to stop.
+// Attempts are numbered from 1 (the first retry after a failure).
+class RetryPolicy {
+public:
+    virtual ~RetryPolicy() {}
+
+    // Sets delayMs and returns true to retry, false to give up
+    virtual bool nextDelay(uint16_t attempt, uint32_t& delayMs) = 0;
+};
+
+// Up to maxAttempts retries, a fixed delay apart
+class FixedRetryPolicy : public RetryPolicy {
+public:
+    FixedRetryPolicy(uint16_t maxAttempts, uint32_t delayMs = 0);
+
+    bool nextDelay(uint16_t attempt, uint32_t& delayMs) override;
+
+private:
+    uint16_t _maxAttempts;
+    uint32_t _delayMs;
+};
+
+// baseMs, 2x, 4x ... up to maxMs, each spread by +/- jitterPercent so a
+// room full of clocks doesn't hit the router in lockstep after a power cut.
+// maxAttempts = 0 never gives up.
+class BackoffRetryPolicy : public RetryPolicy {
+public:
+    BackoffRetryPolicy(uint32_t baseMs = 2000, uint32_t maxMs = 300000,
+                       uint8_t jitterPercent = 20, uint16_t maxAttempts = 0);
+
+    bool nextDelay(uint16_t attempt, uint32_t& delayMs) override;
+
+private:
+    uint32_t _baseMs;
+    uint32_t _maxMs;
+    uint8_t _jitterPercent;
+    uint16_t _maxAttempts;
+};
+
+#endif // RETRY_POLICY_H
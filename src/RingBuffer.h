@@ -0,0 +1,92 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Fixed-size FIFO with no heap allocation. Safe without locks for one
+// producer and one consumer (which may run on different tasks or cores).
+// N must be a power of two; capacity is N - 1.
+template <typename T, uint16_t N>
+class RingBuffer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "RingBuffer size must be a power of two");
+
+public:
+    RingBuffer() : _head(0), _tail(0), _overflows(0) {}
+
+    // Producer side - returns false (and counts an overflow) when full
+    bool push(const T& item) {
+        uint16_t head = _head.load(std::memory_order_relaxed);
+        uint16_t next = (head + 1) & (N - 1);
+        if (next == _tail.load(std::memory_order_acquire)) {
+            _overflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _items[head] = item;
+        _head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        uint16_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _items[tail];
+        _tail.store((tail + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+    bool peek(T& item) const {
+        uint16_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _items[tail];
+        return true;
+    }
+
+    // Bulk copies for sample streams. Move as many items as fit (write) or
+    // are queued (read) and return the count; a short write is not an overflow.
+    uint16_t write(const T* items, uint16_t count) {
+        uint16_t head = _head.load(std::memory_order_relaxed);
+        uint16_t free = (_tail.load(std::memory_order_acquire) - head - 1) & (N - 1);
+        if (count > free) count = free;
+        for (uint16_t i = 0; i < count; i++) {
+            _items[(head + i) & (N - 1)] = items[i];
+        }
+        _head.store((head + count) & (N - 1), std::memory_order_release);
+        return count;
+    }
+
+    uint16_t read(T* items, uint16_t count) {
+        uint16_t tail = _tail.load(std::memory_order_relaxed);
+        uint16_t queued = (_head.load(std::memory_order_acquire) - tail) & (N - 1);
+        if (count > queued) count = queued;
+        for (uint16_t i = 0; i < count; i++) {
+            items[i] = _items[(tail + i) & (N - 1)];
+        }
+        _tail.store((tail + count) & (N - 1), std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side only
+    void clear() { _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release); }
+
+    bool isEmpty() const { return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire); }
+    uint16_t size() const {
+        return (_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire)) & (N - 1);
+    }
+    uint16_t space() const { return capacity() - size(); }
+    static uint16_t capacity() { return N - 1; }
+    uint32_t getOverflowCount() const { return _overflows.load(std::memory_order_relaxed); }
+
+private:
+    T _items[N];
+    std::atomic<uint16_t> _head;  // Next slot to write (producer)
+    std::atomic<uint16_t> _tail;  // Next slot to read (consumer)
+    std::atomic<uint32_t> _overflows;
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,225 @@
+#include "Scheduler.h"
+#include <esp_timer.h>
+
+Scheduler::Scheduler()
+    : _taskCount(0),
+      _owner(nullptr),
+      _signalLock(portMUX_INITIALIZER_UNLOCKED),
+      _windowStartUs(0),
+      _windowSleepUs(0),
+      _loadPercent(0) {
+    memset(_tasks, 0, sizeof(_tasks));
+}
+
+bool Scheduler::begin() {
+    _owner = xTaskGetCurrentTaskHandle();
+    _windowStartUs = esp_timer_get_time();
+    return true;
+}
+
+int8_t Scheduler::addPeriodic(const char* name, uint32_t periodMs, TaskCallback callback,
+                              void* context, uint32_t deadlineMs) {
+    if (periodMs == 0) {
+        Serial.println("ERROR: Scheduler period must be at least 1 ms");
+        return INVALID_TASK;
+    }
+    return addTask(name, true, periodMs, callback, context, deadlineMs ? deadlineMs : periodMs);
+}
+
+int8_t Scheduler::addEvent(const char* name, TaskCallback callback, void* context, uint32_t deadlineMs) {
+    return addTask(name, false, 0, callback, context, deadlineMs);
+}
+
+int8_t Scheduler::addTask(const char* name, bool periodic, uint32_t periodMs, TaskCallback callback,
+                          void* context, uint32_t deadlineMs) {
+    if (!callback) return INVALID_TASK;
+
+    if (_taskCount >= MAX_TASKS) {
+        Serial.println("ERROR: Scheduler task limit reached");
+        return INVALID_TASK;
+    }
+
+    Task& task = _tasks[_taskCount];
+    task.name = name;
+    task.callback = callback;
+    task.context = context;
+    task.periodic = periodic;
+    task.enabled = true;
+    task.periodUs = periodMs * 1000;
+    task.deadlineUs = deadlineMs * 1000;
+    task.dueUs = esp_timer_get_time();  // Periodic tasks run on the first pass
+    task.signalled = false;
+    memset(&task.stats, 0, sizeof(task.stats));
+
+    return _taskCount++;
+}
+
+void Scheduler::signal(int8_t id) {
+    signalAt(id, esp_timer_get_time());
+}
+
+void Scheduler::signalAt(int8_t id, int64_t dueUs) {
+    if (id < 0 || id >= _taskCount) return;
+
+    // An earlier pending time wins, so a signal() is never pushed back by
+    // a reschedule. A task rescheduling itself from its own run has no
+    // pending time (it was taken before the run) and simply sets it.
+    Task& task = _tasks[id];
+    portENTER_CRITICAL(&_signalLock);
+    if (!task.signalled || dueUs < task.dueUs) {
+        task.dueUs = dueUs;
+        task.signalled = true;
+    }
+    portEXIT_CRITICAL(&_signalLock);
+
+    if (_owner && _owner != xTaskGetCurrentTaskHandle()) {
+        xTaskNotifyGive(_owner);  // Recompute the sleep
+    }
+}
+
+bool Scheduler::takeSignal(Task& task, int64_t now, int64_t& dueUs) {
+    bool due = false;
+    portENTER_CRITICAL(&_signalLock);
+    if (task.signalled && now >= task.dueUs) {
+        task.signalled = false;
+        dueUs = task.dueUs;
+        due = true;
+    }
+    portEXIT_CRITICAL(&_signalLock);
+    return due;
+}
+
+void Scheduler::setEnabled(int8_t id, bool enabled) {
+    if (id < 0 || id >= _taskCount) return;
+
+    Task& task = _tasks[id];
+    if (enabled && !task.enabled && task.periodic) {
+        task.dueUs = esp_timer_get_time();
+    }
+    task.enabled = enabled;
+}
+
+void Scheduler::setPeriod(int8_t id, uint32_t periodMs) {
+    if (id < 0 || id >= _taskCount || periodMs == 0) return;
+
+    Task& task = _tasks[id];
+    if (task.deadlineUs == task.periodUs) {
+        task.deadlineUs = periodMs * 1000;  // Deadline was following the period
+    }
+    task.dueUs += (int64_t)periodMs * 1000 - task.periodUs;
+    task.periodUs = periodMs * 1000;
+}
+
+void Scheduler::runOnce() {
+    for (uint8_t i = 0; i < _taskCount; i++) {
+        Task& task = _tasks[i];
+        if (!task.enabled) continue;
+
+        if (task.periodic) {
+            int64_t now = esp_timer_get_time();
+            if (now < task.dueUs) continue;
+
+            int64_t dueUs = task.dueUs;
+            task.dueUs += task.periodUs;
+            if (task.dueUs <= now) {
+                // Fell more than a period behind - skip the missed runs
+                // rather than bursting to catch up
+                task.dueUs = now + task.periodUs;
+            }
+            runTask(task, dueUs);
+        } else {
+            int64_t dueUs;
+            if (takeSignal(task, esp_timer_get_time(), dueUs)) {
+                runTask(task, dueUs);
+            }
+        }
+    }
+}
+
+void Scheduler::runTask(Task& task, int64_t dueUs) {
+    int64_t start = esp_timer_get_time();
+    task.callback(task.context);
+    int64_t end = esp_timer_get_time();
+
+    uint32_t latency = start > dueUs ? (uint32_t)(start - dueUs) : 0;
+    uint32_t runUs = (uint32_t)(end - start);
+
+    task.stats.runs++;
+    if (latency > task.deadlineUs) {
+        task.stats.deadlineMisses++;
+    }
+    if (latency > task.stats.maxLatencyUs) {
+        task.stats.maxLatencyUs = latency;
+    }
+    if (runUs > task.stats.maxRunUs) {
+        task.stats.maxRunUs = runUs;
+    }
+}
+
+void Scheduler::run() {
+    runOnce();
+
+    // Sleep until the earliest due task; pending signals are due at their
+    // signal time, which is now unless it came from signalAt()
+    int64_t now = esp_timer_get_time();
+    int64_t wakeUs = now + (int64_t)MAX_SLEEP_MS * 1000;
+    for (uint8_t i = 0; i < _taskCount; i++) {
+        const Task& task = _tasks[i];
+        if (!task.enabled) continue;
+
+        if (task.periodic) {
+            wakeUs = min(wakeUs, task.dueUs);
+        } else {
+            portENTER_CRITICAL(&_signalLock);
+            if (task.signalled) {
+                wakeUs = min(wakeUs, task.dueUs);
+            }
+            portEXIT_CRITICAL(&_signalLock);
+        }
+    }
+
+    sleepUntil(wakeUs);
+}
+
+void Scheduler::sleepUntil(int64_t wakeUs) {
+    int64_t start = esp_timer_get_time();
+
+    if (wakeUs > start) {
+        // Round up to whole ticks so we never wake before the task is due
+        uint32_t ms = (uint32_t)((wakeUs - start + 999) / 1000);
+        TickType_t ticks = (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+
+        if (_owner) {
+            ulTaskNotifyTake(pdTRUE, ticks);  // signal() ends the sleep early
+        } else {
+            vTaskDelay(ticks);
+        }
+    }
+
+    // Load accounting
+    int64_t end = esp_timer_get_time();
+    _windowSleepUs += (uint32_t)(end - start);
+    uint32_t windowUs = (uint32_t)(end - _windowStartUs);
+    if (windowUs >= LOAD_WINDOW_US) {
+        uint32_t busyUs = windowUs > _windowSleepUs ? windowUs - _windowSleepUs : 0;
+        _loadPercent = (uint8_t)((uint64_t)busyUs * 100 / windowUs);
+        _windowStartUs = end;
+        _windowSleepUs = 0;
+    }
+}
+
+const TaskStats* Scheduler::getStats(int8_t id) const {
+    if (id < 0 || id >= _taskCount) return nullptr;
+    return &_tasks[id].stats;
+}
+
+void Scheduler::dumpStats() {
+    Serial.printf("Scheduler: %u tasks, %u%% busy\n", _taskCount, _loadPercent);
+    for (uint8_t i = 0; i < _taskCount; i++) {
+        const Task& task = _tasks[i];
+        Serial.printf("  %-8s %5lu ms  runs %lu, misses %lu, max latency %lu us, max run %lu us\n",
+                      task.name, (unsigned long)(task.periodUs / 1000), (unsigned long)task.stats.runs,
+                      (unsigned long)task.stats.deadlineMisses, (unsigned long)task.stats.maxLatencyUs,
+                      (unsigned long)task.stats.maxRunUs);
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// Per-task timing
+struct TaskStats {
+    uint32_t runs;
+    uint32_t deadlineMisses;  // Runs that started later than the deadline allows
+    uint32_t maxLatencyUs;    // Worst delay between due time and start
+    uint32_t maxRunUs;        // Longest single run
+};
+
+// Cooperative scheduler for the Arduino loop task. Subsystems register
+// periodic tasks (run every N ms) or event tasks (run once per signal(),
+// or once at a time given to signalAt());
+// run() executes whatever is due and then sleeps until the next due time
+// or until a signal arrives, so the CPU idles instead of spinning.
+// Tasks run to completion on the calling task and must not block.
+// signal() and signalAt() may be called from any task or core.
+class Scheduler {
+public:
+    typedef void (*TaskCallback)(void* context);
+    static const int8_t INVALID_TASK = -1;
+
+    Scheduler();
+
+    // Records the calling FreeRTOS task so signals can wake it
+    bool begin();
+
+    // deadlineMs: how late a run may start before it counts as a miss
+    // (0 = one period for periodic tasks)
+    int8_t addPeriodic(const char* name, uint32_t periodMs, TaskCallback callback,
+                       void* context = nullptr, uint32_t deadlineMs = 0);
+    int8_t addEvent(const char* name, TaskCallback callback,
+                    void* context = nullptr, uint32_t deadlineMs = 10);
+
+    void signal(int8_t id);                       // Run an event task soon
+    void signalAt(int8_t id, int64_t dueUs);      // Run an event task at an esp_timer time
+    void setEnabled(int8_t id, bool enabled);
+    void setPeriod(int8_t id, uint32_t periodMs);
+
+    void runOnce();  // Run every due task once, in registration order
+    void run();      // runOnce(), then sleep until the next due time
+
+    const TaskStats* getStats(int8_t id) const;
+    uint8_t getLoadPercent() const { return _loadPercent; }  // Busy share of the last stats window
+    void dumpStats();  // Print per-task stats to Serial
+
+private:
+    static const uint8_t MAX_TASKS = 12;
+    static const uint32_t MAX_SLEEP_MS = 1000;  // Idle cap when nothing is scheduled
+    static const uint32_t LOAD_WINDOW_US = 1000000;
+
+    struct Task {
+        const char* name;
+        TaskCallback callback;
+        void* context;
+        bool periodic;
+        bool enabled;
+        uint32_t periodUs;
+        uint32_t deadlineUs;
+        int64_t dueUs;               // Next run (periodic) or signal time / time to run (event)
+        bool signalled;              // Event tasks: dueUs and signalled are guarded by _signalLock
+        TaskStats stats;
+    };
+
+    Task _tasks[MAX_TASKS];
+    uint8_t _taskCount;
+    TaskHandle_t _owner;
+    portMUX_TYPE _signalLock;  // Signals arrive from other tasks and cores
+
+    // CPU load over a rolling one-second window
+    int64_t _windowStartUs;
+    uint32_t _windowSleepUs;
+    uint8_t _loadPercent;
+
+    int8_t addTask(const char* name, bool periodic, uint32_t periodMs, TaskCallback callback,
+                   void* context, uint32_t deadlineMs);
+    bool takeSignal(Task& task, int64_t now, int64_t& dueUs);
+    void runTask(Task& task, int64_t dueUs);
+    void sleepUntil(int64_t wakeUs);
+};
+
+#endif // SCHEDULER_H
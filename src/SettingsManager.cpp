@@ -0,0 +1,281 @@
+#include "SettingsManager.h"
+#include "StorageManager.h"
+#include <stddef.h>
+#include <esp_system.h>
+
+// The blob lives outside StorageManager's cached namespace; this class
+// already keeps the decoded copy in RAM
+static const char* SETTINGS_NS = "config";
+static const char* SETTINGS_KEY = "settings";
+
+// Byte range of each SettingsSection within SettingsData
+struct SectionRange {
+    uint8_t offset;
+    uint8_t size;
+};
+
+static const SectionRange SECTIONS[SETTINGS_SECTION_COUNT] = {
+    {offsetof(SettingsData, brightness), offsetof(SettingsData, utcOffsetMinutes) - offsetof(SettingsData, brightness)},
+    {offsetof(SettingsData, utcOffsetMinutes), offsetof(SettingsData, alarmCount) - offsetof(SettingsData, utcOffsetMinutes)},
+    {offsetof(SettingsData, alarmCount), sizeof(SettingsData) - offsetof(SettingsData, alarmCount)},
+};
+
+// Static member initialization
+SettingsManager* SettingsManager::_instance = nullptr;
+
+SettingsManager::SettingsManager()
+    : _dirtyMask(0),
+      _firstEditMs(0),
+      _lastEditMs(0),
+      _loadedVersion(0) {
+    getDefaults(_data);
+    _saved = _data;
+    memset(&_stats, 0, sizeof(_stats));
+    _instance = this;  // For the shutdown handler
+}
+
+SettingsManager::~SettingsManager() {
+    esp_unregister_shutdown_handler(shutdownHandler);
+    _instance = nullptr;
+}
+
+bool SettingsManager::begin() {
+    // Pending edits are written before esp_restart() reboots
+    esp_register_shutdown_handler(shutdownHandler);
+
+    uint8_t blob[MAX_BLOB_SIZE];
+    size_t length = StorageManager::loadBytes(SETTINGS_NS, SETTINGS_KEY, blob, sizeof(blob));
+
+    if (length == 0) {
+        Serial.println("Settings: none saved, using defaults");
+        getDefaults(_data);
+        _saved = _data;
+        _loadedVersion = 0;
+        _dirtyMask = 0;  // Nothing to write until something changes
+        return true;
+    }
+
+    BlobHeader header;
+    if (length < sizeof(header)) {
+        Serial.println("ERROR: Settings blob truncated, using defaults");
+        resetToDefaults();
+        return false;
+    }
+    memcpy(&header, blob, sizeof(header));
+
+    uint8_t* payload = blob + sizeof(header);
+    uint16_t payloadLength = header.length;
+
+    if (header.magic != MAGIC || payloadLength != length - sizeof(header)) {
+        Serial.println("ERROR: Settings blob header invalid, using defaults");
+        resetToDefaults();
+        return false;
+    }
+
+    if (crc32(payload, payloadLength) != header.crc) {
+        Serial.println("ERROR: Settings blob CRC mismatch, using defaults");
+        resetToDefaults();
+        return false;
+    }
+
+    if (header.version > SETTINGS_VERSION) {
+        // Written by newer firmware - don't guess at its layout
+        Serial.printf("ERROR: Settings version %u is newer than %u, using defaults\n",
+                      header.version, SETTINGS_VERSION);
+        resetToDefaults();
+        return false;
+    }
+
+    // Upgrade one version at a time
+    for (uint8_t version = header.version; version < SETTINGS_VERSION; version++) {
+        if (!migrate(version, payload, payloadLength)) {
+            Serial.printf("ERROR: No settings migration from version %u, using defaults\n", version);
+            resetToDefaults();
+            return false;
+        }
+        Serial.printf("Settings migrated from version %u to %u\n", version, version + 1);
+    }
+
+    if (payloadLength != sizeof(SettingsData)) {
+        Serial.println("ERROR: Settings payload size mismatch, using defaults");
+        resetToDefaults();
+        return false;
+    }
+
+    memcpy(&_data, payload, sizeof(_data));
+    _saved = _data;
+    _loadedVersion = header.version;
+    _dirtyMask = 0;
+
+    // Store the upgraded layout so the migration runs once
+    if (header.version != SETTINGS_VERSION) {
+        writeBlob();
+    }
+
+    Serial.printf("Settings loaded (version %u, %u bytes)\n", header.version, (unsigned)length);
+    return true;
+}
+
+void SettingsManager::update() {
+    if (!_dirtyMask) return;
+
+    uint32_t now = millis();
+    if (now - _lastEditMs >= IDLE_FLUSH_MS || now - _firstEditMs >= MAX_DEFER_MS) {
+        save();
+    }
+}
+
+bool SettingsManager::save() {
+    if (!_dirtyMask) return true;
+
+    // Edited back to what's already stored
+    if (memcmp(&_data, &_saved, sizeof(_data)) == 0) {
+        _stats.skippedFlushes++;
+        _dirtyMask = 0;
+        return true;
+    }
+
+    for (uint8_t i = 0; i < SETTINGS_SECTION_COUNT; i++) {
+        if (sectionChanged(i)) {
+            _stats.sectionWrites[i]++;
+        }
+    }
+
+    if (!writeBlob()) {
+        return false;  // Still dirty; the next update() retries
+    }
+
+    _dirtyMask = 0;
+    return true;
+}
+
+bool SettingsManager::writeBlob() {
+    uint8_t blob[sizeof(BlobHeader) + sizeof(SettingsData)];
+    BlobHeader header;
+    header.magic = MAGIC;
+    header.version = SETTINGS_VERSION;
+    header.reserved = 0;
+    header.length = sizeof(SettingsData);
+    header.crc = crc32((const uint8_t*)&_data, sizeof(_data));
+
+    memcpy(blob, &header, sizeof(header));
+    memcpy(blob + sizeof(header), &_data, sizeof(_data));
+
+    if (!StorageManager::saveBytes(SETTINGS_NS, SETTINGS_KEY, blob, sizeof(blob))) {
+        Serial.println("ERROR: Failed to save settings");
+        return false;
+    }
+
+    _saved = _data;
+    _stats.flushes++;
+    return true;
+}
+
+SettingsData& SettingsManager::edit(SettingsSection section) {
+    uint32_t now = millis();
+
+    _stats.edits++;
+    if (_dirtyMask) {
+        _stats.coalescedEdits++;
+    } else {
+        _firstEditMs = now;
+    }
+    _lastEditMs = now;
+    _dirtyMask |= 1 << section;
+
+    return _data;
+}
+
+void SettingsManager::resetToDefaults() {
+    getDefaults(_data);
+    _loadedVersion = 0;
+
+    // Written back by the next save(); a corrupt blob is replaced then
+    _dirtyMask = (1 << SETTINGS_SECTION_COUNT) - 1;
+    memset(&_saved, 0xFF, sizeof(_saved));
+    _firstEditMs = _lastEditMs = millis();
+}
+
+void SettingsManager::dumpStats() {
+    Serial.printf("Settings: %lu edits (%lu coalesced), %lu flushes, %lu skipped as unchanged%s\n",
+                  (unsigned long)_stats.edits, (unsigned long)_stats.coalescedEdits,
+                  (unsigned long)_stats.flushes, (unsigned long)_stats.skippedFlushes,
+                  _dirtyMask ? ", write pending" : "");
+    for (uint8_t i = 0; i < SETTINGS_SECTION_COUNT; i++) {
+        Serial.printf("  %-8s %lu writes\n", getSectionName((SettingsSection)i),
+                      (unsigned long)_stats.sectionWrites[i]);
+    }
+}
+
+const char* SettingsManager::getSectionName(SettingsSection section) {
+    switch (section) {
+        case SETTINGS_DISPLAY: return "display";
+        case SETTINGS_TIME: return "time";
+        case SETTINGS_ALARMS: return "alarms";
+        default: return "unknown";
+    }
+}
+
+void SettingsManager::getDefaults(SettingsData& data) {
+    memset(&data, 0, sizeof(data));
+
+    data.brightness = 255;
+    data.autoBrightness = 1;
+
+    // Dark room to daylight
+    static const BrightnessPoint DEFAULT_CURVE[BRIGHTNESS_CURVE_POINTS] = {
+        {0, 8}, {10, 32}, {50, 80}, {200, 150}, {1000, 220}, {5000, 255}
+    };
+    memcpy(data.brightnessCurve, DEFAULT_CURVE, sizeof(DEFAULT_CURVE));
+
+    data.use24Hour = 1;
+    data.showSeconds = 0;
+    data.theme = 0;
+
+    data.utcOffsetMinutes = 0;
+    data.observeDst = 0;
+
+    data.alarmCount = 0;
+    for (uint8_t i = 0; i < SETTINGS_MAX_ALARMS; i++) {
+        AlarmConfig& alarm = data.alarms[i];
+        alarm.hour = 7;
+        alarm.minute = 0;
+        alarm.days = 0x3E;  // Monday - Friday
+        alarm.volume = 70;
+        alarm.snoozeMinutes = 9;
+    }
+}
+
+// Upgrade a payload from `version` to `version + 1` in place (the buffer
+// holds MAX_BLOB_SIZE - sizeof(BlobHeader) bytes). When SETTINGS_VERSION is
+// bumped, add a case for the previous version here - e.g. insert the new
+// field's default and shift the rest of the payload up.
+bool SettingsManager::migrate(uint8_t version, uint8_t* payload, uint16_t& length) {
+    switch (version) {
+        default:
+            return false;
+    }
+}
+
+bool SettingsManager::sectionChanged(uint8_t section) const {
+    const SectionRange& range = SECTIONS[section];
+    return memcmp((const uint8_t*)&_data + range.offset, (const uint8_t*)&_saved + range.offset, range.size) != 0;
+}
+
+void SettingsManager::shutdownHandler() {
+    if (_instance && _instance->isDirty()) {
+        _instance->save();
+    }
+}
+
+// CRC-32 (IEEE 802.3, reflected), bitwise - the blob is small and read once
+uint32_t SettingsManager::crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
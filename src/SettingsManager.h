@@ -0,0 +1,136 @@
+#ifndef SETTINGS_MANAGER_H
+#define SETTINGS_MANAGER_H
+
+#include <Arduino.h>
+
+// Persisted configuration, stored as a single versioned NVS blob.
+//
+// Layout rules: fields are packed and fixed-size. Changing the layout means
+// bumping SETTINGS_VERSION and adding a migration step in SettingsManager.cpp
+// that turns the previous version's payload into the new one.
+static const uint8_t SETTINGS_VERSION = 1;
+static const uint8_t SETTINGS_MAX_ALARMS = 8;
+static const uint8_t BRIGHTNESS_CURVE_POINTS = 6;
+
+// Alarm flags
+static const uint8_t ALARM_ENABLED = 0x01;
+static const uint8_t ALARM_ONE_SHOT = 0x02;  // Disable after it fires
+
+struct __attribute__((packed)) AlarmConfig {
+    uint8_t hour;           // 0-23
+    uint8_t minute;         // 0-59
+    uint8_t days;           // Bit 0 = Sunday ... bit 6 = Saturday
+    uint8_t flags;          // ALARM_*
+    uint8_t tone;
+    uint8_t volume;         // 0-100
+    uint8_t snoozeMinutes;
+    uint8_t reserved;
+};
+
+// Ambient light to backlight mapping; points sorted by lux
+struct __attribute__((packed)) BrightnessPoint {
+    uint16_t lux;
+    uint8_t level;          // Backlight 0-255
+};
+
+struct __attribute__((packed)) SettingsData {
+    // Display
+    uint8_t brightness;     // Manual backlight level 0-255
+    uint8_t autoBrightness; // Follow the ambient light curve
+    BrightnessPoint brightnessCurve[BRIGHTNESS_CURVE_POINTS];
+    uint8_t use24Hour;
+    uint8_t showSeconds;
+    uint8_t theme;
+
+    // Time
+    int16_t utcOffsetMinutes;
+    uint8_t observeDst;
+
+    // Alarms
+    uint8_t alarmCount;
+    AlarmConfig alarms[SETTINGS_MAX_ALARMS];
+};
+
+// Groups of fields tracked separately for dirty state and write counts
+enum SettingsSection {
+    SETTINGS_DISPLAY,       // brightness ... theme
+    SETTINGS_TIME,          // utcOffsetMinutes, observeDst
+    SETTINGS_ALARMS,        // alarmCount, alarms
+    SETTINGS_SECTION_COUNT
+};
+
+struct SettingsStats {
+    uint32_t edits;                 // edit() calls
+    uint32_t coalescedEdits;        // Edits folded into an already pending write
+    uint32_t flushes;               // Blob writes to NVS
+    uint32_t skippedFlushes;        // Pending writes that ended up identical to flash
+    uint32_t sectionWrites[SETTINGS_SECTION_COUNT];  // Flushes that changed each section
+};
+
+// Loads and saves SettingsData as one CRC-protected blob: boot costs one
+// NVS read and every save one write, instead of a key per value.
+//
+// Edits are deferred: edit() marks a section dirty and update() writes the
+// blob once the settings have been left alone for IDLE_FLUSH_MS (or have
+// been pending for MAX_DEFER_MS), so dragging a slider costs one flash
+// write, taken while the user isn't touching anything. Call save() before
+// deep sleep; a restart via esp_restart() flushes automatically.
+class SettingsManager {
+public:
+    SettingsManager();
+    ~SettingsManager();
+
+    // Manager pattern
+    bool begin();   // Load, migrate older versions, fall back to defaults
+    void update();  // Deferred flush (call periodically)
+    bool save();    // Write now if anything changed since the last save
+
+    const SettingsData& get() const { return _data; }
+    SettingsData& edit(SettingsSection section);  // Marks the section dirty
+    void resetToDefaults();
+
+    bool isDirty() const { return _dirtyMask != 0; }
+    uint8_t getLoadedVersion() const { return _loadedVersion; }  // 0 = defaults
+
+    const SettingsStats& getStats() const { return _stats; }
+    void dumpStats();  // Print edit/flush counters to Serial
+
+    static void getDefaults(SettingsData& data);
+    static const char* getSectionName(SettingsSection section);
+
+private:
+    static const uint16_t MAGIC = 0x5354;  // "ST"
+
+    struct __attribute__((packed)) BlobHeader {
+        uint16_t magic;
+        uint8_t version;
+        uint8_t reserved;
+        uint16_t length;    // Payload bytes following the header
+        uint32_t crc;       // CRC-32 of the payload
+    };
+
+    // Big enough for the current payload and any older one being migrated
+    static const uint16_t MAX_BLOB_SIZE = sizeof(BlobHeader) + 256;
+    static_assert(sizeof(SettingsData) <= MAX_BLOB_SIZE - sizeof(BlobHeader), "SettingsData outgrew the blob buffer");
+
+    static const uint32_t IDLE_FLUSH_MS = 3000;   // Quiet time before writing
+    static const uint32_t MAX_DEFER_MS = 30000;   // Upper bound under constant edits
+
+    SettingsData _data;
+    SettingsData _saved;        // What flash holds (defaults if nothing saved)
+    uint8_t _dirtyMask;         // Bit per SettingsSection
+    uint32_t _firstEditMs;      // Start of the pending write
+    uint32_t _lastEditMs;
+    uint8_t _loadedVersion;
+    SettingsStats _stats;
+
+    bool writeBlob();
+    bool migrate(uint8_t version, uint8_t* payload, uint16_t& length);
+    bool sectionChanged(uint8_t section) const;
+    static uint32_t crc32(const uint8_t* data, size_t length);
+
+    static void shutdownHandler();
+    static SettingsManager* _instance;  // For the shutdown handler
+};
+
+#endif // SETTINGS_MANAGER_H
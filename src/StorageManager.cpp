@@ -1,28 +1,277 @@
 #include "StorageManager.h"
 
 // Static member definitions
+const char* StorageManager::CACHED_NAMESPACE = "wifi_config";
 const char* StorageManager::WIFI_NAMESPACE = "wifi_config";
 const char* StorageManager::KEY_SSID = "ssid";
 const char* StorageManager::KEY_PASSWORD = "password";
 const char* StorageManager::KEY_PROVISIONED = "provisioned";
+const char* StorageManager::KEY_FAST_CONNECT = "fast";
+
+StorageManager::CacheEntry StorageManager::_cache[MAX_CACHE_ENTRIES];
+uint8_t StorageManager::_cacheCount = 0;
+bool StorageManager::_cacheLoaded = false;
+bool StorageManager::_cacheComplete = false;
+StorageStats StorageManager::_stats = {};
+
+// Transactions
+
+NVSTransaction::NVSTransaction(const char* ns)
+    : _handle(0),
+      _open(false),
+      _cached(StorageManager::isCachedNamespace(ns)),
+      _failed(false),
+      _erased(false),
+      _staged(0),
+      _pendingCount(0) {
+    if (!StorageManager::openNamespace(ns, NVS_READWRITE, _handle)) {
+        Serial.printf("ERROR: Failed to open NVS namespace '%s' for writing\n", ns);
+        _failed = true;
+        return;
+    }
+    _open = true;
+}
 
-bool StorageManager::saveWiFiCredentials(const String& ssid, const String& password) {
-    Serial.println("StorageManager::saveWiFiCredentials()");
+NVSTransaction::~NVSTransaction() {
+    if (_open) {
+        nvs_close(_handle);
+    }
+}
+
+bool NVSTransaction::putString(const char* key, const char* value) {
+    return put(key, NVS_TYPE_STR, value, strlen(value) + 1);
+}
+
+bool NVSTransaction::putBool(const char* key, bool value) {
+    uint8_t stored = value ? 1 : 0;  // Same encoding as Preferences::putBool
+    return put(key, NVS_TYPE_U8, &stored, 1);
+}
+
+bool NVSTransaction::putUInt8(const char* key, uint8_t value) {
+    return put(key, NVS_TYPE_U8, &value, 1);
+}
+
+bool NVSTransaction::putBytes(const char* key, const void* value, size_t length) {
+    return put(key, NVS_TYPE_BLOB, value, length);
+}
+
+bool NVSTransaction::put(const char* key, nvs_type_t type, const void* value, size_t length) {
+    if (!_open) {
+        _failed = true;
+        return false;
+    }
+
+    // Unchanged settings never reach flash - unless this transaction has
+    // already staged their removal
+    if (_cached && !_erased && !isPendingRemoval(key)) {
+        const StorageManager::CacheEntry* entry = StorageManager::findCacheEntry(key);
+        if (entry && entry->type == type && entry->length == length &&
+            memcmp(entry->data, value, length) == 0) {
+            StorageManager::_stats.skippedWrites++;
+            return true;
+        }
+    }
 
-    Preferences prefs;
-    if (!prefs.begin(WIFI_NAMESPACE, false)) {  // false = read/write mode
-        Serial.println("ERROR: Failed to open NVS namespace for writing");
+    esp_err_t err;
+    switch (type) {
+        case NVS_TYPE_U8:
+            err = nvs_set_u8(_handle, key, *static_cast<const uint8_t*>(value));
+            break;
+        case NVS_TYPE_STR:
+            err = nvs_set_str(_handle, key, static_cast<const char*>(value));
+            break;
+        default:
+            err = nvs_set_blob(_handle, key, value, length);
+            break;
+    }
+
+    if (err != ESP_OK) {
+        Serial.printf("ERROR: NVS write of '%s' failed (%s)\n", key, esp_err_to_name(err));
+        _failed = true;
+        return false;
+    }
+
+    _staged++;
+    StorageManager::_stats.writes++;
+    if (_cached) addPending(key, type);
+    return true;
+}
+
+bool NVSTransaction::remove(const char* key) {
+    if (!_open) {
+        _failed = true;
+        return false;
+    }
+
+    esp_err_t err = nvs_erase_key(_handle, key);
+    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+        _failed = true;
         return false;
     }
 
-    // Save SSID and password
-    size_t ssidLen = prefs.putString(KEY_SSID, ssid);
-    size_t passLen = prefs.putString(KEY_PASSWORD, password);
-    prefs.putBool(KEY_PROVISIONED, true);
+    if (err == ESP_OK) _staged++;
+    if (_cached) addPending(key, NVS_TYPE_ANY);
+    return true;
+}
+
+bool NVSTransaction::eraseAll() {
+    if (!_open) {
+        _failed = true;
+        return false;
+    }
 
-    prefs.end();
+    if (nvs_erase_all(_handle) != ESP_OK) {
+        _failed = true;
+        return false;
+    }
 
-    if (ssidLen == 0 || passLen == 0) {
+    _staged++;
+    if (_cached) {
+        _erased = true;
+        _pendingCount = 0;  // Anything staged before is gone too
+    }
+    return true;
+}
+
+bool NVSTransaction::commit() {
+    if (!_open) return false;
+
+    if (_staged > 0) {
+        StorageManager::_stats.commits++;
+        if (nvs_commit(_handle) != ESP_OK) {
+            Serial.println("ERROR: NVS commit failed");
+            _failed = true;
+        }
+    }
+
+    if (_cached) {
+        if (_failed) {
+            dropPending();
+        } else {
+            applyPending();
+        }
+    }
+
+    nvs_close(_handle);
+    _open = false;
+    return !_failed;
+}
+
+void NVSTransaction::addPending(const char* key, nvs_type_t type) {
+    for (uint8_t i = 0; i < _pendingCount; i++) {
+        if (strcmp(_pending[i].key, key) == 0) {
+            _pending[i].type = type;
+            return;
+        }
+    }
+
+    if (_pendingCount >= MAX_PENDING) {
+        // No room to track it: forget the cached copy now and let reads of
+        // this key go to flash
+        StorageManager::cacheRemove(key);
+        StorageManager::_cacheComplete = false;
+        return;
+    }
+
+    PendingKey& pending = _pending[_pendingCount++];
+    strncpy(pending.key, key, sizeof(pending.key) - 1);
+    pending.key[sizeof(pending.key) - 1] = '\0';
+    pending.type = type;
+}
+
+bool NVSTransaction::isPendingRemoval(const char* key) const {
+    for (uint8_t i = 0; i < _pendingCount; i++) {
+        if (strcmp(_pending[i].key, key) == 0) return _pending[i].type == NVS_TYPE_ANY;
+    }
+    return false;
+}
+
+void NVSTransaction::applyPending() {
+    if (_erased) {
+        StorageManager::cacheClear();
+    }
+
+    // Read the committed values back through the still-open handle
+    for (uint8_t i = 0; i < _pendingCount; i++) {
+        const PendingKey& pending = _pending[i];
+        if (pending.type == NVS_TYPE_ANY) {
+            StorageManager::cacheRemove(pending.key);
+            continue;
+        }
+
+        uint8_t value[StorageManager::CACHE_VALUE_SIZE];
+        size_t length = sizeof(value);
+        if (StorageManager::readValue(_handle, pending.key, pending.type, value, length)) {
+            StorageManager::cacheStore(pending.key, pending.type, value, length);
+        } else {
+            StorageManager::cacheRemove(pending.key);  // Too large to mirror
+            StorageManager::_cacheComplete = false;
+        }
+    }
+    _pendingCount = 0;
+}
+
+void NVSTransaction::dropPending() {
+    // Flash may or may not hold the new values; make reads of them go there
+    if (_erased) {
+        StorageManager::cacheClear();
+        StorageManager::_cacheComplete = false;
+    }
+    for (uint8_t i = 0; i < _pendingCount; i++) {
+        StorageManager::cacheRemove(_pending[i].key);
+        StorageManager::_cacheComplete = false;
+    }
+    _pendingCount = 0;
+}
+
+// Namespace cache
+
+bool StorageManager::beginCache() {
+    cacheClear();
+    _cacheLoaded = false;
+
+    nvs_handle_t handle;
+    if (!openNamespace(CACHED_NAMESPACE, NVS_READONLY, handle)) {
+        // Namespace doesn't exist until the first write - nothing to load
+        _cacheLoaded = true;
+        _cacheComplete = true;
+        return true;
+    }
+
+    nvs_iterator_t it = nvs_entry_find(NVS_DEFAULT_PART_NAME, CACHED_NAMESPACE, NVS_TYPE_ANY);
+    while (it) {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+
+        uint8_t value[CACHE_VALUE_SIZE];
+        size_t length = sizeof(value);
+        if (_cacheCount < MAX_CACHE_ENTRIES && readValue(handle, info.key, info.type, value, length)) {
+            cacheStore(info.key, info.type, value, length);
+        } else {
+            // Too many keys, too large or a type we don't cache
+            _cacheComplete = false;
+        }
+        it = nvs_entry_next(it);
+    }
+    nvs_release_iterator(it);
+    nvs_close(handle);
+
+    _cacheLoaded = true;
+    Serial.printf("NVS cache: %u keys of '%s' loaded%s\n", _cacheCount, CACHED_NAMESPACE,
+                  _cacheComplete ? "" : " (partial)");
+    return true;
+}
+
+bool StorageManager::saveWiFiCredentials(const String& ssid, const String& password) {
+    Serial.println("StorageManager::saveWiFiCredentials()");
+
+    // One open, three keys, one commit
+    NVSTransaction tx(WIFI_NAMESPACE);
+    tx.putString(KEY_SSID, ssid.c_str());
+    tx.putString(KEY_PASSWORD, password.c_str());
+    tx.putBool(KEY_PROVISIONED, true);
+
+    if (!tx.commit()) {
         Serial.println("ERROR: Failed to write credentials to NVS");
         return false;
     }
@@ -36,24 +285,15 @@ bool StorageManager::saveWiFiCredentials(const String& ssid, const String& passw
 bool StorageManager::loadWiFiCredentials(String& ssid, String& password) {
     Serial.println("StorageManager::loadWiFiCredentials()");
 
-    Preferences prefs;
-    if (!prefs.begin(WIFI_NAMESPACE, true)) {  // true = read-only mode
-        Serial.println("ERROR: Failed to open NVS namespace for reading");
-        return false;
-    }
-
-    // Check if provisioned
-    if (!prefs.getBool(KEY_PROVISIONED, false)) {
+    // Served from the cache once it is loaded
+    if (!loadBool(WIFI_NAMESPACE, KEY_PROVISIONED, false)) {
         Serial.println("Device not provisioned");
-        prefs.end();
         return false;
     }
 
     // Load SSID and password
-    ssid = prefs.getString(KEY_SSID, "");
-    password = prefs.getString(KEY_PASSWORD, "");
-
-    prefs.end();
+    ssid = loadString(WIFI_NAMESPACE, KEY_SSID, "");
+    password = loadString(WIFI_NAMESPACE, KEY_PASSWORD, "");
 
     if (ssid.length() == 0) {
         Serial.println("ERROR: SSID not found or empty");
@@ -69,112 +309,247 @@ bool StorageManager::loadWiFiCredentials(String& ssid, String& password) {
 void StorageManager::clearWiFiCredentials() {
     Serial.println("StorageManager::clearWiFiCredentials()");
 
-    Preferences prefs;
-    if (!prefs.begin(WIFI_NAMESPACE, false)) {
-        Serial.println("ERROR: Failed to open NVS namespace for clearing");
+    NVSTransaction tx(WIFI_NAMESPACE);
+    tx.eraseAll();  // Clear all keys in namespace
+    if (!tx.commit()) {
+        Serial.println("ERROR: Failed to clear NVS namespace");
         return;
     }
 
-    prefs.clear();  // Clear all keys in namespace
-    prefs.end();
-
     Serial.println("WiFi credentials cleared");
 }
 
 bool StorageManager::isProvisioned() {
-    Preferences prefs;
-    if (!prefs.begin(WIFI_NAMESPACE, true)) {
-        return false;
-    }
-
-    bool provisioned = prefs.getBool(KEY_PROVISIONED, false);
-    prefs.end();
-
-    return provisioned;
+    return loadBool(WIFI_NAMESPACE, KEY_PROVISIONED, false);
 }
 
 void StorageManager::setProvisioned(bool provisioned) {
-    Preferences prefs;
-    if (!prefs.begin(WIFI_NAMESPACE, false)) {
-        Serial.println("ERROR: Failed to open NVS namespace");
+    if (!saveBool(WIFI_NAMESPACE, KEY_PROVISIONED, provisioned)) {
+        Serial.println("ERROR: Failed to write provisioned flag");
         return;
     }
 
-    prefs.putBool(KEY_PROVISIONED, provisioned);
-    prefs.end();
-
     Serial.printf("Provisioned flag set to: %d\n", provisioned);
 }
 
-// Generic NVS helpers
-bool StorageManager::saveString(const char* ns, const char* key, const String& value) {
-    Preferences prefs;
-    if (!prefs.begin(ns, false)) {
-        return false;
-    }
+bool StorageManager::saveWiFiFastConnect(const WiFiFastConnect& fast) {
+    return saveBytes(WIFI_NAMESPACE, KEY_FAST_CONNECT, &fast, sizeof(fast));
+}
 
-    size_t len = prefs.putString(key, value);
-    prefs.end();
+bool StorageManager::loadWiFiFastConnect(WiFiFastConnect& fast) {
+    return loadBytes(WIFI_NAMESPACE, KEY_FAST_CONNECT, &fast, sizeof(fast)) == sizeof(fast);
+}
 
-    return len > 0;
+// Generic NVS helpers
+bool StorageManager::saveString(const char* ns, const char* key, const String& value) {
+    NVSTransaction tx(ns);
+    tx.putString(key, value.c_str());
+    return tx.commit();
 }
 
 String StorageManager::loadString(const char* ns, const char* key, const String& defaultValue) {
-    Preferences prefs;
-    if (!prefs.begin(ns, true)) {
+    const CacheEntry* entry;
+    if (lookupCache(ns, key, NVS_TYPE_STR, entry)) {
+        return entry ? String((const char*)entry->data) : defaultValue;
+    }
+
+    nvs_handle_t handle;
+    if (!openNamespace(ns, NVS_READONLY, handle)) {
         return defaultValue;
     }
 
-    String value = prefs.getString(key, defaultValue);
-    prefs.end();
+    String value = readString(handle, key, defaultValue);
+    nvs_close(handle);
 
     return value;
 }
 
 bool StorageManager::saveBool(const char* ns, const char* key, bool value) {
-    Preferences prefs;
-    if (!prefs.begin(ns, false)) {
-        return false;
-    }
+    NVSTransaction tx(ns);
+    tx.putBool(key, value);
+    return tx.commit();
+}
 
-    size_t len = prefs.putBool(key, value);
-    prefs.end();
+bool StorageManager::loadBool(const char* ns, const char* key, bool defaultValue) {
+    return loadUInt8(ns, key, defaultValue ? 1 : 0) != 0;
+}
 
-    return len > 0;
+bool StorageManager::saveUInt8(const char* ns, const char* key, uint8_t value) {
+    NVSTransaction tx(ns);
+    tx.putUInt8(key, value);
+    return tx.commit();
 }
 
-bool StorageManager::loadBool(const char* ns, const char* key, bool defaultValue) {
-    Preferences prefs;
-    if (!prefs.begin(ns, true)) {
+uint8_t StorageManager::loadUInt8(const char* ns, const char* key, uint8_t defaultValue) {
+    const CacheEntry* entry;
+    if (lookupCache(ns, key, NVS_TYPE_U8, entry)) {
+        return entry ? entry->data[0] : defaultValue;
+    }
+
+    nvs_handle_t handle;
+    if (!openNamespace(ns, NVS_READONLY, handle)) {
         return defaultValue;
     }
 
-    bool value = prefs.getBool(key, defaultValue);
-    prefs.end();
+    uint8_t value = defaultValue;
+    _stats.cacheMisses++;
+    if (nvs_get_u8(handle, key, &value) != ESP_OK) {
+        value = defaultValue;
+    }
+    nvs_close(handle);
 
     return value;
 }
 
-bool StorageManager::saveUInt8(const char* ns, const char* key, uint8_t value) {
-    Preferences prefs;
-    if (!prefs.begin(ns, false)) {
-        return false;
+bool StorageManager::saveBytes(const char* ns, const char* key, const void* value, size_t length) {
+    NVSTransaction tx(ns);
+    tx.putBytes(key, value, length);
+    return tx.commit();
+}
+
+size_t StorageManager::loadBytes(const char* ns, const char* key, void* value, size_t maxLength) {
+    const CacheEntry* entry;
+    if (lookupCache(ns, key, NVS_TYPE_BLOB, entry)) {
+        if (!entry || entry->length > maxLength) return 0;
+        memcpy(value, entry->data, entry->length);
+        return entry->length;
+    }
+
+    nvs_handle_t handle;
+    if (!openNamespace(ns, NVS_READONLY, handle)) {
+        return 0;
     }
 
-    size_t len = prefs.putUChar(key, value);
-    prefs.end();
+    size_t length = maxLength;
+    _stats.cacheMisses++;
+    if (!readValue(handle, key, NVS_TYPE_BLOB, value, length)) {
+        length = 0;  // Missing, or larger than the buffer
+    }
+    nvs_close(handle);
 
-    return len > 0;
+    return length;
 }
 
-uint8_t StorageManager::loadUInt8(const char* ns, const char* key, uint8_t defaultValue) {
-    Preferences prefs;
-    if (!prefs.begin(ns, true)) {
+void StorageManager::dumpStats() {
+    Serial.printf("Storage: %lu opens, %lu commits, %lu writes (%lu skipped as unchanged)\n",
+                  (unsigned long)_stats.opens, (unsigned long)_stats.commits,
+                  (unsigned long)_stats.writes, (unsigned long)_stats.skippedWrites);
+    Serial.printf("  Cache ('%s'): %u/%u keys%s, %lu hits, %lu flash reads\n", CACHED_NAMESPACE,
+                  _cacheCount, MAX_CACHE_ENTRIES, _cacheComplete ? "" : " (partial)",
+                  (unsigned long)_stats.cacheHits, (unsigned long)_stats.cacheMisses);
+}
+
+// Internal helpers
+
+bool StorageManager::openNamespace(const char* ns, nvs_open_mode_t mode, nvs_handle_t& handle) {
+    _stats.opens++;
+    return nvs_open(ns, mode, &handle) == ESP_OK;
+}
+
+bool StorageManager::isCachedNamespace(const char* ns) {
+    return strcmp(ns, CACHED_NAMESPACE) == 0;
+}
+
+bool StorageManager::lookupCache(const char* ns, const char* key, nvs_type_t type, const CacheEntry*& entry) {
+    if (!_cacheLoaded || !isCachedNamespace(ns)) return false;
+
+    const CacheEntry* found = findCacheEntry(key);
+    if (!found && !_cacheComplete) return false;  // Might be one that didn't fit
+
+    entry = found && found->type == type ? found : nullptr;
+    _stats.cacheHits++;
+    return true;
+}
+
+StorageManager::CacheEntry* StorageManager::findCacheEntry(const char* key) {
+    for (uint8_t i = 0; i < _cacheCount; i++) {
+        if (strcmp(_cache[i].key, key) == 0) {
+            return &_cache[i];
+        }
+    }
+    return nullptr;
+}
+
+void StorageManager::cacheStore(const char* key, nvs_type_t type, const void* value, size_t length) {
+    CacheEntry* entry = findCacheEntry(key);
+
+    if (length > CACHE_VALUE_SIZE) {
+        // Too large to mirror - drop any stale copy and read it from flash
+        if (entry) cacheRemove(key);
+        _cacheComplete = false;
+        return;
+    }
+
+    if (!entry) {
+        if (_cacheCount >= MAX_CACHE_ENTRIES) {
+            _cacheComplete = false;
+            return;
+        }
+        entry = &_cache[_cacheCount++];
+        strncpy(entry->key, key, sizeof(entry->key) - 1);
+        entry->key[sizeof(entry->key) - 1] = '\0';
+    }
+
+    entry->type = type;
+    entry->length = length;
+    memcpy(entry->data, value, length);
+}
+
+void StorageManager::cacheRemove(const char* key) {
+    CacheEntry* entry = findCacheEntry(key);
+    if (!entry) return;
+
+    // Keep the array packed
+    CacheEntry* last = &_cache[_cacheCount - 1];
+    if (entry != last) {
+        *entry = *last;
+    }
+    _cacheCount--;
+}
+
+void StorageManager::cacheClear() {
+    _cacheCount = 0;
+    _cacheComplete = true;
+}
+
+bool StorageManager::readValue(nvs_handle_t handle, const char* key, nvs_type_t type, void* value, size_t& length) {
+    esp_err_t err;
+    switch (type) {
+        case NVS_TYPE_U8:
+            err = nvs_get_u8(handle, key, static_cast<uint8_t*>(value));
+            length = 1;
+            break;
+        case NVS_TYPE_STR:
+            err = nvs_get_str(handle, key, static_cast<char*>(value), &length);
+            break;
+        case NVS_TYPE_BLOB:
+            err = nvs_get_blob(handle, key, value, &length);
+            break;
+        default:
+            return false;
+    }
+    return err == ESP_OK;
+}
+
+String StorageManager::readString(nvs_handle_t handle, const char* key, const String& defaultValue) {
+    _stats.cacheMisses++;
+
+    size_t length = 0;
+    if (nvs_get_str(handle, key, nullptr, &length) != ESP_OK || length == 0) {
         return defaultValue;
     }
 
-    uint8_t value = prefs.getUChar(key, defaultValue);
-    prefs.end();
+    char* buffer = (char*)malloc(length);
+    if (!buffer) {
+        Serial.println("ERROR: Failed to allocate NVS string buffer");
+        return defaultValue;
+    }
+
+    String value = defaultValue;
+    if (nvs_get_str(handle, key, buffer, &length) == ESP_OK) {
+        value = buffer;
+    }
+    free(buffer);
 
     return value;
 }
@@ -2,31 +2,159 @@
 #define STORAGE_MANAGER_H
 
 #include <Arduino.h>
-#include <Preferences.h>
+#include <atomic>
+#include <nvs.h>
+
+// NVS traffic counters. Bumped from the UI and network tasks alike.
+struct StorageStats {
+    std::atomic<uint32_t> opens;          // Namespace opens (nvs_open)
+    std::atomic<uint32_t> commits;        // nvs_commit calls
+    std::atomic<uint32_t> writes;         // Keys written
+    std::atomic<uint32_t> skippedWrites;  // Writes dropped because the cached value was identical
+    std::atomic<uint32_t> cacheHits;      // Reads answered from RAM
+    std::atomic<uint32_t> cacheMisses;    // Reads that went to flash
+};
+
+// Last good association, used to skip the channel scan on the next
+// connect. Only valid for the network named in ssid. The IP fields describe
+// the current connection (WiFiRadio::getConnection) and are never stored:
+// the fast join still runs DHCP, so a lease that moved or expired while the
+// device was off can't leave it on a stale static address.
+struct WiFiFastConnect {
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t ip;            // IPv4 as in IPAddress
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+
+// Groups several writes to one namespace behind a single open and a single
+// commit. Writes to the cached namespace are skipped when the value is
+// unchanged, and reach the cache only once commit() has succeeded.
+//
+//   NVSTransaction tx(StorageManager::CACHED_NAMESPACE);
+//   tx.putString("ssid", ssid);
+//   tx.putBool("provisioned", true);
+//   tx.commit();
+//
+// Destroying an uncommitted transaction just closes the handle.
+class NVSTransaction {
+public:
+    explicit NVSTransaction(const char* ns);
+    ~NVSTransaction();
+
+    bool isOpen() const { return _open; }
+
+    bool putString(const char* key, const char* value);
+    bool putBool(const char* key, bool value);
+    bool putUInt8(const char* key, uint8_t value);
+    bool putBytes(const char* key, const void* value, size_t length);
+    bool remove(const char* key);
+    bool eraseAll();
+
+    bool commit();  // Closes the transaction; false if any step failed
+
+private:
+    static const uint8_t MAX_PENDING = 4;
+
+    // Cache updates held back until commit(); NVS_TYPE_ANY = removed
+    struct PendingKey {
+        char key[NVS_KEY_NAME_MAX_SIZE];
+        nvs_type_t type;
+    };
+
+    nvs_handle_t _handle;
+    bool _open;
+    bool _cached;   // Namespace is mirrored in the RAM cache
+    bool _failed;
+    bool _erased;   // eraseAll() staged
+    uint8_t _staged;
+    PendingKey _pending[MAX_PENDING];
+    uint8_t _pendingCount;
+
+    bool put(const char* key, nvs_type_t type, const void* value, size_t length);
+    void addPending(const char* key, nvs_type_t type);
+    bool isPendingRemoval(const char* key) const;
+    void applyPending();
+    void dropPending();
+};
 
 // Static utility class for NVS (Non-Volatile Storage) operations
 class StorageManager {
 public:
+    // The WiFi namespace: small keys read on every boot and reconnect.
+    // SettingsManager keeps its own decoded copy of the "config" blob, which
+    // is larger than a cache slot anyway.
+    static const char* CACHED_NAMESPACE;
+
+    // Load the cached namespace into RAM (call once at boot, before the
+    // network task starts); reads from it are served from RAM afterwards
+    static bool beginCache();
+
     // WiFi credentials management
     static bool saveWiFiCredentials(const String& ssid, const String& password);
     static bool loadWiFiCredentials(String& ssid, String& password);
     static void clearWiFiCredentials();
     static bool isProvisioned();
     static void setProvisioned(bool provisioned);
+    static bool saveWiFiFastConnect(const WiFiFastConnect& fast);
+    static bool loadWiFiFastConnect(WiFiFastConnect& fast);
 
-    // Generic NVS helpers for future use
+    // Generic NVS helpers for future use (one transaction per save)
     static bool saveString(const char* ns, const char* key, const String& value);
     static String loadString(const char* ns, const char* key, const String& defaultValue = "");
     static bool saveBool(const char* ns, const char* key, bool value);
     static bool loadBool(const char* ns, const char* key, bool defaultValue = false);
     static bool saveUInt8(const char* ns, const char* key, uint8_t value);
     static uint8_t loadUInt8(const char* ns, const char* key, uint8_t defaultValue = 0);
+    static bool saveBytes(const char* ns, const char* key, const void* value, size_t length);
+    static size_t loadBytes(const char* ns, const char* key, void* value, size_t maxLength);  // 0 if missing
+
+    static const StorageStats& getStats() { return _stats; }
+    static void dumpStats();  // Print counters and cache usage to Serial
 
 private:
+    friend class NVSTransaction;
+
     static const char* WIFI_NAMESPACE;
     static const char* KEY_SSID;
     static const char* KEY_PASSWORD;
     static const char* KEY_PROVISIONED;
+    static const char* KEY_FAST_CONNECT;
+
+    // Namespace cache - fixed RAM, no heap. Values longer than
+    // CACHE_VALUE_SIZE are not cached and always read from flash. Only the
+    // network task writes the cached namespace after boot.
+    static const uint8_t MAX_CACHE_ENTRIES = 24;
+    static const uint8_t CACHE_VALUE_SIZE = 64;
+
+    struct CacheEntry {
+        char key[NVS_KEY_NAME_MAX_SIZE];
+        nvs_type_t type;
+        uint8_t length;
+        uint8_t data[CACHE_VALUE_SIZE];
+    };
+
+    static CacheEntry _cache[MAX_CACHE_ENTRIES];
+    static uint8_t _cacheCount;
+    static bool _cacheLoaded;
+    static bool _cacheComplete;  // Every key fit, so a missing key really is absent
+    static StorageStats _stats;
+
+    static bool openNamespace(const char* ns, nvs_open_mode_t mode, nvs_handle_t& handle);
+    static bool isCachedNamespace(const char* ns);
+
+    // True when the cache can answer for ns/key; entry is null if the key
+    // doesn't exist (or holds another type)
+    static bool lookupCache(const char* ns, const char* key, nvs_type_t type, const CacheEntry*& entry);
+    static CacheEntry* findCacheEntry(const char* key);
+    static void cacheStore(const char* key, nvs_type_t type, const void* value, size_t length);
+    static void cacheRemove(const char* key);
+    static void cacheClear();
+    static bool readValue(nvs_handle_t handle, const char* key, nvs_type_t type, void* value, size_t& length);
+    static String readString(nvs_handle_t handle, const char* key, const String& defaultValue);
 };
 
 #endif // STORAGE_MANAGER_H
@@ -0,0 +1,213 @@
+#include "TimeManager.h"
+#include <WiFi.h>
+#include <esp_timer.h>
+
+TimeManager::TimeManager(LocalClock* clock)
+    : _clock(clock),
+      _server(nullptr),
+      _initialized(false),
+      _networkUp(false),
+      _syncPending(false),
+      _nextSyncUs(0),
+      _intervalS(MIN_INTERVAL_S),
+      _policy(nullptr),
+      _defaultPolicy(15000, 600000, 20),
+      _retries(0) {
+    _policy = &_defaultPolicy;
+    memset(&_metrics, 0, sizeof(_metrics));
+    _metrics.intervalS = _intervalS;
+}
+
+bool TimeManager::begin(const char* server) {
+    if (!_clock || !server) {
+        Serial.println("ERROR: TimeManager needs a clock and an NTP server");
+        return false;
+    }
+
+    _server = server;
+    _initialized = true;
+    Serial.printf("Time: NTP server %s\n", _server);
+    return true;
+}
+
+void TimeManager::update() {
+    if (!_initialized || !_networkUp) return;
+
+    if (_syncPending || esp_timer_get_time() >= _nextSyncUs) {
+        _syncPending = false;
+        sync();
+    }
+}
+
+void TimeManager::setNetworkAvailable(bool available) {
+    if (available && !_networkUp && _retries > 0) {
+        // The last attempt failed, most likely with the link - don't wait
+        // out the backoff now that it's back
+        _syncPending = true;
+    }
+    _networkUp = available;
+}
+
+void TimeManager::requestSync() {
+    _syncPending = true;
+}
+
+void TimeManager::setRetryPolicy(RetryPolicy* policy) {
+    _policy = policy ? policy : &_defaultPolicy;
+}
+
+void TimeManager::sync() {
+    int64_t utcUs, localUs;
+    uint32_t roundTripUs;
+
+    _metrics.requests++;
+    if (!query(utcUs, localUs, roundTripUs)) {
+        onFailed();
+        return;
+    }
+
+    _metrics.lastRoundTripMs = roundTripUs / 1000;
+    _metrics.maxRoundTripMs = max(_metrics.maxRoundTripMs, _metrics.lastRoundTripMs);
+
+    bool first = !_clock->isSynced();
+    int64_t offsetUs = _clock->applySample(utcUs, localUs, roundTripUs / 2);
+    if (first) {
+        Serial.printf("Time: synced to %lu UTC (round trip %lu ms)\n",
+                      (unsigned long)(utcUs / 1000000), (unsigned long)_metrics.lastRoundTripMs);
+    }
+    onSynced(first ? 0 : offsetUs);
+}
+
+// One SNTP exchange. On success utcUs is the true time at esp_timer reading
+// localUs (the reply's arrival), corrected for half the network delay.
+bool TimeManager::query(int64_t& utcUs, int64_t& localUs, uint32_t& roundTripUs) {
+    IPAddress address;
+    if (!WiFi.hostByName(_server, address)) {
+        Serial.printf("Time: can't resolve %s\n", _server);
+        return false;
+    }
+
+    if (!_udp.begin(0)) {
+        Serial.println("Time: no UDP socket");
+        return false;
+    }
+
+    uint8_t packet[NTP_PACKET_SIZE];
+    memset(packet, 0, sizeof(packet));
+    packet[0] = 0x23;  // LI 0, version 4, mode 3 (client)
+
+    // Send our own timer reading as the transmit timestamp; the server
+    // echoes it as the originate timestamp, which matches reply to request
+    int64_t sentUs = esp_timer_get_time();
+    memcpy(packet + 40, &sentUs, sizeof(sentUs));
+
+    _udp.beginPacket(address, NTP_PORT);
+    _udp.write(packet, sizeof(packet));
+    if (!_udp.endPacket()) {
+        _udp.stop();
+        Serial.println("Time: NTP request not sent");
+        return false;
+    }
+
+    // Poll at tick rate: the arrival time is the one local timestamp the
+    // sample depends on, so don't sleep longer than that between checks
+    int64_t deadlineUs = sentUs + (int64_t)MAX_ROUND_TRIP_MS * 1000;
+    bool received = false;
+    while (esp_timer_get_time() < deadlineUs) {
+        if (_udp.parsePacket() >= NTP_PACKET_SIZE) {
+            localUs = esp_timer_get_time();
+            _udp.read(packet, sizeof(packet));
+            if (memcmp(packet + 24, &sentUs, sizeof(sentUs)) == 0) {
+                received = true;
+                break;
+            }
+            // Late reply to an earlier request - keep waiting for ours
+        }
+        vTaskDelay(1);
+    }
+    _udp.stop();
+
+    if (!received) {
+        Serial.printf("Time: no reply from %s within %lu ms\n", _server, (unsigned long)MAX_ROUND_TRIP_MS);
+        return false;
+    }
+
+    uint8_t leap = packet[0] >> 6;
+    uint8_t mode = packet[0] & 0x07;
+    uint8_t stratum = packet[1];
+    if (mode != 4 || leap == 3 || stratum == 0 || stratum > 15) {
+        // Kiss-o'-death (stratum 0) or a server that isn't synchronized itself
+        Serial.printf("Time: unusable reply (mode %u, leap %u, stratum %u)\n", mode, leap, stratum);
+        return false;
+    }
+
+    int64_t receiveUs = ntpToUnixUs(packet + 32);   // Server got the request
+    int64_t transmitUs = ntpToUnixUs(packet + 40);  // Server sent the reply
+    int64_t delayUs = (localUs - sentUs) - (transmitUs - receiveUs);
+    if (delayUs < 0) delayUs = 0;
+
+    utcUs = transmitUs + delayUs / 2;
+    roundTripUs = (uint32_t)delayUs;
+    return true;
+}
+
+void TimeManager::onSynced(int64_t offsetUs) {
+    _retries = 0;
+    _metrics.syncs++;
+    _metrics.lastOffsetMs = (int32_t)(offsetUs / 1000);
+    uint32_t error = (uint32_t)abs(_metrics.lastOffsetMs);
+    _metrics.maxOffsetMs = max(_metrics.maxOffsetMs, (int32_t)error);
+
+    if (!_clock->hasDriftEstimate()) {
+        // Keep sampling at the shortest span that can measure drift
+        _intervalS = MIN_INTERVAL_S;
+    } else if (error < TARGET_ERROR_MS) {
+        _intervalS = min(_intervalS * 2, (uint32_t)MAX_INTERVAL_S);
+    } else if (error > TARGET_ERROR_MS * 4) {
+        _intervalS = max(_intervalS / 2, (uint32_t)MIN_INTERVAL_S);
+    }
+
+    _metrics.intervalS = _intervalS;
+    scheduleIn(_intervalS * 1000);
+}
+
+void TimeManager::onFailed() {
+    _metrics.failures++;
+    _retries++;
+
+    uint32_t delayMs;
+    if (!_policy->nextDelay(_retries, delayMs)) {
+        // Policy gave up - try again at the regular interval
+        _retries = 0;
+        delayMs = _intervalS * 1000;
+    }
+    Serial.printf("Time: sync failed, retrying in %lu s\n", (unsigned long)(delayMs / 1000));
+    scheduleIn(delayMs);
+}
+
+void TimeManager::scheduleIn(uint32_t delayMs) {
+    _nextSyncUs = esp_timer_get_time() + (int64_t)delayMs * 1000;
+}
+
+void TimeManager::dumpMetrics() {
+    Serial.printf("Time: %lu requests, %lu failed, %lu syncs, interval %lu s\n",
+                  (unsigned long)_metrics.requests, (unsigned long)_metrics.failures,
+                  (unsigned long)_metrics.syncs, (unsigned long)_metrics.intervalS);
+    Serial.printf("Time: round trip %lu ms (max %lu), offset %+ld ms (max %ld)\n",
+                  (unsigned long)_metrics.lastRoundTripMs, (unsigned long)_metrics.maxRoundTripMs,
+                  (long)_metrics.lastOffsetMs, (long)_metrics.maxOffsetMs);
+    if (_nextSyncUs > 0) {
+        int64_t dueS = _syncPending ? 0 : (_nextSyncUs - esp_timer_get_time()) / 1000000;
+        Serial.printf("Time: next sync in %lld s%s\n", (long long)max(dueS, (int64_t)0),
+                      _networkUp ? "" : " (waiting for WiFi)");
+    }
+    _clock->dump();
+}
+
+int64_t TimeManager::ntpToUnixUs(const uint8_t* timestamp) {
+    uint32_t seconds = ((uint32_t)timestamp[0] << 24) | ((uint32_t)timestamp[1] << 16) |
+                       ((uint32_t)timestamp[2] << 8) | timestamp[3];
+    uint32_t fraction = ((uint32_t)timestamp[4] << 24) | ((uint32_t)timestamp[5] << 16) |
+                        ((uint32_t)timestamp[6] << 8) | timestamp[7];
+    return ((int64_t)seconds - NTP_UNIX_OFFSET_S) * 1000000 + (((uint64_t)fraction * 1000000) >> 32);
+}
@@ -0,0 +1,85 @@
+#ifndef TIME_MANAGER_H
+#define TIME_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include "LocalClock.h"
+#include "RetryPolicy.h"
+
+struct TimeMetrics {
+    uint32_t requests;          // NTP queries sent
+    uint32_t failures;          // No usable reply (timeout, DNS, bad packet)
+    uint32_t syncs;             // Samples applied to the clock
+    uint32_t lastRoundTripMs;
+    uint32_t maxRoundTripMs;
+    int32_t lastOffsetMs;       // Clock error found by the last sync
+    int32_t maxOffsetMs;        // Largest |error| seen after the first sync
+    uint32_t intervalS;         // Current resync interval
+};
+
+// Keeps a LocalClock disciplined from NTP. Runs on the network task: it
+// syncs as soon as WiFi comes up, then resyncs on an interval that starts
+// at MIN_INTERVAL_S (long enough to measure drift) and doubles while the
+// clock holds within TARGET_ERROR_MS, up to MAX_INTERVAL_S. Failed queries
+// retry through a RetryPolicy until the next success.
+//
+// Queries are plain SNTP over WiFiUDP rather than NTPClient, which only
+// reports whole seconds and hides the round trip the drift model needs.
+class TimeManager {
+public:
+    static const uint32_t MIN_INTERVAL_S = LocalClock::MIN_DRIFT_SPAN_S;
+    static const uint32_t MAX_INTERVAL_S = 8 * 3600;
+    static const uint32_t TARGET_ERROR_MS = 50;       // Stretch the interval below this
+    static const uint32_t MAX_ROUND_TRIP_MS = 500;    // Slower replies are too vague to use
+
+    explicit TimeManager(LocalClock* clock);  // Clock must outlive the manager
+
+    // Manager pattern
+    bool begin(const char* server = "pool.ntp.org");
+    void update();  // Sync when due (call periodically, blocks for one query)
+
+    void setNetworkAvailable(bool available);  // Sync on the next update() after coming up
+    void requestSync();                         // Sync on the next update()
+
+    // Failed queries retry through this policy. Default: 15 s doubling to
+    // 10 min with 20% jitter. nullptr restores the default; the policy must
+    // outlive the manager.
+    void setRetryPolicy(RetryPolicy* policy);
+
+    LocalClock* getClock() const { return _clock; }
+
+    // Diagnostics
+    const TimeMetrics& getMetrics() const { return _metrics; }
+    void dumpMetrics();  // Print metrics and the clock model to Serial
+
+private:
+    static const uint16_t NTP_PORT = 123;
+    static const uint8_t NTP_PACKET_SIZE = 48;
+    static const uint32_t NTP_UNIX_OFFSET_S = 2208988800UL;  // 1900 to 1970
+
+    LocalClock* _clock;
+    WiFiUDP _udp;
+    const char* _server;
+
+    bool _initialized;
+    bool _networkUp;
+    bool _syncPending;          // Sync on the next update()
+    int64_t _nextSyncUs;        // esp_timer time of the next scheduled sync
+    uint32_t _intervalS;
+
+    RetryPolicy* _policy;
+    BackoffRetryPolicy _defaultPolicy;
+    uint16_t _retries;
+
+    TimeMetrics _metrics;
+
+    void sync();
+    bool query(int64_t& utcUs, int64_t& localUs, uint32_t& roundTripUs);
+    void onSynced(int64_t offsetUs);
+    void onFailed();
+    void scheduleIn(uint32_t delayMs);
+
+    static int64_t ntpToUnixUs(const uint8_t* timestamp);
+};
+
+#endif // TIME_MANAGER_H
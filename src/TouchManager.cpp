@@ -1,4 +1,5 @@
 #include "TouchManager.h"
+#include <esp_timer.h>
 
 // GT911 GPIO pins from CrowPanel hardware
 #define TOUCH_SDA     19
@@ -13,21 +14,46 @@ TouchManager::TouchManager()
       _touchCount(0),
       _currentlyTouched(false),
       _previouslyTouched(false),
-      _lastTouchTime(0),
-      _initialized(false) {
+      _rawTouched(false),
+      _lastEdgeUs(0),
+      _activeCount(0),
+      _initialized(false),
+      _mode(TOUCH_MODE_POLL),
+      _lastSampleUs(0),
+      _readCount(0),
+      _droppedSamples(0),
+      _busyReads(0),
+      _busLock(nullptr),
+      _sampleQueue(nullptr),
+      _readerTask(nullptr),
+      _irqTimestampUs(0) {
     // Initialize touch points
     for (int i = 0; i < 5; i++) {
         _touchPoints[i] = {0, 0, false, 0};
+        _activePoints[i] = {0, 0, false, 0};
     }
 }
 
 TouchManager::~TouchManager() {
+    if (_readerTask) {
+        detachInterrupt(digitalPinToInterrupt(TOUCH_INT));
+        vTaskDelete(_readerTask);
+        _readerTask = nullptr;
+    }
+    if (_sampleQueue) {
+        vQueueDelete(_sampleQueue);
+        _sampleQueue = nullptr;
+    }
     if (_touch) {
         delete _touch;
     }
+    if (_busLock) {
+        vSemaphoreDelete(_busLock);
+        _busLock = nullptr;
+    }
 }
 
-bool TouchManager::begin() {
+bool TouchManager::begin(TouchMode mode) {
     Serial.println("TouchManager::begin() - Starting initialization");
 
     if (_initialized) {
@@ -37,6 +63,7 @@ bool TouchManager::begin() {
 
     // Initialize I2C
     Wire.begin(TOUCH_SDA, TOUCH_SCL);
+    _busLock = xSemaphoreCreateMutex();
 
     // Create GT911 controller object
     Serial.println("Creating GT911 object...");
@@ -55,51 +82,218 @@ bool TouchManager::begin() {
     // Touch is 180 degrees off, so use ROTATION_INVERTED (1)
     _touch->setRotation(ROTATION_INVERTED);
 
+    // Interrupt mode needs the INT line (configured as input by the GT911
+    // reset sequence above); fall back to polling if the task can't start
+    _mode = TOUCH_MODE_POLL;
+    if (mode == TOUCH_MODE_INTERRUPT) {
+        if (startInterruptMode()) {
+            _mode = TOUCH_MODE_INTERRUPT;
+        } else {
+            Serial.println("WARNING: Touch interrupt mode unavailable, polling instead");
+        }
+    }
+
     Serial.println("TouchManager initialized successfully!");
+    Serial.printf("Touch mode: %s\n", _mode == TOUCH_MODE_INTERRUPT ? "interrupt" : "poll");
     Serial.printf("Touch resolution: %d x %d\n", TOUCH_WIDTH, TOUCH_HEIGHT);
 
     _initialized = true;
     return true;
 }
 
-void TouchManager::update() {
-    if (!_initialized || !_touch) return;
+bool TouchManager::startInterruptMode() {
+    _sampleQueue = xQueueCreate(SAMPLE_QUEUE_LENGTH, sizeof(TouchSample));
+    if (!_sampleQueue) {
+        Serial.println("ERROR: Failed to create touch sample queue");
+        return false;
+    }
+
+    // Reader runs above the Arduino loop task so I2C reads happen promptly
+    BaseType_t created = xTaskCreatePinnedToCore(readerTask, "touch_reader", 3072, this,
+                                                 configMAX_PRIORITIES - 5, &_readerTask, 1);
+    if (created != pdPASS) {
+        Serial.println("ERROR: Failed to create touch reader task");
+        vQueueDelete(_sampleQueue);
+        _sampleQueue = nullptr;
+        _readerTask = nullptr;
+        return false;
+    }
+
+    // GT911 INT polarity depends on the panel's config block, so wake on
+    // either edge; back-to-back notifications collapse into one read
+    attachInterruptArg(digitalPinToInterrupt(TOUCH_INT), touchISR, this, CHANGE);
+    return true;
+}
+
+void IRAM_ATTR TouchManager::touchISR(void* arg) {
+    TouchManager* self = static_cast<TouchManager*>(arg);
+    self->_irqTimestampUs = esp_timer_get_time();
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->_readerTask, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void TouchManager::readerTask(void* arg) {
+    TouchManager* self = static_cast<TouchManager*>(arg);
+    bool touched = false;
+    bool retry = false;         // INT fired but the bus was busy
+    int64_t timestampUs = 0;
+    TouchSample sample;
+
+    for (;;) {
+        // Idle: sleep until INT fires. Touched: also wake periodically so a
+        // lost release interrupt can't leave a finger stuck down.
+        TickType_t wait = retry ? pdMS_TO_TICKS(BUS_RETRY_MS)
+                        : touched ? pdMS_TO_TICKS(RELEASE_POLL_MS) : portMAX_DELAY;
+        uint32_t notified = ulTaskNotifyTake(pdTRUE, wait);
+        if (notified) {
+            timestampUs = self->_irqTimestampUs;
+        } else if (!retry) {
+            timestampUs = esp_timer_get_time();
+        }
+
+        // The data stays in the controller; keep the interrupt's timestamp
+        retry = !self->readController(sample);
+        if (retry) continue;
+
+        sample.timestampUs = timestampUs;
+        touched = sample.count > 0;
+
+        // Keep the newest data if update() has fallen behind
+        if (xQueueSend(self->_sampleQueue, &sample, 0) != pdTRUE) {
+            TouchSample discarded;
+            xQueueReceive(self->_sampleQueue, &discarded, 0);
+            xQueueSend(self->_sampleQueue, &sample, 0);
+            self->_droppedSamples++;
+        }
+    }
+}
 
-    // Read touch data
+bool TouchManager::readController(TouchSample& sample) {
+    if (!lockBus(pdMS_TO_TICKS(BUS_WAIT_MS))) {
+        _busyReads++;
+        return false;
+    }
     _touch->read();
+    unlockBus();
+    _readCount++;
+
+    sample.count = _touch->isTouched ? _touch->touches : 0;
+    if (sample.count > 5) sample.count = 5;
+
+    for (uint8_t i = 0; i < sample.count; i++) {
+        sample.points[i].x = _touch->points[i].x;
+        sample.points[i].y = _touch->points[i].y;
+        sample.points[i].pressed = true;
+        sample.points[i].id = _touch->points[i].id;  // Controller track id
+    }
+    return true;
+}
+
+void TouchManager::update() {
+    if (!_initialized || !_touch) return;
 
     // Store previous state
     _previouslyTouched = _currentlyTouched;
 
-    // Check if currently touched
-    _currentlyTouched = _touch->isTouched;
-    _touchCount = _touch->touches;
-
-    // Update touch points
-    if (_currentlyTouched && _touchCount > 0) {
-        // Debounce check
-        unsigned long now = millis();
-        if (now - _lastTouchTime < DEBOUNCE_MS) {
-            return;
-        }
-        _lastTouchTime = now;
-
-        // Read up to 5 touch points
-        for (uint8_t i = 0; i < _touchCount && i < 5; i++) {
-            _touchPoints[i].x = _touch->points[i].x;
-            _touchPoints[i].y = _touch->points[i].y;
-            _touchPoints[i].pressed = true;
-            _touchPoints[i].id = i;
+    if (_mode == TOUCH_MODE_INTERRUPT) {
+        // Drain everything the reader task queued since the last update
+        TouchSample sample;
+        while (xQueueReceive(_sampleQueue, &sample, 0) == pdTRUE) {
+            applySample(sample);
         }
     } else {
-        // No touch - clear all points
-        for (int i = 0; i < 5; i++) {
+        // A busy bus skips this poll; the next update() reads again
+        TouchSample sample;
+        if (readController(sample)) {
+            sample.timestampUs = esp_timer_get_time();
+            applySample(sample);
+        }
+    }
+
+    applyEdge(esp_timer_get_time());
+}
+
+void TouchManager::applySample(const TouchSample& sample) {
+    _lastSampleUs = sample.timestampUs;
+    emitEvents(sample);
+
+    _rawTouched = sample.count > 0;
+    _touchCount = sample.count;
+
+    // Always take the newest points; only the press/release edges are
+    // debounced (applyEdge), so a drag never reports stale coordinates
+    for (uint8_t i = 0; i < 5; i++) {
+        if (i < _touchCount) {
+            _touchPoints[i] = sample.points[i];
+        } else {
             _touchPoints[i].pressed = false;
         }
-        _touchCount = 0;
     }
 }
 
+void TouchManager::applyEdge(int64_t nowUs) {
+    // A change right after the last edge is held until the window is over
+    // and dropped if the contact bounced back; checked on every update(),
+    // so a release that arrives early is applied late rather than lost
+    if (_rawTouched == _currentlyTouched) return;
+    if (_lastEdgeUs && nowUs - _lastEdgeUs < (int64_t)DEBOUNCE_MS * 1000) return;
+
+    _currentlyTouched = _rawTouched;
+    _lastEdgeUs = nowUs;
+}
+
+void TouchManager::emitEvents(const TouchSample& sample) {
+    // Fingers that were down and are now missing have lifted
+    for (uint8_t i = 0; i < _activeCount; i++) {
+        bool present = false;
+        for (uint8_t j = 0; j < sample.count; j++) {
+            if (sample.points[j].id == _activePoints[i].id) {
+                present = true;
+                break;
+            }
+        }
+        if (!present) {
+            pushEvent(TOUCH_UP, _activePoints[i], sample.timestampUs);
+        }
+    }
+
+    // New ids are downs, known ids that moved are moves
+    for (uint8_t j = 0; j < sample.count; j++) {
+        const TouchPoint& p = sample.points[j];
+        const TouchPoint* prev = nullptr;
+        for (uint8_t i = 0; i < _activeCount; i++) {
+            if (_activePoints[i].id == p.id) {
+                prev = &_activePoints[i];
+                break;
+            }
+        }
+
+        if (!prev) {
+            pushEvent(TOUCH_DOWN, p, sample.timestampUs);
+        } else if (prev->x != p.x || prev->y != p.y) {
+            pushEvent(TOUCH_MOVE, p, sample.timestampUs);
+        }
+    }
+
+    _activeCount = sample.count;
+    for (uint8_t i = 0; i < sample.count; i++) {
+        _activePoints[i] = sample.points[i];
+    }
+}
+
+void TouchManager::pushEvent(TouchEventType type, const TouchPoint& point, int64_t timestampUs) {
+    TouchEvent event = {type, point.x, point.y, point.id, timestampUs};
+    _events.push(event);  // Counted as dropped if the consumer falls behind
+}
+
+bool TouchManager::pollEvent(TouchEvent& event) {
+    return _events.pop(event);
+}
+
 bool TouchManager::isTouched() const {
     return _currentlyTouched;
 }
@@ -128,3 +322,14 @@ bool TouchManager::wasReleased() {
 TAMC_GT911* TouchManager::getController() {
     return _touch;
 }
+
+bool TouchManager::lockBus(TickType_t wait) {
+    // No mutex before begin() (or on the host): nothing to contend with
+    return !_busLock || xSemaphoreTake(_busLock, wait) == pdTRUE;
+}
+
+void TouchManager::unlockBus() {
+    if (_busLock) {
+        xSemaphoreGive(_busLock);
+    }
+}
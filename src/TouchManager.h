@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <TAMC_GT911.h>
+#include "RingBuffer.h"
 
 // Touch event structure
 struct TouchPoint {
@@ -13,13 +14,42 @@ struct TouchPoint {
     uint8_t id;  // For multi-touch tracking
 };
 
+// Touch stream events
+enum TouchEventType {
+    TOUCH_DOWN,
+    TOUCH_MOVE,
+    TOUCH_UP
+};
+
+struct TouchEvent {
+    TouchEventType type;
+    int16_t x;
+    int16_t y;
+    uint8_t id;           // GT911 track id, stable for the life of a finger
+    int64_t timestampUs;  // When the controller reported it (esp_timer µs)
+};
+
+// Controller sampling mode
+enum TouchMode {
+    TOUCH_MODE_POLL,       // Read the GT911 over I2C on every update()
+    TOUCH_MODE_INTERRUPT   // Read only when the INT line signals new data
+};
+
+// One controller read, timestamped at the interrupt
+struct TouchSample {
+    int64_t timestampUs;
+    uint8_t count;
+    TouchPoint points[5];
+};
+
 class TouchManager {
 public:
     TouchManager();
     ~TouchManager();
 
     // Initialization
-    bool begin();
+    bool begin(TouchMode mode = TOUCH_MODE_INTERRUPT);
+    TouchMode getMode() const { return _mode; }
 
     // Touch reading
     void update();  // Call this in main loop
@@ -27,27 +57,77 @@ public:
     uint8_t getTouchCount() const;
     TouchPoint getTouch(uint8_t index = 0) const;
 
-    // Convenience methods
+    // Convenience methods. isTouched() and these edges are debounced; the
+    // points and the event stream always follow the newest sample.
     bool wasTouched();  // True once when first touched
     bool wasReleased(); // True once when released
 
+    // Event stream - every down/move/up in order, independent of loop timing.
+    // Pull with pollEvent() until it returns false.
+    bool pollEvent(TouchEvent& event);
+    uint32_t getDroppedEvents() const { return _events.getOverflowCount(); }
+
+    // Timing and bus statistics
+    int64_t getLastSampleTime() const { return _lastSampleUs; }  // esp_timer µs
+    uint32_t getReadCount() const { return _readCount; }          // I2C reads so far
+    uint32_t getDroppedSamples() const { return _droppedSamples; }
+    uint32_t getBusyReads() const { return _busyReads; }          // Reads put off by a busy bus
+
     // Raw GT911 access for advanced use
     TAMC_GT911* getController();
 
+    // The I2C bus is shared with other devices (the BH1750). Hold the lock
+    // around every transaction; wait = 0 tries without blocking, so a
+    // sensor read can be skipped rather than delay a touch read. Touch
+    // reads wait at most BUS_WAIT_MS and try again on the next poll.
+    bool lockBus(TickType_t wait = portMAX_DELAY);
+    void unlockBus();
+
 private:
     TAMC_GT911* _touch;
 
     // Touch state tracking
     TouchPoint _touchPoints[5];  // GT911 supports up to 5 points
     uint8_t _touchCount;
-    bool _currentlyTouched;
+    bool _currentlyTouched;     // Debounced
     bool _previouslyTouched;
+    bool _rawTouched;           // As of the newest sample
+    int64_t _lastEdgeUs;        // Last accepted press or release
+    static const uint32_t DEBOUNCE_MS = 50;  // Min time between press/release edges
 
-    // Debouncing
-    unsigned long _lastTouchTime;
-    static const unsigned long DEBOUNCE_MS = 50;
+    // Event stream state
+    static const uint16_t EVENT_QUEUE_SIZE = 32;
+    RingBuffer<TouchEvent, EVENT_QUEUE_SIZE> _events;
+    TouchPoint _activePoints[5];  // Fingers down as of the last sample
+    uint8_t _activeCount;
 
     bool _initialized;
+    TouchMode _mode;
+    int64_t _lastSampleUs;
+    volatile uint32_t _readCount;
+    volatile uint32_t _droppedSamples;
+    volatile uint32_t _busyReads;
+    SemaphoreHandle_t _busLock;
+    static const uint32_t BUS_WAIT_MS = 2;      // A BH1750 read takes well under this
+
+    // Interrupt mode: the ISR timestamps and wakes a reader task, which
+    // reads the controller and queues samples for update() to drain
+    QueueHandle_t _sampleQueue;
+    TaskHandle_t _readerTask;
+    volatile int64_t _irqTimestampUs;
+    static const uint8_t SAMPLE_QUEUE_LENGTH = 8;
+    static const uint32_t RELEASE_POLL_MS = 40;  // Re-read while touched in case INT is missed
+    static const uint32_t BUS_RETRY_MS = 5;      // Re-read after the bus was busy
+
+    bool startInterruptMode();
+    bool readController(TouchSample& sample);  // false if the bus stayed busy
+    void applySample(const TouchSample& sample);
+    void applyEdge(int64_t nowUs);
+    void emitEvents(const TouchSample& sample);
+    void pushEvent(TouchEventType type, const TouchPoint& point, int64_t timestampUs);
+
+    static void IRAM_ATTR touchISR(void* arg);
+    static void readerTask(void* arg);
 };
 
 #endif // TOUCH_MANAGER_H
@@ -15,12 +15,14 @@ Button::Button(int32_t x, int32_t y, int32_t w, int32_t h, const char* label)
 void Button::setLabel(const char* label) {
     strncpy(_label, label ? label : "", sizeof(_label) - 1);
     _label[sizeof(_label) - 1] = '\0';
+    _dirty = true;
 }
 
 void Button::setColors(uint32_t bgColor, uint32_t fgColor, uint32_t pressedColor) {
     _bgColor = bgColor;
     _fgColor = fgColor;
     _pressedColor = pressedColor;
+    _dirty = true;
 }
 
 void Button::draw(DisplayManager* display) {
@@ -37,16 +39,12 @@ void Button::draw(DisplayManager* display) {
         display->drawRect(_x, _y, _width, _height, _fgColor);
     }
 
-    // Draw label text (centered)
+    // Draw label text (centered, medium font) from the label cache
     if (strlen(_label) > 0) {
-        display->setTextColor(_fgColor);
-        display->setTextDatum(MC_DATUM);  // Middle-center
-        display->setTextFont(4);  // Medium font
-
         int32_t centerX = _x + _width / 2;
         int32_t centerY = _y + _height / 2;
 
-        display->drawString(_label, centerX, centerY);
+        display->drawCachedString(_label, centerX, centerY, 4, _fgColor, currentBgColor, MC_DATUM);
     }
 }
 
@@ -59,6 +57,9 @@ bool Button::onTouch(TouchPoint touch) {
     // Update pressed state
     _wasPressed = _pressed;
     _pressed = hit && touch.pressed;
+    if (_pressed != _wasPressed) {
+        _dirty = true;  // Pressed color changed
+    }
 
     if (_pressed && !_wasPressed) {
         Serial.printf("%d < %d < %d => %d\n", _x, touch.x, _x + _width, _pressed);
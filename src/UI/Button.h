@@ -21,7 +21,7 @@ public:
     void setCallback(ButtonCallback callback) { _callback = callback; }
 
     void setColors(uint32_t bgColor, uint32_t fgColor, uint32_t pressedColor);
-    void setRoundedCorners(int32_t radius) { _cornerRadius = radius; }
+    void setRoundedCorners(int32_t radius) { _cornerRadius = radius; _dirty = true; }
 
     bool isPressed() const { return _pressed; }
 
@@ -0,0 +1,155 @@
+#include "ClockFace.h"
+
+ClockFace::ClockFace(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t font)
+    : UIElement(x, y, w, h),
+      _font(font),
+      _fgColor(TFT_WHITE),
+      _bgColor(TFT_BLACK),
+      _use24Hour(true),
+      _showSeconds(false),
+      _hasTime(false),
+      _hour(0), _minute(0), _second(0),
+      _cellY(0),
+      _display(nullptr),
+      _digitSet(-1),
+      _layoutValid(false),
+      _cellsDrawn(0) {
+    memset(_cellX, 0, sizeof(_cellX));
+    formatText();
+    memcpy(_shown, _text, sizeof(_shown));
+}
+
+ClockFace::~ClockFace() {
+    releaseDigits();
+}
+
+void ClockFace::setTime(uint8_t hour, uint8_t minute, uint8_t second) {
+    _hasTime = true;
+    _hour = hour;
+    _minute = minute;
+    _second = second;
+    formatText();
+}
+
+void ClockFace::clearTime() {
+    _hasTime = false;
+    formatText();
+}
+
+void ClockFace::setFormat(bool use24Hour, bool showSeconds) {
+    if (use24Hour == _use24Hour && showSeconds == _showSeconds) return;
+
+    // Seconds change the cell count, so the face is laid out again
+    if (showSeconds != _showSeconds) {
+        _layoutValid = false;
+    }
+    _use24Hour = use24Hour;
+    _showSeconds = showSeconds;
+    formatText();
+    _dirty = true;
+}
+
+void ClockFace::setColors(uint32_t fgColor, uint32_t bgColor) {
+    if (fgColor == _fgColor && bgColor == _bgColor) return;
+    _fgColor = fgColor;
+    _bgColor = bgColor;
+    releaseDigits();  // Glyphs are pre-rendered in the old colors
+    _dirty = true;
+}
+
+void ClockFace::formatText() {
+    if (!_hasTime) {
+        strcpy(_text, _showSeconds ? "--:--:--" : "--:--");
+        return;
+    }
+
+    uint8_t hour = _hour;
+    if (!_use24Hour) {
+        hour = hour % 12;
+        if (hour == 0) hour = 12;
+    }
+
+    // 12-hour times keep a blank tens cell so the layout never shifts
+    const char* format = _use24Hour ? "%02u:%02u" : "%2u:%02u";
+    int n = snprintf(_text, sizeof(_text), format, (unsigned)hour, (unsigned)_minute);
+    if (_showSeconds && n > 0) {
+        snprintf(_text + n, sizeof(_text) - n, ":%02u", (unsigned)_second);
+    }
+}
+
+void ClockFace::releaseDigits() {
+    if (_display && _digitSet >= 0) {
+        _display->releaseDigitSet(_digitSet);
+    }
+    _digitSet = -1;
+    _layoutValid = false;
+}
+
+bool ClockFace::prepare(DisplayManager* display) {
+    if (_digitSet >= 0 && _layoutValid && display == _display) return true;
+
+    // Biggest integer scale of the font that fits the bounds
+    uint8_t cells = strlen(_text);
+    uint8_t colons = _showSeconds ? 2 : 1;
+    display->setTextFont(_font);
+    display->setTextSize(1);
+    int32_t digitWidth = 0;
+    char glyph[2] = {0, 0};
+    for (glyph[0] = '0'; glyph[0] <= '9'; glyph[0]++) {
+        digitWidth = max(digitWidth, (int32_t)display->textWidth(glyph));
+    }
+    int32_t baseWidth = digitWidth * (cells - colons) + display->textWidth(":") * colons;
+    int32_t baseHeight = display->fontHeight();
+    if (baseWidth <= 0 || baseHeight <= 0) return false;
+
+    int32_t scale = min(_width / baseWidth, _height / baseHeight);
+    scale = max((int32_t)1, min(scale, (int32_t)MAX_SCALE));
+
+    releaseDigits();
+    _display = display;
+    _digitSet = display->createDigitSet(_font, (uint8_t)scale, _fgColor, _bgColor);
+    if (_digitSet < 0) return false;
+
+    // Center the row of cells in the bounds
+    int32_t total = 0;
+    for (uint8_t i = 0; i < cells; i++) {
+        total += display->getDigitWidth(_digitSet, _text[i]);
+    }
+    int32_t x = _x + (_width - total) / 2;
+    for (uint8_t i = 0; i < cells; i++) {
+        _cellX[i] = x;
+        x += display->getDigitWidth(_digitSet, _text[i]);
+    }
+    _cellY = _y + (_height - display->getDigitHeight(_digitSet)) / 2;
+
+    _layoutValid = true;
+    return true;
+}
+
+void ClockFace::draw(DisplayManager* display) {
+    if (!_visible || !display) return;
+    if (!prepare(display)) return;
+
+    uint8_t cells = strlen(_text);
+    for (uint8_t i = 0; i < cells; i++) {
+        display->drawDigit(_digitSet, _text[i], _cellX[i], _cellY);
+    }
+    memcpy(_shown, _text, sizeof(_shown));
+}
+
+uint8_t ClockFace::renderChanged(DisplayManager* display) {
+    if (!_visible || !display || _dirty || !_layoutValid) return 0;
+
+    // Cells only ever swap glyphs of the same width (digits, dashes and
+    // blanks share one), so each change is an opaque overwrite
+    uint8_t drawn = 0;
+    uint8_t cells = strlen(_text);
+    for (uint8_t i = 0; i < cells; i++) {
+        if (_text[i] == _shown[i]) continue;
+        display->drawDigit(_digitSet, _text[i], _cellX[i], _cellY);
+        _shown[i] = _text[i];
+        drawn++;
+    }
+    _cellsDrawn += drawn;
+    return drawn;
+}
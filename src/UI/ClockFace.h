@@ -0,0 +1,61 @@
+#ifndef CLOCK_FACE_H
+#define CLOCK_FACE_H
+
+#include "UIElement.h"
+
+// Large digital time readout drawn from a DisplayManager digit set.
+// setTime() only records the new text; renderChanged() then blits just the
+// cells that differ from what is on screen - usually the last digit - so
+// the steady-state cost is one small sprite copy per second (or minute)
+// instead of repainting the whole face. Format and color changes
+// invalidate the element for a full redraw through its Screen.
+// Only the cells are painted, so bgColor should match the Screen's.
+class ClockFace : public UIElement {
+public:
+    static const uint8_t MAX_CELLS = 8;  // "HH:MM:SS"
+    static const uint8_t MAX_SCALE = 4;
+
+    ClockFace(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t font = 8);
+    ~ClockFace();
+
+    // UIElement interface
+    void draw(DisplayManager* display) override;   // Full redraw
+    bool onTouch(TouchPoint touch) override { return false; }
+
+    void setTime(uint8_t hour, uint8_t minute, uint8_t second);
+    void clearTime();  // Dashes until the time is known
+    void setFormat(bool use24Hour, bool showSeconds);
+    void setColors(uint32_t fgColor, uint32_t bgColor);
+
+    // Blit the cells that changed since the last draw. Returns the number
+    // drawn; 0 while a full redraw is pending.
+    uint8_t renderChanged(DisplayManager* display);
+
+    uint32_t getCellsDrawn() const { return _cellsDrawn; }  // Partial-update blits since boot
+
+private:
+    uint8_t _font;
+    uint32_t _fgColor;
+    uint32_t _bgColor;
+    bool _use24Hour;
+    bool _showSeconds;
+
+    bool _hasTime;
+    uint8_t _hour, _minute, _second;
+
+    char _text[MAX_CELLS + 1];   // What should be on screen
+    char _shown[MAX_CELLS + 1];  // What is on screen
+    int32_t _cellX[MAX_CELLS];
+    int32_t _cellY;
+
+    DisplayManager* _display;  // Owner of the digit set
+    int8_t _digitSet;
+    bool _layoutValid;
+    uint32_t _cellsDrawn;
+
+    void formatText();
+    void releaseDigits();
+    bool prepare(DisplayManager* display);
+};
+
+#endif // CLOCK_FACE_H
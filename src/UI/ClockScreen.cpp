@@ -0,0 +1,70 @@
+#include "ClockScreen.h"
+
+// Mockup colors (RGB888)
+static const uint32_t CLOCK_COLOR = 0x78D6FF;
+static const uint32_t DATE_COLOR = 0x8A93A3;
+
+static const char* const DAY_NAMES[] = {
+    "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"
+};
+static const char* const MONTH_NAMES[] = {
+    "January", "February", "March", "April", "May", "June",
+    "July", "August", "September", "October", "November", "December"
+};
+
+ClockScreen::ClockScreen()
+    : Screen(TFT_BLACK),
+      _lastTime(-1) {
+    _date[0] = '\0';
+
+    _face = new ClockFace(0, 60, 800, 340, 8);
+    _face->setColors(CLOCK_COLOR, getBackgroundColor());
+    _face->setEnabled(false);  // Display only - touches fall through to gestures
+    addChild(_face);
+}
+
+void ClockScreen::setTime(time_t localTime) {
+    if (localTime == _lastTime) return;
+    _lastTime = localTime;
+
+    struct tm fields;
+    gmtime_r(&localTime, &fields);
+    _face->setTime(fields.tm_hour, fields.tm_min, fields.tm_sec);
+
+    char date[sizeof(_date)];
+    snprintf(date, sizeof(date), "%s, %s %d", DAY_NAMES[fields.tm_wday], MONTH_NAMES[fields.tm_mon],
+             fields.tm_mday);
+    setDate(date);
+}
+
+void ClockScreen::clearTime() {
+    if (_lastTime == -1) return;
+    _lastTime = -1;
+    _face->clearTime();
+    setDate("");
+}
+
+void ClockScreen::setFormat(bool use24Hour, bool showSeconds) {
+    _face->setFormat(use24Hour, showSeconds);
+}
+
+void ClockScreen::setDate(const char* date) {
+    if (strcmp(date, _date) == 0) return;  // Once a day
+    strncpy(_date, date, sizeof(_date) - 1);
+    _date[sizeof(_date) - 1] = '\0';
+    invalidateRegion(0, DATE_Y, getWidth(), DATE_HEIGHT);
+}
+
+bool ClockScreen::update(DisplayManager* display) {
+    // Digits first: a repaint clipped to some other region (the date)
+    // redraws the face too, and would otherwise mark the changed cells as
+    // shown without them reaching the screen
+    bool drew = _face->renderChanged(display) > 0;
+    return render(display) || drew;
+}
+
+void ClockScreen::drawContent(DisplayManager* display, const DirtyRect& rect) {
+    if (_date[0] && intersects(rect, 0, DATE_Y, getWidth(), DATE_HEIGHT)) {
+        display->drawCachedString(_date, getWidth() / 2, DATE_Y, 4, DATE_COLOR, getBackgroundColor(), TC_DATUM);
+    }
+}
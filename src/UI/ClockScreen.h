@@ -0,0 +1,39 @@
+#ifndef CLOCK_SCREEN_H
+#define CLOCK_SCREEN_H
+
+#include <time.h>
+#include "Screen.h"
+#include "ClockFace.h"
+
+// Main clock screen (docs/mockups): large time readout with the date
+// underneath. Feed it the local time as often as convenient; only digits
+// and dates that actually changed reach the display.
+class ClockScreen : public Screen {
+public:
+    ClockScreen();
+
+    void setTime(time_t localTime);  // Seconds since the epoch, already in local time
+    void clearTime();                // Time unknown (not synced yet)
+    void setFormat(bool use24Hour, bool showSeconds);
+
+    // Per frame: changed clock digits, then anything else that's dirty.
+    // Returns true if anything was drawn.
+    bool update(DisplayManager* display);
+
+    ClockFace* getClockFace() const { return _face; }
+
+protected:
+    void drawContent(DisplayManager* display, const DirtyRect& rect) override;
+
+private:
+    static const int32_t DATE_Y = 420;
+    static const int32_t DATE_HEIGHT = 40;
+
+    ClockFace* _face;  // Owned by the Screen
+    time_t _lastTime;
+    char _date[32];
+
+    void setDate(const char* date);
+};
+
+#endif // CLOCK_SCREEN_H
@@ -0,0 +1,120 @@
+#include "HitGrid.h"
+
+HitGrid::HitGrid(int32_t width, int32_t height, int32_t cellSize)
+    : _width(width),
+      _height(height),
+      _cellSize(cellSize > 0 ? cellSize : 40),
+      _cellStart(nullptr),
+      _entries(nullptr),
+      _entryCount(0),
+      _elements(nullptr),
+      _elementCount(0) {
+    _cols = (_width + _cellSize - 1) / _cellSize;
+    _rows = (_height + _cellSize - 1) / _cellSize;
+}
+
+HitGrid::~HitGrid() {
+    clear();
+}
+
+void HitGrid::clear() {
+    if (_cellStart) {
+        delete[] _cellStart;
+        _cellStart = nullptr;
+    }
+    if (_entries) {
+        delete[] _entries;
+        _entries = nullptr;
+    }
+    _entryCount = 0;
+    _elements = nullptr;
+    _elementCount = 0;
+}
+
+bool HitGrid::cellRange(const UIElement* e, uint16_t& c0, uint16_t& r0, uint16_t& c1, uint16_t& r1) const {
+    int32_t x0 = max(e->getX(), (int32_t)0);
+    int32_t y0 = max(e->getY(), (int32_t)0);
+    int32_t x1 = min(e->getX() + e->getWidth(), _width) - 1;
+    int32_t y1 = min(e->getY() + e->getHeight(), _height) - 1;
+    if (x1 < x0 || y1 < y0) return false;
+
+    c0 = x0 / _cellSize;
+    r0 = y0 / _cellSize;
+    c1 = x1 / _cellSize;
+    r1 = y1 / _cellSize;
+    return true;
+}
+
+bool HitGrid::build(UIElement* const* elements, uint16_t count) {
+    clear();
+
+    uint32_t cellCount = (uint32_t)_cols * _rows;
+    _cellStart = new uint32_t[cellCount + 1];
+    if (!_cellStart) {
+        Serial.println("ERROR: Failed to allocate hit grid");
+        return false;
+    }
+    memset(_cellStart, 0, sizeof(uint32_t) * (cellCount + 1));
+
+    // Pass 1: count entries per cell
+    uint16_t c0, r0, c1, r1;
+    for (uint16_t i = 0; i < count; i++) {
+        if (!elements[i] || !cellRange(elements[i], c0, r0, c1, r1)) continue;
+        for (uint16_t r = r0; r <= r1; r++) {
+            for (uint16_t c = c0; c <= c1; c++) {
+                _cellStart[r * _cols + c + 1]++;
+            }
+        }
+    }
+
+    // Prefix sum into start offsets
+    for (uint32_t c = 0; c < cellCount; c++) {
+        _cellStart[c + 1] += _cellStart[c];
+    }
+    _entryCount = _cellStart[cellCount];
+
+    _entries = new uint16_t[_entryCount > 0 ? _entryCount : 1];
+    if (!_entries) {
+        Serial.println("ERROR: Failed to allocate hit grid entries");
+        clear();
+        return false;
+    }
+
+    // Pass 2: fill cells in element order so later elements sort last
+    uint32_t* fill = new uint32_t[cellCount];
+    if (!fill) {
+        clear();
+        return false;
+    }
+    memcpy(fill, _cellStart, sizeof(uint32_t) * cellCount);
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (!elements[i] || !cellRange(elements[i], c0, r0, c1, r1)) continue;
+        for (uint16_t r = r0; r <= r1; r++) {
+            for (uint16_t c = c0; c <= c1; c++) {
+                _entries[fill[r * _cols + c]++] = i;
+            }
+        }
+    }
+    delete[] fill;
+
+    _elements = elements;
+    _elementCount = count;
+    return true;
+}
+
+UIElement* HitGrid::hitTest(int32_t x, int32_t y) const {
+    if (!_cellStart) return nullptr;
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return nullptr;
+
+    uint32_t cell = (uint32_t)(y / _cellSize) * _cols + (x / _cellSize);
+
+    // Walk backwards so the topmost (last added) element wins
+    for (uint32_t i = _cellStart[cell + 1]; i > _cellStart[cell]; i--) {
+        UIElement* e = _elements[_entries[i - 1]];
+        if (e->hitTest(x, y)) {
+            return e;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,46 @@
+#ifndef HIT_GRID_H
+#define HIT_GRID_H
+
+#include "UIElement.h"
+
+// Uniform-grid spatial index over widget bounds for touch dispatch.
+// Each cell lists the elements overlapping it, so a lookup only hit-tests
+// the handful of widgets in one cell instead of walking every widget.
+// Rebuild after layout changes (see UIElement::layoutGeneration()).
+class HitGrid {
+public:
+    HitGrid(int32_t width = 800, int32_t height = 480, int32_t cellSize = 40);
+    ~HitGrid();
+
+    // Index elements by their current bounds. The array must outlive
+    // the index; a later index wins when elements overlap.
+    bool build(UIElement* const* elements, uint16_t count);
+    void clear();
+
+    // Topmost visible, enabled element containing (x, y), or nullptr
+    UIElement* hitTest(int32_t x, int32_t y) const;
+
+    bool isBuilt() const { return _cellStart != nullptr; }
+    uint32_t getEntryCount() const { return _entryCount; }  // Element-cell pairs
+
+private:
+    int32_t _width;
+    int32_t _height;
+    int32_t _cellSize;
+    uint16_t _cols;
+    uint16_t _rows;
+
+    // Compressed cell lists: entries for cell c are
+    // _entries[_cellStart[c] .. _cellStart[c + 1])
+    uint32_t* _cellStart;
+    uint16_t* _entries;
+    uint32_t _entryCount;
+
+    UIElement* const* _elements;
+    uint16_t _elementCount;
+
+    // Cell range covered by an element, false if fully off-grid
+    bool cellRange(const UIElement* e, uint16_t& c0, uint16_t& r0, uint16_t& c1, uint16_t& r1) const;
+};
+
+#endif // HIT_GRID_H
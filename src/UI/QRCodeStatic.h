@@ -0,0 +1,364 @@
+#ifndef QRCODE_STATIC_H
+#define QRCODE_STATIC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Compile-time QR encoder for constant payloads.
+//
+//   static constexpr auto CODE = QRCodeStatic::encode<6>("https://...");
+//
+// evaluates the whole encoder (byte mode, ECC low, best mask by penalty
+// score) in the compiler and leaves only the packed module bitmap in
+// flash. Modules are stored row-major, MSB first - the same packing the
+// QRCode library uses - so QRCodeWidget can draw either kind.
+//
+// Versions 1-6 (21x21 to 41x41 modules) are supported; larger versions
+// need the version information blocks, which aren't implemented.
+// Requires C++17 (relaxed constexpr with loops and local arrays).
+namespace QRCodeStatic {
+
+template<uint8_t VERSION>
+struct Bitmap {
+    static constexpr uint8_t SIZE = 17 + 4 * VERSION;
+    static constexpr uint16_t BYTES = (SIZE * SIZE + 7) / 8;
+
+    uint8_t modules[BYTES];
+
+    constexpr bool getModule(uint8_t x, uint8_t y) const {
+        uint16_t offset = y * SIZE + x;
+        return (modules[offset >> 3] >> (7 - (offset & 7))) & 1;
+    }
+};
+
+namespace detail {
+
+// ECC low block layout for versions 1-6 (all blocks are the same size)
+constexpr uint8_t TOTAL_CODEWORDS[7] = {0, 26, 44, 70, 100, 134, 172};
+constexpr uint8_t EC_PER_BLOCK[7]    = {0, 7, 10, 15, 20, 26, 18};
+constexpr uint8_t NUM_BLOCKS[7]      = {0, 1, 1, 1, 1, 1, 2};
+constexpr uint8_t ALIGNMENT_POS[7]   = {0, 0, 18, 22, 26, 30, 34};  // Second coordinate (first is 6)
+
+constexpr uint8_t gfMultiply(uint8_t a, uint8_t b) {
+    uint16_t result = 0;
+    for (int8_t i = 7; i >= 0; i--) {
+        result = (result << 1) ^ ((result >> 7) * 0x11D);
+        result ^= ((b >> i) & 1) * a;
+    }
+    return (uint8_t)result;
+}
+
+template<uint8_t VERSION>
+class Encoder {
+public:
+    static constexpr uint8_t SIZE = Bitmap<VERSION>::SIZE;
+    static constexpr uint8_t TOTAL = TOTAL_CODEWORDS[VERSION];
+    static constexpr uint8_t EC_LEN = EC_PER_BLOCK[VERSION];
+    static constexpr uint8_t BLOCKS = NUM_BLOCKS[VERSION];
+    static constexpr uint8_t DATA_PER_BLOCK = TOTAL / BLOCKS - EC_LEN;
+    static constexpr uint16_t DATA_CAPACITY = DATA_PER_BLOCK * BLOCKS;
+
+    constexpr Encoder() : _modules(), _function(), _codewords(), _data() {}
+
+    constexpr Bitmap<VERSION> encode(const char* text, size_t length) {
+        encodeData(text, length);
+        interleaveWithEcc();
+
+        drawFunctionPatterns();
+        placeCodewords();
+
+        // Pick the mask with the lowest penalty score
+        uint8_t bestMask = 0;
+        int32_t bestPenalty = INT32_MAX_VALUE;
+        for (uint8_t mask = 0; mask < 8; mask++) {
+            applyMask(mask);
+            drawFormatBits(mask);
+            int32_t penalty = penaltyScore();
+            if (penalty < bestPenalty) {
+                bestPenalty = penalty;
+                bestMask = mask;
+            }
+            applyMask(mask);  // XOR undoes it
+        }
+        applyMask(bestMask);
+        drawFormatBits(bestMask);
+
+        Bitmap<VERSION> bitmap = {};
+        for (uint16_t i = 0; i < SIZE * SIZE; i++) {
+            if (_modules[i]) {
+                bitmap.modules[i >> 3] |= 0x80 >> (i & 7);
+            }
+        }
+        return bitmap;
+    }
+
+private:
+    static constexpr int32_t INT32_MAX_VALUE = 0x7FFFFFFF;
+
+    bool _modules[SIZE * SIZE];
+    bool _function[SIZE * SIZE];
+    uint8_t _codewords[TOTAL];
+    uint8_t _data[DATA_CAPACITY];
+
+    constexpr bool get(int32_t x, int32_t y) const { return _modules[y * SIZE + x]; }
+
+    constexpr void setFunction(int32_t x, int32_t y, bool dark) {
+        _modules[y * SIZE + x] = dark;
+        _function[y * SIZE + x] = true;
+    }
+
+    // Byte mode segment, terminator and 0xEC/0x11 padding
+    constexpr void encodeData(const char* text, size_t length) {
+        uint16_t bit = 0;
+        auto append = [this, &bit](uint32_t value, uint8_t count) {
+            for (int8_t i = count - 1; i >= 0; i--, bit++) {
+                if ((value >> i) & 1) {
+                    _data[bit >> 3] |= 0x80 >> (bit & 7);
+                }
+            }
+        };
+
+        append(0x4, 4);  // Byte mode
+        append(length, 8);
+        for (size_t i = 0; i < length; i++) {
+            append((uint8_t)text[i], 8);
+        }
+
+        uint16_t capacityBits = DATA_CAPACITY * 8;
+        uint8_t terminator = capacityBits - bit < 4 ? capacityBits - bit : 4;
+        append(0, terminator);
+        append(0, (8 - bit % 8) % 8);
+
+        for (uint8_t pad = 0xEC; bit < capacityBits; pad ^= 0xEC ^ 0x11) {
+            append(pad, 8);
+        }
+    }
+
+    constexpr void interleaveWithEcc() {
+        // Reed-Solomon generator polynomial for EC_LEN codewords
+        uint8_t generator[EC_LEN] = {};
+        generator[EC_LEN - 1] = 1;
+        uint8_t root = 1;
+        for (uint8_t i = 0; i < EC_LEN; i++) {
+            for (uint8_t j = 0; j < EC_LEN; j++) {
+                generator[j] = gfMultiply(generator[j], root);
+                if (j + 1 < EC_LEN) generator[j] ^= generator[j + 1];
+            }
+            root = gfMultiply(root, 0x02);
+        }
+
+        uint8_t ecc[BLOCKS][EC_LEN] = {};
+        for (uint8_t b = 0; b < BLOCKS; b++) {
+            const uint8_t* block = _data + b * DATA_PER_BLOCK;
+            for (uint8_t i = 0; i < DATA_PER_BLOCK; i++) {
+                uint8_t factor = block[i] ^ ecc[b][0];
+                for (uint8_t j = 0; j + 1 < EC_LEN; j++) {
+                    ecc[b][j] = ecc[b][j + 1];
+                }
+                ecc[b][EC_LEN - 1] = 0;
+                for (uint8_t j = 0; j < EC_LEN; j++) {
+                    ecc[b][j] ^= gfMultiply(generator[j], factor);
+                }
+            }
+        }
+
+        uint16_t n = 0;
+        for (uint8_t i = 0; i < DATA_PER_BLOCK; i++) {
+            for (uint8_t b = 0; b < BLOCKS; b++) {
+                _codewords[n++] = _data[b * DATA_PER_BLOCK + i];
+            }
+        }
+        for (uint8_t i = 0; i < EC_LEN; i++) {
+            for (uint8_t b = 0; b < BLOCKS; b++) {
+                _codewords[n++] = ecc[b][i];
+            }
+        }
+    }
+
+    constexpr void drawFinder(int32_t cx, int32_t cy) {
+        for (int32_t dy = -4; dy <= 4; dy++) {
+            for (int32_t dx = -4; dx <= 4; dx++) {
+                int32_t x = cx + dx;
+                int32_t y = cy + dy;
+                if (x < 0 || x >= SIZE || y < 0 || y >= SIZE) continue;
+                int32_t adx = dx < 0 ? -dx : dx;
+                int32_t ady = dy < 0 ? -dy : dy;
+                int32_t dist = adx > ady ? adx : ady;
+                setFunction(x, y, dist != 2 && dist != 4);
+            }
+        }
+    }
+
+    constexpr void drawAlignment(int32_t cx, int32_t cy) {
+        for (int32_t dy = -2; dy <= 2; dy++) {
+            for (int32_t dx = -2; dx <= 2; dx++) {
+                int32_t adx = dx < 0 ? -dx : dx;
+                int32_t ady = dy < 0 ? -dy : dy;
+                setFunction(cx + dx, cy + dy, (adx > ady ? adx : ady) != 1);
+            }
+        }
+    }
+
+    constexpr void drawFunctionPatterns() {
+        for (int32_t i = 0; i < SIZE; i++) {
+            setFunction(6, i, i % 2 == 0);
+            setFunction(i, 6, i % 2 == 0);
+        }
+
+        drawFinder(3, 3);
+        drawFinder(SIZE - 4, 3);
+        drawFinder(3, SIZE - 4);
+
+        // Versions 2-6 have a single alignment pattern away from the finders
+        if (ALIGNMENT_POS[VERSION]) {
+            drawAlignment(ALIGNMENT_POS[VERSION], ALIGNMENT_POS[VERSION]);
+        }
+
+        drawFormatBits(0);  // Reserve the format areas
+    }
+
+    constexpr void drawFormatBits(uint8_t mask) {
+        uint16_t data = (1 << 3) | mask;  // ECC low = 01
+        uint16_t rem = data;
+        for (uint8_t i = 0; i < 10; i++) {
+            rem = (rem << 1) ^ ((rem >> 9) * 0x537);
+        }
+        uint16_t bits = ((data << 10) | rem) ^ 0x5412;
+
+        for (uint8_t i = 0; i <= 5; i++) setFunction(8, i, (bits >> i) & 1);
+        setFunction(8, 7, (bits >> 6) & 1);
+        setFunction(8, 8, (bits >> 7) & 1);
+        setFunction(7, 8, (bits >> 8) & 1);
+        for (uint8_t i = 9; i < 15; i++) setFunction(14 - i, 8, (bits >> i) & 1);
+
+        for (uint8_t i = 0; i < 8; i++) setFunction(SIZE - 1 - i, 8, (bits >> i) & 1);
+        for (uint8_t i = 8; i < 15; i++) setFunction(8, SIZE - 15 + i, (bits >> i) & 1);
+        setFunction(8, SIZE - 8, true);  // Dark module
+    }
+
+    // Zigzag through column pairs from the bottom right, skipping the
+    // vertical timing column
+    constexpr void placeCodewords() {
+        uint16_t i = 0;
+        for (int32_t right = SIZE - 1; right >= 1; right -= 2) {
+            if (right == 6) right = 5;
+            bool upward = ((right + 1) & 2) == 0;
+            for (int32_t vert = 0; vert < SIZE; vert++) {
+                for (int32_t j = 0; j < 2; j++) {
+                    int32_t x = right - j;
+                    int32_t y = upward ? SIZE - 1 - vert : vert;
+                    if (!_function[y * SIZE + x] && i < TOTAL * 8) {
+                        _modules[y * SIZE + x] = (_codewords[i >> 3] >> (7 - (i & 7))) & 1;
+                        i++;
+                    }
+                }
+            }
+        }
+    }
+
+    constexpr void applyMask(uint8_t mask) {
+        for (int32_t y = 0; y < SIZE; y++) {
+            for (int32_t x = 0; x < SIZE; x++) {
+                bool invert = false;
+                switch (mask) {
+                    case 0: invert = (x + y) % 2 == 0; break;
+                    case 1: invert = y % 2 == 0; break;
+                    case 2: invert = x % 3 == 0; break;
+                    case 3: invert = (x + y) % 3 == 0; break;
+                    case 4: invert = (x / 3 + y / 2) % 2 == 0; break;
+                    case 5: invert = x * y % 2 + x * y % 3 == 0; break;
+                    case 6: invert = (x * y % 2 + x * y % 3) % 2 == 0; break;
+                    default: invert = ((x + y) % 2 + x * y % 3) % 2 == 0; break;
+                }
+                if (invert && !_function[y * SIZE + x]) {
+                    _modules[y * SIZE + x] = !_modules[y * SIZE + x];
+                }
+            }
+        }
+    }
+
+    // Finder-like 1:1:3:1:1 run detection over the last seven runs
+    constexpr void addRunHistory(int32_t run, int32_t* history) const {
+        if (history[0] == 0) run += SIZE;  // Light border before the first run
+        for (uint8_t i = 6; i > 0; i--) history[i] = history[i - 1];
+        history[0] = run;
+    }
+
+    constexpr int32_t countFinderPatterns(const int32_t* history) const {
+        int32_t n = history[1];
+        bool core = n > 0 && history[2] == n && history[3] == n * 3 &&
+                    history[4] == n && history[5] == n;
+        return (core && history[0] >= n * 4 && history[6] >= n ? 1 : 0) +
+               (core && history[6] >= n * 4 && history[0] >= n ? 1 : 0);
+    }
+
+    constexpr int32_t terminateRuns(bool runColor, int32_t run, int32_t* history) const {
+        if (runColor) {
+            addRunHistory(run, history);
+            run = 0;
+        }
+        addRunHistory(run + SIZE, history);  // Light border after the last run
+        return countFinderPatterns(history);
+    }
+
+    constexpr int32_t linePenalty(bool columns) const {
+        int32_t result = 0;
+        for (int32_t a = 0; a < SIZE; a++) {
+            bool runColor = false;
+            int32_t run = 0;
+            int32_t history[7] = {};
+            for (int32_t b = 0; b < SIZE; b++) {
+                bool dark = columns ? get(a, b) : get(b, a);
+                if (dark == runColor) {
+                    run++;
+                    if (run == 5) result += 3;
+                    else if (run > 5) result++;
+                } else {
+                    addRunHistory(run, history);
+                    if (!runColor) result += countFinderPatterns(history) * 40;
+                    runColor = dark;
+                    run = 1;
+                }
+            }
+            result += terminateRuns(runColor, run, history) * 40;
+        }
+        return result;
+    }
+
+    constexpr int32_t penaltyScore() const {
+        int32_t result = linePenalty(false) + linePenalty(true);
+
+        int32_t dark = 0;
+        for (int32_t y = 0; y < SIZE; y++) {
+            for (int32_t x = 0; x < SIZE; x++) {
+                bool color = get(x, y);
+                if (color) dark++;
+                if (x + 1 < SIZE && y + 1 < SIZE && color == get(x + 1, y) &&
+                    color == get(x, y + 1) && color == get(x + 1, y + 1)) {
+                    result += 3;
+                }
+            }
+        }
+
+        int32_t total = SIZE * SIZE;
+        int32_t imbalance = dark * 20 - total * 10;
+        if (imbalance < 0) imbalance = -imbalance;
+        result += ((imbalance + total - 1) / total - 1) * 10;
+
+        return result;
+    }
+};
+
+} // namespace detail
+
+template<uint8_t VERSION, size_t N>
+constexpr Bitmap<VERSION> encode(const char (&text)[N]) {
+    static_assert(VERSION >= 1 && VERSION <= 6, "QRCodeStatic supports versions 1-6");
+    static_assert(N - 1 + 2 <= detail::Encoder<VERSION>::DATA_CAPACITY,
+                  "Text too long for this QR version");
+    return detail::Encoder<VERSION>().encode(text, N - 1);
+}
+
+} // namespace QRCodeStatic
+
+#endif // QRCODE_STATIC_H
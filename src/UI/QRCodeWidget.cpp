@@ -7,19 +7,16 @@ QRCodeWidget::QRCodeWidget(int32_t x, int32_t y, int32_t size)
       _fgColor(TFT_BLACK),
       _bgColor(TFT_WHITE),
       _generated(false),
-      _version(6) {  // Version 6 = 41x41 modules, good for ~70 chars
-
-    // Allocate buffer for QR code data
-    // Buffer size formula: qrcode_getBufferSize(version)
-    uint16_t bufferSize = qrcode_getBufferSize(_version);
-    _qrcodeData = new uint8_t[bufferSize];
-
-    if (!_qrcodeData) {
-        Serial.println("ERROR: Failed to allocate QR code buffer");
-    }
+      _version(6),
+      _bitmap(nullptr) {  // Version 6 = 41x41 modules, good for ~70 chars
+    memset(&_qrcode, 0, sizeof(_qrcode));
 }
 
 QRCodeWidget::~QRCodeWidget() {
+    if (_bitmap) {
+        free(_bitmap);
+        _bitmap = nullptr;
+    }
     if (_qrcodeData) {
         delete[] _qrcodeData;
         _qrcodeData = nullptr;
@@ -28,8 +25,12 @@ QRCodeWidget::~QRCodeWidget() {
 
 bool QRCodeWidget::generate(const char* text) {
     if (!_qrcodeData) {
-        Serial.println("ERROR: QR code buffer not allocated");
-        return false;
+        // Buffer size formula: qrcode_getBufferSize(version)
+        _qrcodeData = new uint8_t[qrcode_getBufferSize(_version)];
+        if (!_qrcodeData) {
+            Serial.println("ERROR: Failed to allocate QR code buffer");
+            return false;
+        }
     }
 
     Serial.printf("Generating QR code for text (length %d)\n", strlen(text));
@@ -46,18 +47,82 @@ bool QRCodeWidget::generate(const char* text) {
     Serial.printf("QR code generated successfully - Size: %dx%d\n", _qrcode.size, _qrcode.size);
     _generated = true;
 
+    rasterize();
+    _dirty = true;
+
+    return true;
+}
+
+bool QRCodeWidget::setModules(const uint8_t* modules, uint8_t size) {
+    if (!modules || size == 0) {
+        Serial.println("ERROR: Invalid QR code modules");
+        return false;
+    }
+
+    // Static bitmaps use the library's packing, so qrcode_getModule() reads
+    // them in place; the modules are never written through this pointer
+    _qrcode.version = (size - 17) / 4;
+    _qrcode.size = size;
+    _qrcode.modules = const_cast<uint8_t*>(modules);
+    _generated = true;
+
+    rasterize();
+    _dirty = true;
+
     return true;
 }
 
 void QRCodeWidget::setScale(uint8_t scale) {
-    if (scale >= 1 && scale <= 10) {
+    if (scale >= 1 && scale <= 10 && scale != _scale) {
         _scale = scale;
+        rasterize();
+        _dirty = true;
     }
 }
 
 void QRCodeWidget::setColors(uint32_t fg, uint32_t bg) {
     _fgColor = fg;
     _bgColor = bg;
+    rasterize();
+    _dirty = true;
+}
+
+void QRCodeWidget::rasterize() {
+    if (!_generated) return;
+
+    if (!_bitmap) {
+        size_t bytes = (size_t)_width * _height * sizeof(uint16_t);
+        _bitmap = (uint16_t*)(psramFound() ? ps_malloc(bytes) : malloc(bytes));
+        if (!_bitmap) {
+            Serial.println("ERROR: Failed to allocate QR code bitmap, drawing per run");
+            return;
+        }
+    }
+
+    uint16_t fg = DisplayManager::color565(_fgColor);
+    uint16_t bg = DisplayManager::color565(_bgColor);
+
+    int32_t qrPixelSize = _qrcode.size * _scale;
+    int32_t offsetX = (_width - qrPixelSize) / 2;
+    int32_t offsetY = (_height - qrPixelSize) / 2;
+
+    for (int32_t py = 0; py < _height; py++) {
+        uint16_t* row = _bitmap + py * _width;
+        int32_t my = py - offsetY;
+
+        if (my < 0 || my >= qrPixelSize) {
+            for (int32_t px = 0; px < _width; px++) row[px] = bg;
+            continue;
+        }
+
+        uint8_t moduleY = my / _scale;
+        for (int32_t px = 0; px < _width; px++) {
+            int32_t mx = px - offsetX;
+            bool dark = mx >= 0 && mx < qrPixelSize &&
+                        qrcode_getModule(&_qrcode, mx / _scale, moduleY);
+            row[px] = dark ? fg : bg;
+        }
+    }
 }
 
 void QRCodeWidget::draw(DisplayManager* display) {
@@ -65,6 +130,14 @@ void QRCodeWidget::draw(DisplayManager* display) {
         return;
     }
 
+    if (_bitmap) {
+        display->pushImageRGB565(_x, _y, _width, _height, _bitmap);
+    } else {
+        drawModuleRuns(display);
+    }
+}
+
+void QRCodeWidget::drawModuleRuns(DisplayManager* display) {
     // Draw white background for QR code area
     display->fillRect(_x, _y, _width, _height, _bgColor);
 
@@ -75,16 +148,22 @@ void QRCodeWidget::draw(DisplayManager* display) {
     int32_t offsetX = _x + (_width - qrPixelSize) / 2;
     int32_t offsetY = _y + (_height - qrPixelSize) / 2;
 
-    // Iterate through QR code modules and draw
+    // Merge horizontal runs of dark modules into one rectangle each
     for (uint8_t y = 0; y < _qrcode.size; y++) {
-        for (uint8_t x = 0; x < _qrcode.size; x++) {
-            // Check if this module is dark (true = black module)
-            if (qrcode_getModule(&_qrcode, x, y)) {
-                // Draw scaled rectangle for this module
-                int32_t px = offsetX + (x * _scale);
-                int32_t py = offsetY + (y * _scale);
-                display->fillRect(px, py, _scale, _scale, _fgColor);
+        uint8_t x = 0;
+        while (x < _qrcode.size) {
+            if (!qrcode_getModule(&_qrcode, x, y)) {
+                x++;
+                continue;
+            }
+
+            uint8_t start = x;
+            while (x < _qrcode.size && qrcode_getModule(&_qrcode, x, y)) {
+                x++;
             }
+
+            display->fillRect(offsetX + start * _scale, offsetY + y * _scale,
+                              (x - start) * _scale, _scale, _fgColor);
         }
     }
 }
@@ -2,9 +2,12 @@
 #define QRCODE_WIDGET_H
 
 #include "UIElement.h"
+#include "QRCodeStatic.h"
 #include <qrcode.h>
 
 // QR Code display widget
+// The code is rasterized once (on generate, or when scale/colors change)
+// into an RGB565 bitmap in PSRAM so draw() is a single blit.
 class QRCodeWidget : public UIElement {
 public:
     QRCodeWidget(int32_t x, int32_t y, int32_t size);
@@ -15,18 +18,30 @@ public:
     bool onTouch(TouchPoint touch) override;  // No-op for QR codes
 
     // QR code specific
-    bool generate(const char* text);
+    bool generate(const char* text);  // Runtime encoder, for dynamic payloads
+
+    // Show a code encoded at build time (see QRCodeStatic.h)
+    template<uint8_t VERSION>
+    bool generate(const QRCodeStatic::Bitmap<VERSION>& code) {
+        return setModules(code.modules, code.SIZE);
+    }
+    bool setModules(const uint8_t* modules, uint8_t size);
+
     void setScale(uint8_t scale);  // Pixel multiplier (1-10), default 4
     void setColors(uint32_t fg, uint32_t bg);
 
 private:
+    void rasterize();
+    void drawModuleRuns(DisplayManager* display);  // Fallback without a bitmap
+
     QRCode _qrcode;
-    uint8_t* _qrcodeData;
+    uint8_t* _qrcodeData;  // Encoder buffer, allocated on first runtime generate()
     uint8_t _scale;
     uint32_t _fgColor;
     uint32_t _bgColor;
     bool _generated;
     uint8_t _version;  // QR code version (determines size)
+    uint16_t* _bitmap; // Widget-sized RGB565 raster, nullptr if unavailable
 };
 
 #endif // QRCODE_WIDGET_H
@@ -0,0 +1,163 @@
+#include "Screen.h"
+
+Screen::Screen(uint32_t bgColor)
+    : UIElement(0, 0, 800, 480),  // Full screen
+      _childCount(0),
+      _regionCount(0),
+      _bgColor(bgColor),
+      _hitGridGeneration(0),
+      _hitGridValid(false),
+      _activeChild(nullptr) {
+    for (uint8_t i = 0; i < MAX_CHILDREN; i++) {
+        _children[i] = nullptr;
+        _drawnBounds[i] = {0, 0, 0, 0};
+    }
+}
+
+Screen::~Screen() {
+    for (uint8_t i = 0; i < _childCount; i++) {
+        delete _children[i];
+        _children[i] = nullptr;
+    }
+}
+
+bool Screen::addChild(UIElement* child) {
+    if (!child) return false;
+
+    if (_childCount >= MAX_CHILDREN) {
+        Serial.println("ERROR: Screen child limit reached");
+        return false;
+    }
+
+    _children[_childCount] = child;
+    _drawnBounds[_childCount] = {0, 0, 0, 0};
+    _childCount++;
+    _hitGridValid = false;
+
+    child->invalidate();
+    return true;
+}
+
+UIElement* Screen::getChild(uint8_t index) const {
+    if (index < _childCount) {
+        return _children[index];
+    }
+    return nullptr;
+}
+
+void Screen::invalidateRegion(int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (_regionCount >= MAX_REGIONS) {
+        // Too many pending regions - fall back to a full repaint
+        _dirty = true;
+        return;
+    }
+    _regions[_regionCount++] = {x, y, w, h};
+}
+
+void Screen::setBackgroundColor(uint32_t color) {
+    _bgColor = color;
+    _dirty = true;
+}
+
+void Screen::draw(DisplayManager* display) {
+    _dirty = true;
+    render(display);
+}
+
+bool Screen::render(DisplayManager* display) {
+    if (!_visible || !display) return false;
+
+    if (_dirty) {
+        display->invalidateAll();
+    } else {
+        for (uint8_t i = 0; i < _regionCount; i++) {
+            display->invalidate(_regions[i].x, _regions[i].y, _regions[i].w, _regions[i].h);
+        }
+
+        for (uint8_t i = 0; i < _childCount; i++) {
+            UIElement* child = _children[i];
+            if (!child->isDirty()) continue;
+
+            // Erase where it was last drawn, then paint where it is now
+            const DirtyRect& old = _drawnBounds[i];
+            if (old.w > 0 && old.h > 0) {
+                display->invalidate(old.x, old.y, old.w, old.h);
+            }
+            if (child->isVisible()) {
+                display->invalidate(child->getX(), child->getY(), child->getWidth(), child->getHeight());
+            }
+        }
+    }
+    _regionCount = 0;
+
+    if (!display->isDirty()) return false;
+
+    display->flush(paint, this, _bgColor);
+
+    for (uint8_t i = 0; i < _childCount; i++) {
+        UIElement* child = _children[i];
+        child->clearDirty();
+        if (child->isVisible()) {
+            _drawnBounds[i] = {child->getX(), child->getY(), child->getWidth(), child->getHeight()};
+        } else {
+            _drawnBounds[i] = {0, 0, 0, 0};
+        }
+    }
+    _dirty = false;
+
+    return true;
+}
+
+void Screen::paint(DisplayManager* display, const DirtyRect& rect, void* context) {
+    Screen* self = static_cast<Screen*>(context);
+
+    self->drawContent(display, rect);
+
+    // Children in insertion order (later children on top)
+    for (uint8_t i = 0; i < self->_childCount; i++) {
+        UIElement* child = self->_children[i];
+        if (child->isVisible() &&
+            intersects(rect, child->getX(), child->getY(), child->getWidth(), child->getHeight())) {
+            child->draw(display);
+        }
+    }
+}
+
+bool Screen::onTouch(TouchPoint touch) {
+    if (!_visible || !_enabled) return false;
+
+    // Rebuild the hit index only after a layout change
+    if (!_hitGridValid || _hitGridGeneration != layoutGeneration()) {
+        _hitGridValid = _hitGrid.build(_children, _childCount);
+        _hitGridGeneration = layoutGeneration();
+    }
+
+    UIElement* target = nullptr;
+    if (touch.pressed) {
+        if (_hitGridValid) {
+            target = _hitGrid.hitTest(touch.x, touch.y);
+        } else {
+            // Index allocation failed - fall back to a linear walk
+            for (uint8_t i = _childCount; i > 0; i--) {
+                if (_children[i - 1]->hitTest(touch.x, touch.y)) {
+                    target = _children[i - 1];
+                    break;
+                }
+            }
+        }
+    }
+
+    bool handled = false;
+
+    // The previously pressed child always sees the next event so it can
+    // track slide-off and release edges
+    if (_activeChild && _activeChild != target) {
+        handled |= _activeChild->onTouch(touch);
+    }
+    if (target) {
+        handled |= target->onTouch(touch);
+    }
+    _activeChild = target;
+
+    return handled;
+}
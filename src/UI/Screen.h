@@ -0,0 +1,67 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include "UIElement.h"
+#include "HitGrid.h"
+
+// Full-screen container that owns its child widgets and repaints only
+// what changed. Children mark themselves dirty; render() turns those into
+// dirty rectangles on the DisplayManager and flushes them.
+class Screen : public UIElement {
+public:
+    Screen(uint32_t bgColor = TFT_BLACK);
+    virtual ~Screen();
+
+    // UIElement interface
+    void draw(DisplayManager* display) override;  // Full redraw
+    bool onTouch(TouchPoint touch) override;      // Routes touch to children
+
+    // Repaint only dirty children and invalidated regions.
+    // Returns true if anything was drawn.
+    bool render(DisplayManager* display);
+
+    // Child management - the screen takes ownership and deletes children
+    bool addChild(UIElement* child);
+    uint8_t getChildCount() const { return _childCount; }
+    UIElement* getChild(uint8_t index) const;
+
+    // Mark a screen-drawn area (e.g. a status line) for repaint
+    void invalidateRegion(int32_t x, int32_t y, int32_t w, int32_t h);
+
+    void setBackgroundColor(uint32_t color);
+    uint32_t getBackgroundColor() const { return _bgColor; }
+
+protected:
+    // Static content drawn beneath the children (titles, captions).
+    // Drawing is clipped to rect; skip anything that doesn't reach it.
+    virtual void drawContent(DisplayManager* display, const DirtyRect& rect) {}
+
+    static bool intersects(const DirtyRect& rect, int32_t x, int32_t y, int32_t w, int32_t h) {
+        return rect.x < x + w && x < rect.x + rect.w &&
+               rect.y < y + h && y < rect.y + rect.h;
+    }
+
+private:
+    static const uint8_t MAX_CHILDREN = 64;
+    static const uint8_t MAX_REGIONS = 8;
+
+    UIElement* _children[MAX_CHILDREN];
+    DirtyRect _drawnBounds[MAX_CHILDREN];  // Bounds at last paint, to erase on move
+    uint8_t _childCount;
+
+    DirtyRect _regions[MAX_REGIONS];
+    uint8_t _regionCount;
+
+    uint32_t _bgColor;
+
+    // Touch dispatch index, rebuilt when children are added or moved
+    HitGrid _hitGrid;
+    uint32_t _hitGridGeneration;
+    bool _hitGridValid;
+    UIElement* _activeChild;  // Last child pressed; receives the release
+
+    // Repaint callback for DisplayManager::flush()
+    static void paint(DisplayManager* display, const DirtyRect& rect, void* context);
+};
+
+#endif // SCREEN_H
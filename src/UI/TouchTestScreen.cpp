@@ -0,0 +1,33 @@
+#include "TouchTestScreen.h"
+
+TouchTestScreen::TouchTestScreen()
+    : Screen(TFT_BLACK) {
+}
+
+void TouchTestScreen::drawContent(DisplayManager* display, const DirtyRect& rect) {
+    // Static captions come from the label cache; each line is only drawn
+    // when its band reaches the repainted rect
+    uint32_t bg = getBackgroundColor();
+    int32_t width = display->width();
+
+    // Title
+    if (intersects(rect, 0, 20, width, TITLE_HEIGHT)) {
+        display->drawCachedString("Phase 2: Touch Input Test", width / 2, 20, 4, TFT_CYAN, bg, TC_DATUM);
+    }
+
+    // Instructions
+    if (intersects(rect, 20, 60, width - 20, LINE_HEIGHT)) {
+        display->drawCachedString("Touch the screen or press buttons", 20, 60, 2, TFT_WHITE, bg);
+    }
+
+    // Status area (right side)
+    if (intersects(rect, 480, 100, width - 480, LINE_HEIGHT)) {
+        display->drawCachedString("Touch Status:", 480, 100, 2, TFT_YELLOW, bg);
+    }
+    if (intersects(rect, 480, 150, width - 480, LINE_HEIGHT)) {
+        display->drawCachedString("Touch Count:", 480, 150, 2, TFT_YELLOW, bg);
+    }
+    if (intersects(rect, 480, 200, width - 480, LINE_HEIGHT)) {
+        display->drawCachedString("Multi-Touch:", 480, 200, 2, TFT_YELLOW, bg);
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef TOUCH_TEST_SCREEN_H
+#define TOUCH_TEST_SCREEN_H
+
+#include "Screen.h"
+
+// Phase 2 touch test screen - static captions; buttons are added as children
+class TouchTestScreen : public Screen {
+public:
+    TouchTestScreen();
+
+protected:
+    void drawContent(DisplayManager* display, const DirtyRect& rect) override;
+
+private:
+    static const int32_t TITLE_HEIGHT = 26;  // Font 4
+    static const int32_t LINE_HEIGHT = 16;   // Font 2
+};
+
+#endif // TOUCH_TEST_SCREEN_H
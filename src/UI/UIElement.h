@@ -10,7 +10,7 @@ class UIElement {
 public:
     UIElement(int32_t x, int32_t y, int32_t w, int32_t h)
         : _x(x), _y(y), _width(w), _height(h),
-          _visible(true), _enabled(true) {}
+          _visible(true), _enabled(true), _dirty(true) {}
 
     virtual ~UIElement() {}
 
@@ -26,10 +26,11 @@ public:
     }
 
     // Position and size
-    void setPosition(int32_t x, int32_t y) { _x = x; _y = y; }
-    void setSize(int32_t w, int32_t h) { _width = w; _height = h; }
+    void setPosition(int32_t x, int32_t y) { _x = x; _y = y; layoutChanged(); }
+    void setSize(int32_t w, int32_t h) { _width = w; _height = h; layoutChanged(); }
     void setBounds(int32_t x, int32_t y, int32_t w, int32_t h) {
         _x = x; _y = y; _width = w; _height = h;
+        layoutChanged();
     }
 
     int32_t getX() const { return _x; }
@@ -38,16 +39,40 @@ public:
     int32_t getHeight() const { return _height; }
 
     // Visibility and enabled state
-    void setVisible(bool visible) { _visible = visible; }
+    void setVisible(bool visible) {
+        if (visible != _visible) _dirty = true;
+        _visible = visible;
+    }
     void setEnabled(bool enabled) { _enabled = enabled; }
     bool isVisible() const { return _visible; }
     bool isEnabled() const { return _enabled; }
 
+    // Invalidation - set when the element's appearance changes, cleared
+    // by the owning Screen once it has been repainted
+    void invalidate() { _dirty = true; }
+    bool isDirty() const { return _dirty; }
+    void clearDirty() { _dirty = false; }
+
+    // Bumped whenever any element moves or resizes, so spatial indexes
+    // (HitGrid) know when to rebuild without scanning every widget
+    static uint32_t layoutGeneration() { return layoutGenerationRef(); }
+
 protected:
+    void layoutChanged() {
+        _dirty = true;
+        layoutGenerationRef()++;
+    }
+
+    static uint32_t& layoutGenerationRef() {
+        static uint32_t generation = 0;
+        return generation;
+    }
+
     int32_t _x, _y;
     int32_t _width, _height;
     bool _visible;
     bool _enabled;
+    bool _dirty;
 };
 
 #endif // UI_ELEMENT_H
@@ -1,10 +1,10 @@
 #include "WiFiSetupScreen.h"
 
-// App Store URL for ESP BLE Provisioning app
-const char* WiFiSetupScreen::APP_STORE_URL = "https://apps.apple.com/us/app/esp-ble-provisioning/id1473590141";
+// QR code for the ESP BLE Provisioning app, encoded at build time into flash
+static constexpr auto APP_STORE_QR = QRCodeStatic::encode<6>(WiFiSetupScreen::APP_STORE_URL);
 
 WiFiSetupScreen::WiFiSetupScreen()
-    : UIElement(0, 0, 800, 480),  // Full screen
+    : Screen(TFT_BLACK),
       _qrCode(nullptr),
       _retryButton(nullptr),
       _resetButton(nullptr),
@@ -18,7 +18,7 @@ WiFiSetupScreen::WiFiSetupScreen()
     _qrCode = new QRCodeWidget(300, 120, 200);
     _qrCode->setScale(4);  // 4x4 pixels per module
     _qrCode->setColors(TFT_BLACK, TFT_WHITE);
-    _qrCode->generate(APP_STORE_URL);
+    _qrCode->generate(APP_STORE_QR);
 
     // Create Retry button (bottom-left)
     _retryButton = new Button(100, 400, 200, 60, "Retry");
@@ -27,51 +27,36 @@ WiFiSetupScreen::WiFiSetupScreen()
     // Create Reset button (bottom-right)
     _resetButton = new Button(500, 400, 200, 60, "Reset WiFi");
     _resetButton->setColors(TFT_RED, TFT_WHITE, TFT_DARKGREY);
+
+    addChild(_qrCode);
+    addChild(_retryButton);
+    addChild(_resetButton);
 }
 
 WiFiSetupScreen::~WiFiSetupScreen() {
-    if (_qrCode) {
-        delete _qrCode;
-    }
-    if (_retryButton) {
-        delete _retryButton;
-    }
-    if (_resetButton) {
-        delete _resetButton;
-    }
+    // Children are deleted by Screen
 }
 
-void WiFiSetupScreen::draw(DisplayManager* display) {
-    if (!_visible || !display) return;
-
-    // Clear screen
-    display->clear(TFT_BLACK);
+void WiFiSetupScreen::drawContent(DisplayManager* display, const DirtyRect& rect) {
+    // Centered lines span the full width; each is only drawn when its band
+    // reaches the repainted rect (a status change repaints just that line)
+    uint32_t bg = getBackgroundColor();
 
-    // Title
-    display->setTextFont(4);
-    display->setTextColor(TFT_CYAN);
-    display->setTextDatum(TC_DATUM);  // Top-center
-    display->drawString("WiFi Setup", 400, 20);
-
-    // Instructions
-    display->setTextFont(2);
-    display->setTextColor(TFT_WHITE);
-    display->setTextDatum(TC_DATUM);
-    display->drawString("Scan QR code to download provisioning app", 400, 60);
-
-    // QR code
-    if (_showQR && _qrCode) {
-        _qrCode->draw(display);
+    // Title and instructions (static, from the label cache)
+    if (intersects(rect, 0, 20, 800, TITLE_HEIGHT)) {
+        display->drawCachedString("WiFi Setup", 400, 20, 4, TFT_CYAN, bg, TC_DATUM);
+    }
+    if (intersects(rect, 0, 60, 800, LINE_HEIGHT)) {
+        display->drawCachedString("Scan QR code to download provisioning app", 400, 60, 2, TFT_WHITE, bg, TC_DATUM);
+    }
 
-        // QR code label
-        display->setTextFont(2);
-        display->setTextColor(TFT_LIGHTGREY);
-        display->setTextDatum(TC_DATUM);
-        display->drawString("Download App", 400, 330);
+    // QR code label (the QR code itself is a child widget)
+    if (_showQR && intersects(rect, 0, 330, 800, LINE_HEIGHT)) {
+        display->drawCachedString("Download App", 400, 330, 2, TFT_LIGHTGREY, bg, TC_DATUM);
     }
 
     // Status text
-    if (strlen(_statusText) > 0) {
+    if (strlen(_statusText) > 0 && intersects(rect, 0, 360, 800, LINE_HEIGHT)) {
         display->setTextFont(2);
         display->setTextColor(TFT_YELLOW);
         display->setTextDatum(TC_DATUM);
@@ -79,38 +64,19 @@ void WiFiSetupScreen::draw(DisplayManager* display) {
     }
 
     // Error text
-    if (strlen(_errorText) > 0) {
+    if (strlen(_errorText) > 0 && intersects(rect, 0, 380, 800, LINE_HEIGHT)) {
         display->setTextFont(2);
         display->setTextColor(TFT_RED);
         display->setTextDatum(TC_DATUM);
         display->drawString(_errorText, 400, 380);
     }
-
-    // Buttons
-    if (_retryButton) _retryButton->draw(display);
-    if (_resetButton) _resetButton->draw(display);
 }
 
-bool WiFiSetupScreen::onTouch(TouchPoint touch) {
-    if (!_visible || !_enabled) return false;
-
-    bool handled = false;
-
-    // Route touch to buttons
-    if (_retryButton) {
-        handled |= _retryButton->onTouch(touch);
-    }
-    if (_resetButton) {
-        handled |= _resetButton->onTouch(touch);
+void WiFiSetupScreen::setStatus(const char* status) {
+    if (strncmp(_statusText, status ? status : "", sizeof(_statusText) - 1) != 0) {
+        invalidateRegion(0, 360, 800, 20);  // Status line
     }
 
-    // Note: Button redraws are handled in main.cpp state change callback
-    // to avoid null pointer issues
-
-    return handled;
-}
-
-void WiFiSetupScreen::setStatus(const char* status) {
     if (status) {
         strncpy(_statusText, status, sizeof(_statusText) - 1);
         _statusText[sizeof(_statusText) - 1] = '\0';
@@ -120,6 +86,10 @@ void WiFiSetupScreen::setStatus(const char* status) {
 }
 
 void WiFiSetupScreen::setError(const char* error) {
+    if (strncmp(_errorText, error ? error : "", sizeof(_errorText) - 1) != 0) {
+        invalidateRegion(0, 380, 800, 20);  // Error line
+    }
+
     if (error) {
         strncpy(_errorText, error, sizeof(_errorText) - 1);
         _errorText[sizeof(_errorText) - 1] = '\0';
@@ -129,7 +99,13 @@ void WiFiSetupScreen::setError(const char* error) {
 }
 
 void WiFiSetupScreen::showQRCode(bool show) {
+    if (show != _showQR) {
+        invalidateRegion(0, 330, 800, 20);  // QR code label
+    }
     _showQR = show;
+    if (_qrCode) {
+        _qrCode->setVisible(show);
+    }
 }
 
 void WiFiSetupScreen::setRetryCallback(ButtonCallback callback) {
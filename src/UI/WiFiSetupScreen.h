@@ -1,20 +1,16 @@
 #ifndef WIFI_SETUP_SCREEN_H
 #define WIFI_SETUP_SCREEN_H
 
-#include "UIElement.h"
+#include "Screen.h"
 #include "Button.h"
 #include "QRCodeWidget.h"
 
 // WiFi setup screen with QR code and status
-class WiFiSetupScreen : public UIElement {
+class WiFiSetupScreen : public Screen {
 public:
     WiFiSetupScreen();
     ~WiFiSetupScreen();
 
-    // UIElement interface
-    void draw(DisplayManager* display) override;
-    bool onTouch(TouchPoint touch) override;
-
     // Screen-specific methods
     void setStatus(const char* status);
     void setError(const char* error);
@@ -24,7 +20,17 @@ public:
     void setRetryCallback(ButtonCallback callback);
     void setResetCallback(ButtonCallback callback);
 
+    // App Store URL for ESP BLE Provisioning app (QR encoded at build time)
+    static constexpr char APP_STORE_URL[] = "https://apps.apple.com/us/app/esp-ble-provisioning/id1473590141";
+
+protected:
+    void drawContent(DisplayManager* display, const DirtyRect& rect) override;
+
 private:
+    static const int32_t TITLE_HEIGHT = 26;  // Font 4
+    static const int32_t LINE_HEIGHT = 16;   // Font 2
+
+    // Owned by the Screen base class
     QRCodeWidget* _qrCode;
     Button* _retryButton;
     Button* _resetButton;
@@ -32,8 +38,6 @@ private:
     char _statusText[64];
     char _errorText[64];
     bool _showQR;
-
-    static const char* APP_STORE_URL;
 };
 
 #endif // WIFI_SETUP_SCREEN_H
@@ -0,0 +1,230 @@
+#include "WavSource.h"
+
+static const uint16_t WAVE_FORMAT_PCM = 0x0001;
+static const uint16_t WAVE_FORMAT_IMA_ADPCM = 0x0011;
+
+static const int16_t IMA_STEP_TABLE[89] = {
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t IMA_INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static uint16_t readLE16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t readLE32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+WavSource::WavSource()
+    : _encoding(WAV_PCM16),
+      _channels(0),
+      _sampleRate(0),
+      _blockAlign(0),
+      _dataStart(0),
+      _dataSize(0),
+      _dataLeft(0),
+      _bufferLength(0),
+      _bufferPos(0) {
+    resetDecoder();
+}
+
+WavSource::~WavSource() {
+    close();
+}
+
+bool WavSource::open(fs::FS& fs, const char* path) {
+    close();
+
+    _file = fs.open(path, "r");
+    if (!_file) {
+        Serial.printf("ERROR: Can't open %s\n", path);
+        return false;
+    }
+    if (!parseHeader()) {
+        Serial.printf("ERROR: %s is not a playable WAV file\n", path);
+        close();
+        return false;
+    }
+
+    Serial.printf("Audio: %s, %lu Hz, %u ch, %s, %lu bytes\n", path, (unsigned long)_sampleRate,
+                  (unsigned)_channels, _encoding == WAV_IMA_ADPCM ? "IMA ADPCM" : "PCM",
+                  (unsigned long)_dataSize);
+    return rewind();
+}
+
+void WavSource::close() {
+    if (_file) {
+        _file.close();
+    }
+    _sampleRate = 0;
+    _dataLeft = 0;
+    _bufferLength = _bufferPos = 0;
+}
+
+bool WavSource::parseHeader() {
+    uint8_t header[20];
+    if (_file.read(header, 12) != 12) return false;
+    if (memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) return false;
+
+    // Walk the chunks until "data"; "fmt " has to come first
+    bool haveFormat = false;
+    uint16_t format = 0;
+    uint16_t bits = 0;
+    for (;;) {
+        if (_file.read(header, 8) != 8) return false;
+        uint32_t size = readLE32(header + 4);
+        uint32_t next = _file.position() + size + (size & 1);  // Chunks are word aligned
+
+        if (memcmp(header, "fmt ", 4) == 0) {
+            if (size < 16 || _file.read(header, 16) != 16) return false;
+            format = readLE16(header);
+            _channels = readLE16(header + 2);
+            _sampleRate = readLE32(header + 4);
+            _blockAlign = readLE16(header + 12);
+            bits = readLE16(header + 14);
+            haveFormat = true;
+        } else if (memcmp(header, "data", 4) == 0) {
+            if (!haveFormat) return false;
+            _dataStart = _file.position();
+            _dataSize = min(size, (uint32_t)(_file.size() - _dataStart));  // Truncated uploads still play
+            break;
+        }
+
+        if (!_file.seek(next)) return false;
+    }
+
+    if (_sampleRate < 8000 || _sampleRate > 48000 || _channels == 0 || _channels > 2) return false;
+
+    if (format == WAVE_FORMAT_PCM && bits == 16) {
+        _encoding = WAV_PCM16;
+    } else if (format == WAVE_FORMAT_PCM && bits == 8) {
+        _encoding = WAV_PCM8;
+    } else if (format == WAVE_FORMAT_IMA_ADPCM && bits == 4) {
+        // Stereo ADPCM interleaves channels in 4-byte runs; not worth it for alarm sounds
+        if (_channels != 1 || _blockAlign <= 4 || _blockAlign > MAX_ADPCM_BLOCK) return false;
+        _encoding = WAV_IMA_ADPCM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool WavSource::rewind() {
+    if (!_file || !_file.seek(_dataStart)) return false;
+    _dataLeft = _dataSize;
+    _bufferLength = _bufferPos = 0;
+    resetDecoder();
+    return true;
+}
+
+void WavSource::resetDecoder() {
+    _predictor = 0;
+    _stepIndex = 0;
+    _blockLeft = 0;
+    _highNibble = false;
+    _byte = 0;
+}
+
+size_t WavSource::read(int16_t* out, size_t frames) {
+    size_t count = 0;
+    while (count < frames && nextSample(out[count])) {
+        count++;
+    }
+    return count;
+}
+
+int16_t WavSource::nextByte() {
+    if (_bufferPos >= _bufferLength) {
+        if (_dataLeft == 0) return -1;
+
+        int got = _file.read(_buffer, min((uint32_t)BUFFER_SIZE, _dataLeft));
+        if (got <= 0) {
+            _dataLeft = 0;  // Read error ends the sound rather than stalling it
+            return -1;
+        }
+        _dataLeft -= got;
+        _bufferLength = got;
+        _bufferPos = 0;
+    }
+    return _buffer[_bufferPos++];
+}
+
+bool WavSource::readBytes(uint8_t* out, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        int16_t b = nextByte();
+        if (b < 0) return false;
+        out[i] = (uint8_t)b;
+    }
+    return true;
+}
+
+bool WavSource::nextSample(int16_t& sample) {
+    if (_encoding == WAV_IMA_ADPCM) {
+        return nextAdpcmSample(sample);
+    }
+
+    int32_t sum = 0;
+    for (uint8_t ch = 0; ch < _channels; ch++) {
+        uint8_t bytes[2];
+        if (_encoding == WAV_PCM16) {
+            if (!readBytes(bytes, 2)) return false;
+            sum += (int16_t)readLE16(bytes);
+        } else {
+            if (!readBytes(bytes, 1)) return false;
+            sum += ((int16_t)bytes[0] - 128) << 8;  // 8-bit WAV is unsigned
+        }
+    }
+    sample = (int16_t)(sum / _channels);
+    return true;
+}
+
+bool WavSource::nextAdpcmSample(int16_t& sample) {
+    // Each block opens with the exact first sample and the step index
+    if (_blockLeft == 0 && !_highNibble) {
+        uint8_t header[4];
+        if (!readBytes(header, 4)) return false;
+        _predictor = (int16_t)readLE16(header);
+        _stepIndex = header[2] > 88 ? 88 : header[2];
+        _blockLeft = _blockAlign - 4;
+        sample = (int16_t)_predictor;
+        return true;
+    }
+
+    uint8_t nibble;
+    if (!_highNibble) {
+        int16_t b = nextByte();
+        if (b < 0) return false;
+        _byte = (uint8_t)b;
+        _blockLeft--;
+        nibble = _byte & 0x0F;  // Low nibble first
+        _highNibble = true;
+    } else {
+        nibble = _byte >> 4;
+        _highNibble = false;
+    }
+
+    int32_t step = IMA_STEP_TABLE[_stepIndex];
+    int32_t diff = step >> 3;
+    if (nibble & 1) diff += step >> 2;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 4) diff += step;
+    _predictor += (nibble & 8) ? -diff : diff;
+    _predictor = max((int32_t)-32768, min(_predictor, (int32_t)32767));
+
+    _stepIndex = max(0, min(_stepIndex + IMA_INDEX_TABLE[nibble], 88));
+    sample = (int16_t)_predictor;
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef WAV_SOURCE_H
+#define WAV_SOURCE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "AudioSource.h"
+
+// Streams a WAV file from flash a few hundred bytes at a time. Handles
+// 8/16-bit PCM (stereo is mixed down to mono) and mono IMA ADPCM, which
+// stores 4 bits per sample and so fits four times as much sound in the
+// flash partition. ADPCM is decoded nibble by nibble straight out of the
+// read buffer; no block is ever expanded in RAM.
+class WavSource : public AudioSource {
+public:
+    WavSource();
+    ~WavSource();
+
+    // Parses the header and positions at the first sample. Logs and
+    // returns false for anything it can't play.
+    bool open(fs::FS& fs, const char* path);
+    void close();
+    bool isOpen() const { return (bool)_file; }
+
+    uint32_t getSampleRate() const override { return _sampleRate; }
+    size_t read(int16_t* out, size_t frames) override;
+    bool rewind() override;
+
+private:
+    static const uint16_t BUFFER_SIZE = 512;
+    static const uint16_t MAX_ADPCM_BLOCK = 4096;
+
+    enum Encoding {
+        WAV_PCM8,
+        WAV_PCM16,
+        WAV_IMA_ADPCM
+    };
+
+    fs::File _file;
+    Encoding _encoding;
+    uint8_t _channels;
+    uint32_t _sampleRate;
+    uint16_t _blockAlign;    // Bytes per frame (PCM) or per block (ADPCM)
+    uint32_t _dataStart;     // File offset of the first sample
+    uint32_t _dataSize;
+    uint32_t _dataLeft;      // Bytes of the data chunk not yet buffered
+
+    uint8_t _buffer[BUFFER_SIZE];
+    uint16_t _bufferLength;
+    uint16_t _bufferPos;
+
+    // IMA ADPCM decoder state
+    int32_t _predictor;
+    int8_t _stepIndex;
+    uint16_t _blockLeft;     // Bytes left in the current block, 0 = header next
+    bool _highNibble;        // Second sample of the current byte is next
+    uint8_t _byte;
+
+    bool parseHeader();
+    bool readBytes(uint8_t* out, uint16_t count);
+    int16_t nextByte();  // -1 at the end of the data chunk
+    bool nextSample(int16_t& sample);
+    bool nextAdpcmSample(int16_t& sample);
+    void resetDecoder();
+};
+
+#endif // WAV_SOURCE_H
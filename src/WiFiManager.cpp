@@ -1,23 +1,33 @@
 #include "WiFiManager.h"
 
-// Static member initialization
-WiFiManager* WiFiManager::_instance = nullptr;
+// Dotted quad for logs; ip as stored in IPAddress (first octet in the low byte)
+static void formatIP(uint32_t ip, char* buffer, size_t size) {
+    snprintf(buffer, size, "%u.%u.%u.%u", (unsigned)(ip & 0xFF), (unsigned)((ip >> 8) & 0xFF),
+             (unsigned)((ip >> 16) & 0xFF), (unsigned)(ip >> 24));
+}
 
-WiFiManager::WiFiManager()
-    : _state(WIFI_IDLE),
+WiFiManager::WiFiManager(WiFiRadio* radio)
+    : _radio(radio),
+      _state(WIFI_IDLE),
       _previousState(WIFI_IDLE),
       _stateCallback(nullptr),
       _initialized(false),
       _lastConnectAttempt(0),
-      _connectRetries(0) {
-    _instance = this;  // For static callback
+      _connectRetries(0),
+      _fastValid(false),
+      _fastAttempt(false),
+      _connectStart(0),
+      _policy(&_defaultPolicy),
+      _retryPending(false),
+      _retryAt(0) {
+    memset(&_fast, 0, sizeof(_fast));
+    memset(&_metrics, 0, sizeof(_metrics));
 }
 
 WiFiManager::~WiFiManager() {
     if (_initialized) {
-        WiFi.disconnect(true);
+        _radio->disconnect(true);
     }
-    _instance = nullptr;
 }
 
 bool WiFiManager::begin() {
@@ -28,19 +38,25 @@ bool WiFiManager::begin() {
         return true;
     }
 
-    // Register WiFi event handler
-    WiFi.onEvent(wifiEventHandler);
+    if (!_radio) {
+        Serial.println("ERROR: WiFiManager needs a radio");
+        return false;
+    }
+
+    // Radio events are only queued; update() applies them
+    _events.subscribe(onStackEvent, this);
+    _radio->begin(onRadioEvent, this);
 
     _state = WIFI_CHECKING_CREDS;
 
     // Check for saved credentials
     if (loadCredentials()) {
         Serial.println("Found saved credentials, attempting connection");
+        _fastValid = StorageManager::loadWiFiFastConnect(_fast) && _savedSSID == _fast.ssid;
         _state = WIFI_CONNECTING;
-        WiFi.mode(WIFI_STA);
-        WiFi.begin(_savedSSID.c_str(), _savedPassword.c_str());
-        _lastConnectAttempt = millis();
         _connectRetries = 0;
+        _connectStart = _radio->now();
+        startConnection(true);
     } else {
         Serial.println("No saved credentials, starting provisioning");
         _state = WIFI_PROVISIONING;
@@ -54,6 +70,9 @@ bool WiFiManager::begin() {
 void WiFiManager::update() {
     if (!_initialized) return;
 
+    // Apply events queued by the event task since the last pass
+    _events.dispatch();
+
     // State transition detection
     if (_state != _previousState) {
         Serial.printf("WiFi state change: %d -> %d\n", _previousState, _state);
@@ -75,11 +94,9 @@ void WiFiManager::update() {
 
         case WIFI_CONNECTED:
             // Monitor connection
-            if (WiFi.status() != WL_CONNECTED) {
+            if (!_radio->isConnected()) {
                 Serial.println("Connection lost, reconnecting");
-                _state = WIFI_RECONNECTING;
-                _lastConnectAttempt = millis();
-                _connectRetries = 0;
+                onConnectionLost();
             }
             break;
 
@@ -97,92 +114,103 @@ void WiFiManager::update() {
 }
 
 void WiFiManager::handleConnecting() {
-    wl_status_t status = WiFi.status();
+    uint32_t now = _radio->now();
 
-    if (status == WL_CONNECTED) {
+    if (_radio->isConnected()) {
         _state = WIFI_CONNECTED;
-        _connectRetries = 0;
+        WiFiFastConnect info;
+        _radio->getConnection(info);
+        char ip[16];
+        formatIP(info.ip, ip, sizeof(ip));
         Serial.println("WiFi connected!");
-        Serial.printf("IP: %s\n", WiFi.localIP().toString().c_str());
-        Serial.printf("SSID: %s\n", WiFi.SSID().c_str());
-        Serial.printf("RSSI: %d dBm\n", WiFi.RSSI());
-    } else if (millis() - _lastConnectAttempt > CONNECT_TIMEOUT_MS) {
+        Serial.printf("IP: %s\n", ip);
+        Serial.printf("SSID: %s\n", info.ssid);
+        Serial.printf("RSSI: %d dBm\n", _radio->getRSSI());
+        onConnected();
+    } else if (_fastAttempt && now - _lastConnectAttempt > FAST_CONNECT_TIMEOUT_MS) {
+        // AP moved channel or was replaced - scan for it instead.
+        // Doesn't count against the retries.
+        Serial.println("Fast connect failed, falling back to a full scan");
+        _metrics.failedAttempts++;
+        _radio->disconnect();
+        startConnection(false);
+    } else if (now - _lastConnectAttempt > CONNECT_TIMEOUT_MS) {
         // Timeout after 10 seconds
         _connectRetries++;
+        _metrics.failedAttempts++;
         Serial.printf("Connection attempt %d/%d failed (status: %d)\n",
-                      _connectRetries, MAX_CONNECT_RETRIES, status);
-
-        if (_connectRetries >= MAX_CONNECT_RETRIES) {
+                      _connectRetries, MAX_CONNECT_RETRIES, _radio->getStatus());
+
+        if (_connectRetries >= MAX_CONNECT_RETRIES && _fastValid) {
+            // These credentials have connected here before, so the network
+            // is more likely down (power cut) than misconfigured
+            Serial.println("Known network unreachable, retrying in the background");
+            _state = WIFI_RECONNECTING;
+            scheduleRetry();  // Backoff continues from the retries so far
+        } else if (_connectRetries >= MAX_CONNECT_RETRIES) {
             Serial.println("Connection failed after max retries");
             _state = WIFI_FAILED;
-            WiFi.disconnect();
+            _radio->disconnect();
         } else {
             Serial.printf("Retrying connection (%d/%d)\n", _connectRetries + 1, MAX_CONNECT_RETRIES);
-            WiFi.disconnect();
+            _radio->disconnect();
             delay(100);
-            WiFi.begin(_savedSSID.c_str(), _savedPassword.c_str());
-            _lastConnectAttempt = millis();
+            startConnection(false);
         }
     }
 }
 
 void WiFiManager::handleReconnecting() {
-    wl_status_t status = WiFi.status();
+    uint32_t now = _radio->now();
 
-    if (status == WL_CONNECTED) {
+    if (_radio->isConnected()) {
         _state = WIFI_CONNECTED;
-        _connectRetries = 0;
         Serial.println("Reconnected to WiFi");
-    } else if (millis() - _lastConnectAttempt > CONNECT_TIMEOUT_MS) {
-        _connectRetries++;
-        Serial.printf("Reconnection attempt %d/%d failed\n", _connectRetries, MAX_CONNECT_RETRIES);
+        onConnected();
+        return;
+    }
 
-        if (_connectRetries >= MAX_CONNECT_RETRIES) {
-            Serial.println("Reconnection failed, entering failed state");
-            _state = WIFI_FAILED;
-            WiFi.disconnect();
-        } else {
-            WiFi.reconnect();
-            _lastConnectAttempt = millis();
+    if (_retryPending) {
+        if ((long)(now - _retryAt) >= 0) {
+            // Alternate the targeted join and a full scan, in case the AP
+            // came back on another channel
+            _retryPending = false;
+            startConnection(_connectRetries % 2 == 0);
         }
+        return;
     }
-}
-
-void WiFiManager::startProvisioning() {
-    Serial.println("WiFiManager::startProvisioning()");
-
-    // Generate unique device name with chip MAC
-    uint64_t chipid = ESP.getEfuseMac();
-    String deviceName = "PROV_ALARM_" + String((uint32_t)(chipid >> 32), HEX);
 
-    const char* pop = "abcd1234";  // Proof of possession
-    const char* service_name = deviceName.c_str();
+    unsigned long timeout = _fastAttempt ? FAST_CONNECT_TIMEOUT_MS : CONNECT_TIMEOUT_MS;
+    if (now - _lastConnectAttempt > timeout) {
+        _connectRetries++;
+        _metrics.failedAttempts++;
+        scheduleRetry();
+    }
+}
 
-    // Generate random UUID for this provisioning session
-    uint8_t uuid[16];
-    for (int i = 0; i < 16; i++) {
-        uuid[i] = random(0, 255);
+void WiFiManager::scheduleRetry() {
+    uint32_t delayMs;
+    if (!_policy->nextDelay(_connectRetries, delayMs)) {
+        Serial.printf("Reconnection failed after %u attempts, entering failed state\n", _connectRetries);
+        _state = WIFI_FAILED;
+        _radio->disconnect();
+        return;
     }
 
-    Serial.printf("Starting BLE provisioning with device name: %s\n", service_name);
-    Serial.printf("Proof of Possession: %s\n", pop);
-
-    // Start WiFi provisioning via BLE
-    WiFiProv.beginProvision(
-        WIFI_PROV_SCHEME_BLE,
-        WIFI_PROV_SCHEME_HANDLER_FREE_BLE,  // Free BT memory after provisioning
-        WIFI_PROV_SECURITY_1,               // Encrypted provisioning
-        pop,
-        service_name,
-        NULL,          // service_key = NULL for BLE
-        uuid,
-        true           // reset_provisioned = true (clear old credentials)
-    );
-
-    // Note: WiFiProv.printQR() is not available in this version
-    // We're using our own QRCodeWidget to display the App Store URL instead
-    Serial.println("BLE provisioning started successfully");
+    Serial.printf("Reconnection attempt %u failed, next in %lu ms\n", _connectRetries,
+                  (unsigned long)delayMs);
+    _radio->disconnect();
+    _retryPending = true;
+    _retryAt = _radio->now() + delayMs;
+}
+
+void WiFiManager::setRetryPolicy(RetryPolicy* policy) {
+    _policy = policy ? policy : &_defaultPolicy;
+}
 
+void WiFiManager::startProvisioning() {
+    Serial.println("WiFiManager::startProvisioning()");
+    _radio->startProvisioning();
     _state = WIFI_PROVISIONING;
 }
 
@@ -196,10 +224,11 @@ void WiFiManager::resetCredentials() {
     Serial.println("WiFiManager::resetCredentials()");
 
     // Disconnect WiFi
-    WiFi.disconnect(true);
+    _radio->disconnect(true);
 
-    // Clear stored credentials
+    // Clear stored credentials (and the fast-connect record with them)
     StorageManager::clearWiFiCredentials();
+    _fastValid = false;
 
     // Restart provisioning
     _state = WIFI_PROVISIONING;
@@ -219,9 +248,138 @@ void WiFiManager::reconnect() {
 
     _state = WIFI_CONNECTING;
     _connectRetries = 0;
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(_savedSSID.c_str(), _savedPassword.c_str());
-    _lastConnectAttempt = millis();
+    _retryPending = false;
+    _connectStart = _radio->now();
+    startConnection(true);
+}
+
+void WiFiManager::startConnection(bool allowFast) {
+    _fastAttempt = allowFast && _fastValid;
+
+    if (_fastAttempt) {
+        Serial.printf("Fast connect: channel %u, BSSID %02X:%02X:%02X:%02X:%02X:%02X\n", _fast.channel,
+                      _fast.bssid[0], _fast.bssid[1], _fast.bssid[2], _fast.bssid[3], _fast.bssid[4],
+                      _fast.bssid[5]);
+    }
+    _radio->connect(_savedSSID.c_str(), _savedPassword.c_str(), _fastAttempt ? &_fast : nullptr);
+
+    _lastConnectAttempt = _radio->now();
+    _metrics.attempts++;
+}
+
+void WiFiManager::onConnected() {
+    uint32_t now = _radio->now();
+    uint32_t elapsed = now - _connectStart;
+
+    _metrics.connects++;
+    if (_fastAttempt) _metrics.fastConnects++;
+    _metrics.lastConnectMs = elapsed;
+    _metrics.totalConnectMs += elapsed;
+    if (_metrics.connects == 1 || elapsed < _metrics.minConnectMs) _metrics.minConnectMs = elapsed;
+    if (elapsed > _metrics.maxConnectMs) _metrics.maxConnectMs = elapsed;
+    _metrics.connectedSince = now ? now : 1;
+
+    Serial.printf("Connected in %lu ms (%s)\n", (unsigned long)elapsed, _fastAttempt ? "fast" : "scan");
+
+    _connectRetries = 0;
+    _retryPending = false;
+    _fastAttempt = false;
+    rememberConnection();
+}
+
+void WiFiManager::onConnectionLost() {
+    uint32_t now = _radio->now();
+
+    _metrics.disconnects++;
+    if (_metrics.connectedSince) {
+        _metrics.connectedTotalMs += now - _metrics.connectedSince;
+        _metrics.connectedSince = 0;
+    }
+
+    // First retry right away, then whatever the policy says
+    _state = WIFI_RECONNECTING;
+    _connectStart = now;
+    _connectRetries = 0;
+    _retryPending = true;
+    _retryAt = now;
+}
+
+void WiFiManager::recordDisconnectReason(uint8_t reason) {
+    _metrics.lastDisconnectReason = reason;
+
+    // Count by code; when the table is full the rarest entry makes room
+    WiFiReasonCount* slot = nullptr;
+    for (uint8_t i = 0; i < WIFI_REASON_SLOTS; i++) {
+        WiFiReasonCount& entry = _metrics.reasons[i];
+        if (entry.reason == reason) {
+            slot = &entry;
+            break;
+        }
+        if (!slot || entry.count < slot->count) {
+            slot = &entry;  // Unused slots have count 0
+        }
+    }
+
+    if (slot->reason != reason) {
+        slot->reason = reason;
+        slot->count = 0;
+    }
+    if (slot->count < UINT16_MAX) slot->count++;
+}
+
+uint32_t WiFiManager::getConnectedTime() const {
+    uint32_t total = _metrics.connectedTotalMs;
+    if (_metrics.connectedSince) {
+        total += _radio->now() - _metrics.connectedSince;
+    }
+    return total;
+}
+
+void WiFiManager::dumpMetrics() {
+    uint32_t connected = getConnectedTime();
+    uint32_t now = _radio->now();
+
+    Serial.printf("WiFi: %s, connected %lu s of %lu s uptime (%lu%%)\n", getStateString(),
+                  (unsigned long)(connected / 1000), (unsigned long)(now / 1000),
+                  (unsigned long)(now ? (uint64_t)connected * 100 / now : 0));
+    Serial.printf("  attempts %lu (%lu timed out), connects %lu (%lu fast), disconnects %lu\n",
+                  (unsigned long)_metrics.attempts, (unsigned long)_metrics.failedAttempts,
+                  (unsigned long)_metrics.connects, (unsigned long)_metrics.fastConnects,
+                  (unsigned long)_metrics.disconnects);
+    if (_metrics.connects) {
+        Serial.printf("  connect time: last %lu ms, min %lu, avg %lu, max %lu\n",
+                      (unsigned long)_metrics.lastConnectMs, (unsigned long)_metrics.minConnectMs,
+                      (unsigned long)(_metrics.totalConnectMs / _metrics.connects),
+                      (unsigned long)_metrics.maxConnectMs);
+    }
+    if (_state == WIFI_RECONNECTING && _retryPending) {
+        long wait = (long)(_retryAt - now);
+        Serial.printf("  next retry in %ld ms (%u failed so far)\n", wait > 0 ? wait : 0, _connectRetries);
+    }
+    for (uint8_t i = 0; i < WIFI_REASON_SLOTS; i++) {
+        const WiFiReasonCount& entry = _metrics.reasons[i];
+        if (!entry.count) continue;
+        Serial.printf("  disconnect %3u %-24s x%u%s\n", entry.reason,
+                      _radio->getReasonName(entry.reason), entry.count,
+                      entry.reason == _metrics.lastDisconnectReason ? " (last)" : "");
+    }
+}
+
+void WiFiManager::rememberConnection() {
+    WiFiFastConnect fast;
+    if (!_radio->getConnection(fast)) return;
+
+    // Only the association is kept; the address comes from DHCP every time
+    fast.ip = fast.gateway = fast.subnet = fast.dns = 0;
+
+    // Only write when the association changed, not on every new lease
+    if (_fastValid && memcmp(&fast, &_fast, sizeof(fast)) == 0) return;
+
+    _fast = fast;
+    _fastValid = fast.channel != 0;
+    if (_fastValid) {
+        StorageManager::saveWiFiFastConnect(_fast);
+    }
 }
 
 bool WiFiManager::loadCredentials() {
@@ -242,25 +400,31 @@ bool WiFiManager::isProvisioning() const {
 }
 
 String WiFiManager::getSSID() const {
-    if (_state == WIFI_CONNECTED) {
-        return WiFi.SSID();
+    WiFiFastConnect info;
+    if (_state == WIFI_CONNECTED && _radio->getConnection(info)) {
+        return String(info.ssid);
     }
     return _savedSSID;
 }
 
 int8_t WiFiManager::getRSSI() const {
     if (_state == WIFI_CONNECTED) {
-        return WiFi.RSSI();
+        return _radio->getRSSI();
     }
     return 0;
 }
 
-IPAddress WiFiManager::getIP() const {
-    return WiFi.localIP();
+uint32_t WiFiManager::getIP() const {
+    WiFiFastConnect info;
+    return _radio->getConnection(info) ? info.ip : 0;
 }
 
 const char* WiFiManager::getStateString() const {
-    switch (_state) {
+    return getStateString(_state);
+}
+
+const char* WiFiManager::getStateString(WiFiState state) {
+    switch (state) {
         case WIFI_IDLE: return "Idle";
         case WIFI_CHECKING_CREDS: return "Checking credentials";
         case WIFI_CONNECTING: return "Connecting";
@@ -277,63 +441,52 @@ void WiFiManager::onStateChange(StateChangeCallback callback) {
     _stateCallback = callback;
 }
 
-// Static WiFi event handler
-void WiFiManager::wifiEventHandler(arduino_event_t* event) {
-    if (!_instance) return;
-
-    switch (event->event_id) {
-        case ARDUINO_EVENT_PROV_START:
-            Serial.println("[WiFi Event] Provisioning started");
-            break;
+// Radio callback - may run on the ESP-IDF event task, so it only copies the
+// event into the queue and never touches manager state
+void WiFiManager::onRadioEvent(const WiFiStackEvent& event, void* context) {
+    if (!static_cast<WiFiManager*>(context)->_events.publish(event)) {
+        Serial.println("WARNING: WiFi event queue full, event dropped");
+    }
+}
 
-        case ARDUINO_EVENT_PROV_CRED_RECV:
-            Serial.println("[WiFi Event] Received WiFi credentials");
-            Serial.printf("  SSID: %s\n", (const char*)event->event_info.prov_cred_recv.ssid);
-            // Don't log password for security
+void WiFiManager::onStackEvent(const WiFiStackEvent& event, void* context) {
+    static_cast<WiFiManager*>(context)->handleStackEvent(event);
+}
 
+void WiFiManager::handleStackEvent(const WiFiStackEvent& event) {
+    switch (event.type) {
+        case WIFI_EVT_PROV_CRED_RECV:
             // Save credentials
-            _instance->_savedSSID = String((const char*)event->event_info.prov_cred_recv.ssid);
-            _instance->_savedPassword = String((const char*)event->event_info.prov_cred_recv.password);
-
-            StorageManager::saveWiFiCredentials(_instance->_savedSSID, _instance->_savedPassword);
+            _savedSSID = event.ssid;
+            _savedPassword = event.password;
+            StorageManager::saveWiFiCredentials(_savedSSID, _savedPassword);
+            _connectStart = event.timestamp;  // The join starts now; GOT_IP follows PROV_SUCCESS
             break;
 
-        case ARDUINO_EVENT_PROV_CRED_SUCCESS:
-            Serial.println("[WiFi Event] Provisioning successful!");
-            _instance->stopProvisioning();
-            _instance->_state = WIFI_PROV_SUCCESS;
+        case WIFI_EVT_PROV_SUCCESS:
+            stopProvisioning();
+            _state = WIFI_PROV_SUCCESS;
             // Will transition to WIFI_CONNECTING in next update() cycle
             break;
 
-        case ARDUINO_EVENT_PROV_CRED_FAIL:
-            Serial.println("[WiFi Event] Provisioning failed - invalid credentials");
-            _instance->_state = WIFI_FAILED;
-            break;
-
-        case ARDUINO_EVENT_PROV_END:
-            Serial.println("[WiFi Event] Provisioning ended");
+        case WIFI_EVT_PROV_FAIL:
+            _state = WIFI_FAILED;
             break;
 
-        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
-            Serial.println("[WiFi Event] Got IP address");
-            Serial.printf("  IP: %s\n", WiFi.localIP().toString().c_str());
-            if (_instance->_state == WIFI_PROV_SUCCESS ||
-                _instance->_state == WIFI_CONNECTING ||
-                _instance->_state == WIFI_RECONNECTING) {
-                _instance->_state = WIFI_CONNECTED;
+        case WIFI_EVT_GOT_IP:
+            if (_state == WIFI_PROV_SUCCESS ||
+                _state == WIFI_CONNECTING ||
+                _state == WIFI_RECONNECTING) {
+                _state = WIFI_CONNECTED;
+                onConnected();
             }
             break;
 
-        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
-            Serial.println("[WiFi Event] Disconnected from WiFi");
-            if (_instance->_state == WIFI_CONNECTED) {
-                _instance->_state = WIFI_RECONNECTING;
-                _instance->_lastConnectAttempt = millis();
-                _instance->_connectRetries = 0;
+        case WIFI_EVT_DISCONNECTED:
+            recordDisconnectReason(event.reason);
+            if (_state == WIFI_CONNECTED) {
+                onConnectionLost();
             }
             break;
-
-        default:
-            break;
     }
 }
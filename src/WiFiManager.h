@@ -2,9 +2,10 @@
 #define WIFI_MANAGER_H
 
 #include <Arduino.h>
-#include <WiFi.h>
-#include <WiFiProv.h>
 #include "StorageManager.h"
+#include "WiFiRadio.h"
+#include "EventBus.h"
+#include "RetryPolicy.h"
 
 // WiFi connection states
 enum WiFiState {
@@ -18,9 +19,37 @@ enum WiFiState {
     WIFI_RECONNECTING       // Lost connection, attempting reconnect
 };
 
+typedef EventBus<WiFiStackEvent, 8> WiFiEventBus;
+
+// Connection history for diagnostics
+static const uint8_t WIFI_REASON_SLOTS = 8;
+
+struct WiFiReasonCount {
+    uint8_t reason;             // wifi_err_reason_t, 0 = unused slot
+    uint16_t count;
+};
+
+struct WiFiMetrics {
+    uint32_t attempts;          // Connection attempts started
+    uint32_t failedAttempts;    // Attempts that timed out
+    uint32_t connects;
+    uint32_t fastConnects;      // Connects that used the cached BSSID/IP
+    uint32_t disconnects;       // Established connections lost
+    uint32_t lastConnectMs;     // Start of connecting to having an IP
+    uint32_t minConnectMs;
+    uint32_t maxConnectMs;
+    uint32_t totalConnectMs;    // Sum over connects, for the average
+    uint8_t lastDisconnectReason;
+    WiFiReasonCount reasons[WIFI_REASON_SLOTS];  // Disconnect reasons seen, by code
+    uint32_t connectedSince;    // WiFiRadio::now() when the current connection came up, 0 when down
+    uint32_t connectedTotalMs;  // Connected time of earlier connections
+};
+
+// Connection state machine. All hardware access and timing goes through the
+// WiFiRadio, so the same code runs against the simulator's fake radio.
 class WiFiManager {
 public:
-    WiFiManager();
+    explicit WiFiManager(WiFiRadio* radio);  // Radio must outlive the manager
     ~WiFiManager();
 
     // Manager pattern
@@ -33,8 +62,9 @@ public:
     bool isProvisioning() const;
     String getSSID() const;
     int8_t getRSSI() const;
-    IPAddress getIP() const;
+    uint32_t getIP() const;  // IPv4 as in IPAddress, 0 when not connected
     const char* getStateString() const;
+    static const char* getStateString(WiFiState state);
 
     // Actions
     void startProvisioning();
@@ -42,33 +72,74 @@ public:
     void resetCredentials();  // Clear NVS, restart provisioning
     void reconnect();  // Manual reconnect attempt
 
+    // Automatic retries after a lost connection (and after the initial
+    // retries on a network that has worked before). Default: exponential
+    // backoff from 2 s to 5 min with 20% jitter, never giving up.
+    // nullptr restores the default; the policy must outlive the manager.
+    void setRetryPolicy(RetryPolicy* policy);
+
+    // Diagnostics
+    const WiFiMetrics& getMetrics() const { return _metrics; }
+    uint32_t getLastConnectTime() const { return _metrics.lastConnectMs; }
+    uint32_t getConnectedTime() const;  // Total ms connected since boot
+    void dumpMetrics();                 // Print metrics to Serial
+
     // Callbacks for UI updates
     typedef void (*StateChangeCallback)(WiFiState newState);
     void onStateChange(StateChangeCallback callback);
 
+    // Stack events are delivered from update(); other subsystems may
+    // subscribe before begin()
+    WiFiEventBus& getEventBus() { return _events; }
+
 private:
+    WiFiRadio* _radio;
     WiFiState _state;
     WiFiState _previousState;
     StateChangeCallback _stateCallback;
 
     bool _initialized;
     unsigned long _lastConnectAttempt;
-    uint8_t _connectRetries;
+    uint16_t _connectRetries;
     static const uint8_t MAX_CONNECT_RETRIES = 3;
     static const unsigned long CONNECT_TIMEOUT_MS = 10000;  // 10 seconds
+    static const unsigned long FAST_CONNECT_TIMEOUT_MS = 3000;  // Known AP, no scan, DHCP
+
+    // Fast connect: BSSID, channel and IP config from the last connection
+    WiFiFastConnect _fast;
+    bool _fastValid;
+    bool _fastAttempt;          // Current attempt is the targeted one
+    unsigned long _connectStart;
+
+    // Retry scheduling
+    RetryPolicy* _policy;
+    BackoffRetryPolicy _defaultPolicy;
+    bool _retryPending;
+    unsigned long _retryAt;
+
+    WiFiMetrics _metrics;
 
     String _savedSSID;
     String _savedPassword;
 
+    WiFiEventBus _events;  // Radio callback -> update()
+
     // Internal methods
     bool loadCredentials();
     bool attemptConnection(uint32_t timeout_ms);
+    void startConnection(bool allowFast);
+    void onConnected();
+    void onConnectionLost();
+    void scheduleRetry();
+    void recordDisconnectReason(uint8_t reason);
+    void rememberConnection();
     void handleConnecting();
     void handleReconnecting();
+    void handleStackEvent(const WiFiStackEvent& event);
 
-    // Static callback for WiFi events
-    static void wifiEventHandler(arduino_event_t* event);
-    static WiFiManager* _instance;  // For static callback
+    // Static callbacks for WiFi events
+    static void onRadioEvent(const WiFiStackEvent& event, void* context);
+    static void onStackEvent(const WiFiStackEvent& event, void* context);
 };
 
 #endif // WIFI_MANAGER_H
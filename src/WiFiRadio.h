@@ -0,0 +1,52 @@
+#ifndef WIFI_RADIO_H
+#define WIFI_RADIO_H
+
+#include <Arduino.h>
+#include "StorageManager.h"
+
+// Events from the WiFi/provisioning stack, copied out of the ESP-IDF event
+// task so the state machine can act on them from update()
+enum WiFiStackEventType {
+    WIFI_EVT_PROV_CRED_RECV,    // ssid/password hold the received credentials
+    WIFI_EVT_PROV_SUCCESS,
+    WIFI_EVT_PROV_FAIL,
+    WIFI_EVT_GOT_IP,
+    WIFI_EVT_DISCONNECTED
+};
+
+struct WiFiStackEvent {
+    WiFiStackEventType type;
+    uint32_t timestamp;      // WiFiRadio::now() when the event arrived
+    uint8_t reason;          // WIFI_EVT_DISCONNECTED: wifi_err_reason_t
+    char ssid[33];
+    char password[65];
+};
+
+// Everything WiFiManager needs from the hardware and the clock. The device
+// uses ArduinoWiFiRadio; the simulator has a scripted fake (src/sim).
+class WiFiRadio {
+public:
+    // May be called from another task - only queue the event
+    typedef void (*EventCallback)(const WiFiStackEvent& event, void* context);
+
+    virtual ~WiFiRadio() {}
+
+    virtual void begin(EventCallback callback, void* context) = 0;
+    virtual uint32_t now() = 0;  // Milliseconds, for every timeout
+
+    // Join ssid; with fast set, go straight to its BSSID/channel instead of
+    // scanning. The address always comes from DHCP.
+    virtual void connect(const char* ssid, const char* password, const WiFiFastConnect* fast) = 0;
+    virtual void disconnect(bool radioOff = false) = 0;
+    virtual bool isConnected() = 0;
+    virtual int getStatus() = 0;  // Driver status code, for logs
+
+    // Current association (ssid, BSSID, channel, IP config)
+    virtual bool getConnection(WiFiFastConnect& info) = 0;
+    virtual int8_t getRSSI() = 0;
+
+    virtual void startProvisioning() = 0;
+    virtual const char* getReasonName(uint8_t reason) = 0;
+};
+
+#endif // WIFI_RADIO_H
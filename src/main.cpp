@@ -1,26 +1,55 @@
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "DisplayManager.h"
 #include "TouchManager.h"
+#include "GestureRecognizer.h"
+#include "Scheduler.h"
+#include "StorageManager.h"
+#include "SettingsManager.h"
+#include "LocalClock.h"
+#include "AlarmManager.h"
+#include "BrightnessManager.h"
 #include "UI/Button.h"
+#include "UI/TouchTestScreen.h"
+#include "UI/ClockScreen.h"
 
 #ifdef ENABLE_WIFI
 #include "WiFiManager.h"
+#include "ArduinoWiFiRadio.h"
+#include "NetworkTask.h"
+#include "TimeManager.h"
 #include "UI/WiFiSetupScreen.h"
 #endif
 
+#ifdef ENABLE_AUDIO
+#include "AudioManager.h"
+#endif
+
 // Global managers
 DisplayManager display;
 TouchManager touch;
+GestureRecognizer gestures;
+Scheduler scheduler;
+SettingsManager settings;
+LocalClock localClock;             // Read from any task, disciplined by timeMgr
+AlarmManager alarms;
+BrightnessManager backlight;       // Ambient light -> backlight, shares I2C with touch
 
 #ifdef ENABLE_WIFI
-WiFiManager wifiMgr;
+ArduinoWiFiRadio wifiRadio;
+WiFiManager wifiMgr(&wifiRadio);   // Owned by the network task after setup()
+TimeManager timeMgr(&localClock);  // Likewise
+NetworkTask network;
 #endif
 
-// Test buttons
-Button* button1 = nullptr;
-Button* button2 = nullptr;
-Button* button3 = nullptr;
-Button* button4 = nullptr;
+#ifdef ENABLE_AUDIO
+AudioManager audio;                // Decode and I2S output tasks
+#endif
+
+// Clock face, with the touch test screen (owns the test buttons) behind a long press
+ClockScreen* clockScreen = nullptr;
+TouchTestScreen* mainScreen = nullptr;
+bool showingTouchTest = false;
 
 #ifdef ENABLE_WIFI
 // WiFi setup screen
@@ -28,6 +57,11 @@ WiFiSetupScreen* setupScreen = nullptr;
 bool showingSetupScreen = false;
 #endif
 
+// Alarm checks are scheduled for the next fire time, not polled
+const uint32_t ALARM_RECHECK_MS = 60000;
+int8_t alarmTaskId = Scheduler::INVALID_TASK;
+int8_t backlightTaskId = Scheduler::INVALID_TASK;
+
 // Touch statistics
 int touchCounter = 0;
 int multiTouchCounter = 0;
@@ -71,29 +105,52 @@ void onButton4Press() {
 }
 
 void drawUI() {
-  display.clear(TFT_BLACK);
+  if (showingTouchTest) {
+    if (mainScreen) mainScreen->draw(&display);
+  } else {
+    if (clockScreen) clockScreen->draw(&display);
+  }
+}
 
-  // Title
-  display.setTextFont(4);
-  display.setTextColor(TFT_CYAN);
-  display.drawCentreString("Phase 2: Touch Input Test", display.width() / 2, 20);
+// Local time in microseconds since the epoch, 0 until the first sync
+int64_t localNowUs() {
+  int64_t utcUs = localClock.nowUs();
+  if (utcUs == 0) return 0;
+  return utcUs + (int64_t)settings.get().utcOffsetMinutes * 60 * 1000000;
+}
 
-  // Instructions
-  display.setTextFont(2);
-  display.setTextColor(TFT_WHITE);
-  display.drawString("Touch the screen or press buttons", 20, 60);
-
-  // Draw all buttons
-  if (button1) button1->draw(&display);
-  if (button2) button2->draw(&display);
-  if (button3) button3->draw(&display);
-  if (button4) button4->draw(&display);
-
-  // Status area (right side)
-  display.setTextColor(TFT_YELLOW);
-  display.drawString("Touch Status:", 480, 100);
-  display.drawString("Touch Count:", 480, 150);
-  display.drawString("Multi-Touch:", 480, 200);
+// Hand the clock screen the current local time; it redraws only what changed
+void updateClock() {
+  const SettingsData& config = settings.get();
+  clockScreen->setFormat(config.use24Hour, config.showSeconds);
+
+  int64_t nowUs = localNowUs();
+  if (nowUs == 0) {
+    clockScreen->clearTime();
+  } else {
+    clockScreen->setTime((time_t)(nowUs / 1000000));
+  }
+}
+
+// Alarm ringing, snoozes and dismissals
+void onAlarmEvent(const AlarmEvent& event, void* context) {
+  static const char* const names[] = {"ringing", "snoozed", "dismissed", "missed"};
+  struct tm fields;
+  gmtime_r(&event.fireTime, &fields);
+  Serial.printf("Alarm %u %s (%02d:%02d)\n", event.index, names[event.type], fields.tm_hour, fields.tm_min);
+
+#ifdef ENABLE_AUDIO
+  // Sound N is /alarmN.wav on the flash filesystem, or the built-in beep
+  // if it isn't there; it loops and fades in until snoozed or dismissed
+  if (event.type == ALARM_EVT_RING) {
+    const AlarmConfig& alarm = settings.get().alarms[event.index];
+    char path[16];
+    snprintf(path, sizeof(path), "/alarm%u.wav", alarm.tone);
+    audio.play(path, true, alarm.volume, AudioManager::DEFAULT_RAMP_MS);
+  } else if (event.type == ALARM_EVT_SNOOZE || event.type == ALARM_EVT_DISMISS) {
+    audio.stop();
+  }
+#endif
 }
 
 void updateTouchDisplay() {
@@ -147,6 +204,299 @@ void updateTouchDisplay() {
   }
 }
 
+#ifdef ENABLE_WIFI
+// Apply a WiFi state change from the network task to the UI
+void handleWiFiStatus(const WiFiStatus& status) {
+  Serial.printf("WiFi state changed to: %s\n", WiFiManager::getStateString(status.state));
+
+  switch (status.state) {
+    case WIFI_PROVISIONING:
+    case WIFI_FAILED: {
+      // Show setup screen for provisioning or failure
+      bool wasShowing = showingSetupScreen && setupScreen;
+      showingSetupScreen = true;
+      if (!setupScreen) {
+        setupScreen = new WiFiSetupScreen();
+        setupScreen->showQRCode(true);
+
+        // Set button callbacks - WiFiManager lives on the network task
+        setupScreen->setRetryCallback([]() {
+          Serial.println("Retry button pressed");
+          network.postCommand(WIFI_CMD_RECONNECT);
+        });
+
+        setupScreen->setResetCallback([]() {
+          Serial.println("Reset button pressed");
+          network.postCommand(WIFI_CMD_RESET_CREDENTIALS);
+        });
+      }
+
+      // Update status based on state
+      if (status.state == WIFI_PROVISIONING) {
+        setupScreen->setStatus("Waiting for app...");
+        setupScreen->setError("");
+      } else {
+        setupScreen->setError("Connection failed!");
+        setupScreen->setStatus("Tap Retry or Reset");
+      }
+
+      // Full redraw when switching screens, otherwise just the changed lines
+      if (wasShowing) {
+        setupScreen->render(&display);
+      } else {
+        setupScreen->draw(&display);
+      }
+      break;
+    }
+
+    case WIFI_CONNECTING:
+      // If setup screen is showing, update status
+      if (showingSetupScreen && setupScreen) {
+        setupScreen->setError("");  // Clear error
+        setupScreen->setStatus("Connecting to WiFi...");
+        setupScreen->render(&display);
+      } else {
+        // Connecting with saved credentials, show status on main screen
+        Serial.println("Connecting to WiFi with saved credentials...");
+        // Could add a status indicator to main UI here
+      }
+      break;
+
+    case WIFI_CONNECTED:
+      showingSetupScreen = false;
+      Serial.printf("WiFi connected! IP: %s\n", IPAddress(status.ip).toString().c_str());
+      Serial.printf("SSID: %s\n", status.ssid);
+      Serial.printf("RSSI: %d dBm\n", status.rssi);
+      // Redraw main UI
+      drawUI();
+      break;
+
+    default:
+      break;
+  }
+}
+#endif
+
+// Scheduled tasks
+
+// UI: touch sampling, gestures, dispatch and drawing (100 Hz)
+void uiTask(void* context) {
+  // Update touch state
+  touch.update();
+
+  // Feed every touch event to the gesture recognizer
+  TouchEvent event;
+  while (touch.pollEvent(event)) {
+    gestures.processEvent(event);
+  }
+  gestures.update(esp_timer_get_time());
+
+  Gesture gesture;
+  while (gestures.pollGesture(gesture)) {
+    Serial.printf("Gesture: %s at %d,%d (%lu ms)\n", GestureRecognizer::getTypeString(gesture.type),
+                  gesture.x, gesture.y, (unsigned long)(gesture.durationUs / 1000));
+
+    // Vertical swipes step the backlight and take it off auto; the setting
+    // is written to flash once the user stops adjusting
+    if (gesture.type == GESTURE_SWIPE_UP || gesture.type == GESTURE_SWIPE_DOWN) {
+      int level = display.getBrightness() + (gesture.type == GESTURE_SWIPE_UP ? 32 : -32);
+      level = max(16, min(255, level));
+      display.setBrightness(level);
+      SettingsData& config = settings.edit(SETTINGS_DISPLAY);
+      config.brightness = level;
+      config.autoBrightness = 0;
+    }
+
+    // While an alarm rings, tap to snooze and long press to stop it
+    if (alarms.isRinging()) {
+      if (gesture.type == GESTURE_TAP) {
+        alarms.snooze((time_t)(localNowUs() / 1000000));
+        scheduler.signal(alarmTaskId);
+        continue;
+      }
+      if (gesture.type == GESTURE_LONG_PRESS) {
+        alarms.dismiss();
+        continue;
+      }
+    }
+
+    // Long press flips between the clock and the touch test screen
+    if (gesture.type == GESTURE_LONG_PRESS
+#ifdef ENABLE_WIFI
+        && !showingSetupScreen
+#endif
+    ) {
+      showingTouchTest = !showingTouchTest;
+      drawUI();
+    }
+
+#ifdef DISPLAY_PROFILER
+    // Two-finger tap toggles the profiler overlay
+    if (gesture.type == GESTURE_TWO_FINGER_TAP) {
+      display.setProfilerOverlay(!display.isProfilerOverlayEnabled());
+    }
+#endif
+  }
+
+  // Get primary touch point
+  TouchPoint tp = touch.getTouch(0);
+
+#ifdef ENABLE_WIFI
+  // Apply WiFi state changes posted by the network task
+  WiFiStatus status;
+  while (network.pollStatus(status)) {
+    handleWiFiStatus(status);
+  }
+
+  // If showing setup screen, route all touch there
+  if (showingSetupScreen && setupScreen) {
+    if (touch.isTouched() || touch.wasReleased()) {
+      setupScreen->onTouch(tp);
+      // Repaint only widgets whose state changed
+      setupScreen->render(&display);
+    }
+  } else
+#endif
+  if (showingTouchTest) {
+    // Handle touch events - always pass to buttons (even on release)
+    if (mainScreen) {
+      mainScreen->onTouch(tp);
+
+      // Repaint only buttons whose pressed state changed
+      mainScreen->render(&display);
+    }
+
+    // Update touch display (crosshairs and coordinates)
+    updateTouchDisplay();
+  } else if (clockScreen) {
+    // Usually draws nothing; one digit cell when the time ticks over
+    updateClock();
+    clockScreen->update(&display);
+  }
+
+  display.endFrame();
+  display.present();  // Waits for VSYNC when anything changed
+}
+
+#ifdef ENABLE_WIFI
+// Fallback when the network task couldn't be created (2 Hz)
+void wifiTask(void* context) {
+  network.poll();
+}
+#endif
+
+// Alarms: runs when the next alarm is due, after edits, and at least every
+// ALARM_RECHECK_MS to notice clock steps. Nothing polls in between.
+void alarmTask(void* context) {
+  int64_t nowUs = localNowUs();
+  alarms.update((time_t)(nowUs / 1000000));
+
+  int64_t waitUs = nowUs ? ALARM_RECHECK_MS * 1000LL : 1000000;  // Not synced yet: check each second
+  time_t next = alarms.getNextFireTime();
+  if (next && nowUs) {
+    waitUs = min(waitUs, (int64_t)next * 1000000 - nowUs);
+  }
+  time_t timeout = alarms.getRingTimeout();  // Stop ringing on time, not at the next recheck
+  if (timeout && nowUs) {
+    waitUs = min(waitUs, (int64_t)timeout * 1000000 - nowUs);
+  }
+  scheduler.signalAt(alarmTaskId, esp_timer_get_time() + max(waitUs, (int64_t)0));
+}
+
+// Backlight: every sample period, or each fade step while fading
+void backlightTask(void* context) {
+  uint32_t waitMs = backlight.update();
+  scheduler.signalAt(backlightTaskId, esp_timer_get_time() + waitMs * 1000LL);
+}
+
+// Deferred settings writes (2 Hz)
+void settingsTask(void* context) {
+  settings.update();
+}
+
+// Serial diagnostics console (10 Hz): one command per line
+void consoleTask(void* context) {
+  static char line[32];
+  static uint8_t length = 0;
+
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (length < sizeof(line) - 1) line[length++] = c;
+      continue;
+    }
+    if (length == 0) continue;
+    line[length] = '\0';
+    length = 0;
+
+#ifdef ENABLE_WIFI
+    if (strcmp(line, "wifi") == 0) {
+      network.postCommand(WIFI_CMD_DUMP_METRICS);  // Printed by the network task
+      continue;
+    }
+    if (strcmp(line, "time") == 0) {
+      network.postCommand(WIFI_CMD_DUMP_TIME);
+      continue;
+    }
+    if (strcmp(line, "ntp") == 0) {
+      network.postCommand(WIFI_CMD_SYNC_TIME);
+      continue;
+    }
+#endif
+#ifdef ENABLE_AUDIO
+    if (strcmp(line, "audio") == 0) {
+      audio.dumpStats();  // Printed by the decode task
+      continue;
+    }
+    if (strcmp(line, "beep") == 0) {
+      audio.play(nullptr);
+      continue;
+    }
+#endif
+    unsigned hour, minute;
+    if (sscanf(line, "alarm %u:%u", &hour, &minute) == 2 && hour < 24 && minute < 60) {
+      // One-off test alarm
+      AlarmConfig alarm = settings.get().alarms[0];
+      alarm.hour = hour;
+      alarm.minute = minute;
+      alarm.days = 0;
+      alarm.flags = ALARM_ENABLED | ALARM_ONE_SHOT;
+      if (alarms.addAlarm(alarm) == AlarmManager::NONE) {
+        Serial.println("No free alarm slot");
+      }
+      scheduler.signal(alarmTaskId);
+      continue;
+    }
+
+    if (strcmp(line, "alarms") == 0) {
+      alarms.dump();
+    } else if (strcmp(line, "light") == 0) {
+      backlight.dump();
+    } else if (strcmp(line, "auto") == 0) {
+      settings.edit(SETTINGS_DISPLAY).autoBrightness = 1;  // Back from a manual swipe
+      scheduler.signal(backlightTaskId);
+    } else if (strcmp(line, "settings") == 0) {
+      settings.dumpStats();
+    } else if (strcmp(line, "storage") == 0) {
+      StorageManager::dumpStats();
+    } else if (strcmp(line, "tasks") == 0) {
+      scheduler.dumpStats();
+    } else {
+      Serial.println("Commands: wifi, time, ntp, audio, beep, alarms, alarm HH:MM, light, auto, settings, storage, tasks");
+    }
+  }
+}
+
+#ifdef DISPLAY_PROFILER
+// Draw and scheduling statistics every 5 seconds
+void profileTask(void* context) {
+  display.dumpProfile();
+  scheduler.dumpStats();
+  StorageManager::dumpStats();
+  settings.dumpStats();
+}
+#endif
+
 void setup() {
   // Initialize serial for debugging
   Serial.begin(115200);
@@ -158,9 +508,9 @@ void setup() {
   Serial.printf("PSRAM Size: %d bytes\n", ESP.getPsramSize());
   Serial.printf("Free PSRAM: %d bytes\n", ESP.getFreePsram());
 
-  // Initialize display
+  // Initialize display (compose off-screen, present on VSYNC)
   Serial.println("\nInitializing display...");
-  if (!display.begin()) {
+  if (!display.begin(RENDER_DOUBLE_BUFFERED)) {
     Serial.println("ERROR: Display initialization failed!");
     return;
   }
@@ -174,159 +524,90 @@ void setup() {
     display.setTextFont(4);
     display.setTextColor(TFT_RED);
     display.drawCentreString("Touch Init Failed!", display.width() / 2, display.height() / 2);
+    display.present();
     return;
   }
   Serial.println("Touch initialized successfully!");
 
+  // WiFi credentials are read from RAM after this
+  StorageManager::beginCache();
+  settings.begin();
+  display.setBrightness(settings.get().brightness);
+  backlight.begin(&display, &settings, &touch);  // Fades from there when auto is on
+  alarms.begin(&settings);
+  alarms.onAlarm(onAlarmEvent);
+
+#ifdef ENABLE_AUDIO
+  Serial.println("\nInitializing audio...");
+  audio.begin();
+#endif
+
 #ifdef ENABLE_WIFI
-  // Initialize WiFi
+  // Start WiFi on its own task (core 0); state changes come back through
+  // the network task's status queue and are drawn by the UI task
   Serial.println("\nInitializing WiFi...");
-  if (!wifiMgr.begin()) {
-    Serial.println("ERROR: WiFi initialization failed!");
-    // Continue anyway - will show setup screen
-  }
-
-  // Register WiFi state change callback
-  wifiMgr.onStateChange([](WiFiState state) {
-    Serial.printf("WiFi state changed to: %s\n", wifiMgr.getStateString());
-
-    switch (state) {
-      case WIFI_PROVISIONING:
-      case WIFI_FAILED:
-        // Show setup screen for provisioning or failure
-        showingSetupScreen = true;
-        if (!setupScreen) {
-          setupScreen = new WiFiSetupScreen();
-          setupScreen->showQRCode(true);
-
-          // Set button callbacks
-          setupScreen->setRetryCallback([]() {
-            Serial.println("Retry button pressed");
-            wifiMgr.reconnect();
-          });
-
-          setupScreen->setResetCallback([]() {
-            Serial.println("Reset button pressed");
-            wifiMgr.resetCredentials();
-          });
-        }
-
-        // Update status based on state
-        if (state == WIFI_PROVISIONING) {
-          setupScreen->setStatus("Waiting for app...");
-          setupScreen->setError("");
-        } else if (state == WIFI_FAILED) {
-          setupScreen->setError("Connection failed!");
-          setupScreen->setStatus("Tap Retry or Reset");
-        }
-
-        setupScreen->draw(&display);
-        break;
-
-      case WIFI_CONNECTING:
-        // If setup screen is showing, update status
-        if (showingSetupScreen && setupScreen) {
-          setupScreen->setError("");  // Clear error
-          setupScreen->setStatus("Connecting to WiFi...");
-          setupScreen->draw(&display);
-        } else {
-          // Connecting with saved credentials, show status on main screen
-          Serial.println("Connecting to WiFi with saved credentials...");
-          // Could add a status indicator to main UI here
-        }
-        break;
-
-      case WIFI_CONNECTED:
-        showingSetupScreen = false;
-        Serial.printf("WiFi connected! IP: %s\n", wifiMgr.getIP().toString().c_str());
-        Serial.printf("SSID: %s\n", wifiMgr.getSSID().c_str());
-        Serial.printf("RSSI: %d dBm\n", wifiMgr.getRSSI());
-        // Redraw main UI
-        drawUI();
-        break;
-
-      default:
-        break;
-    }
-  });
+  timeMgr.begin();
+  network.begin(&wifiMgr, &timeMgr);
 #else
   Serial.println("\nWiFi disabled (ENABLE_WIFI not defined) - testing PSRAM allocation...");
 #endif
 
+  // Clock face is the main screen
+  clockScreen = new ClockScreen();
+  updateClock();
+
   // Create test buttons (left side, 2x2 grid)
   // Button dimensions: 140x60 pixels with large touch targets
-  button1 = new Button(40, 120, 140, 60, "Button 1");
+  mainScreen = new TouchTestScreen();
+
+  Button* button1 = new Button(40, 120, 140, 60, "Button 1");
   button1->setColors(TFT_BLUE, TFT_WHITE, TFT_DARKGREY);
   button1->setCallback(onButton1Press);
 
-  button2 = new Button(200, 120, 140, 60, "Button 2");
+  Button* button2 = new Button(200, 120, 140, 60, "Button 2");
   button2->setColors(TFT_GREEN, TFT_BLACK, TFT_DARKGREY);
   button2->setCallback(onButton2Press);
 
-  button3 = new Button(40, 200, 140, 60, "Button 3");
+  Button* button3 = new Button(40, 200, 140, 60, "Button 3");
   button3->setColors(TFT_MAGENTA, TFT_WHITE, TFT_DARKGREY);
   button3->setCallback(onButton3Press);
 
-  button4 = new Button(200, 200, 140, 60, "Reset");
+  Button* button4 = new Button(200, 200, 140, 60, "Reset");
   button4->setColors(TFT_RED, TFT_WHITE, TFT_DARKGREY);
   button4->setCallback(onButton4Press);
 
+  mainScreen->addChild(button1);
+  mainScreen->addChild(button2);
+  mainScreen->addChild(button3);
+  mainScreen->addChild(button4);
+
   // Draw initial UI
   drawUI();
-
-  Serial.println("\n=== Phase 2 Touch Test Ready ===");
-  Serial.println("Touch the screen or press buttons to test");
-}
-
-void loop() {
-#ifdef ENABLE_WIFI
-  // Update WiFi state machine
-  wifiMgr.update();
-#endif
-
-  // Update touch state
-  touch.update();
-
-  // Get primary touch point
-  TouchPoint tp = touch.getTouch(0);
-
+  display.present();
+
+  // Register subsystem tasks with their rates
+  scheduler.begin();
+  scheduler.addPeriodic("ui", 10, uiTask);
+  scheduler.addPeriodic("settings", 500, settingsTask);
+  scheduler.addPeriodic("console", 100, consoleTask);
+  alarmTaskId = scheduler.addEvent("alarms", alarmTask, nullptr, 100);
+  scheduler.signal(alarmTaskId);
+  backlightTaskId = scheduler.addEvent("backlight", backlightTask, nullptr, 50);
+  scheduler.signal(backlightTaskId);
 #ifdef ENABLE_WIFI
-  // If showing setup screen, route all touch there
-  if (showingSetupScreen && setupScreen) {
-    if (touch.isTouched() || touch.wasReleased()) {
-      setupScreen->onTouch(tp);
-      // Redraw setup screen after touch events to update button states
-      setupScreen->draw(&display);
-    }
-    delay(10);
-    return;  // Don't process other UI
+  if (!network.isRunning()) {
+    scheduler.addPeriodic("wifi", 500, wifiTask);
   }
 #endif
+#ifdef DISPLAY_PROFILER
+  scheduler.addPeriodic("profile", 5000, profileTask, nullptr, 100);
+#endif
 
-  // Handle touch events - always pass to buttons (even on release)
-  // Pass touch to buttons
-  if (button1) button1->onTouch(tp);
-  if (button2) button2->onTouch(tp);
-  if (button3) button3->onTouch(tp);
-  if (button4) button4->onTouch(tp);
-
-  // Redraw buttons if pressed state changed
-  static bool lastPressed = false;
-  bool anyPressed = (button1 && button1->isPressed()) ||
-                    (button2 && button2->isPressed()) ||
-                    (button3 && button3->isPressed()) ||
-                    (button4 && button4->isPressed());
-
-  if (anyPressed != lastPressed) {
-    if (button1) button1->draw(&display);
-    if (button2) button2->draw(&display);
-    if (button3) button3->draw(&display);
-    if (button4) button4->draw(&display);
-    lastPressed = anyPressed;
-  }
-
-  // Update touch display (crosshairs and coordinates)
-  updateTouchDisplay();
+  Serial.println("\n=== Clock Ready ===");
+  Serial.println("Long press to switch to the touch test screen and back");
+}
 
-  delay(10);  // ~100 FPS update rate
+void loop() {
+  // Runs due tasks, then sleeps until the next one is due
+  scheduler.run();
 }
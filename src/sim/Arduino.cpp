@@ -0,0 +1,64 @@
+#include "Arduino.h"
+#include "Wire.h"
+#include <stdarg.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+TwoWire Wire;
+
+namespace sim {
+    static uint64_t clockMicros = 0;
+
+    void advanceMicros(uint64_t us) { clockMicros += us; }
+    uint64_t nowMicros() { return clockMicros; }
+}
+
+unsigned long millis() { return (unsigned long)(sim::nowMicros() / 1000); }
+unsigned long micros() { return (unsigned long)sim::nowMicros(); }
+void delay(uint32_t ms) { sim::advanceMicros((uint64_t)ms * 1000); }
+void delayMicroseconds(uint32_t us) { sim::advanceMicros(us); }
+
+long random(long howsmall, long howbig) {
+    if (howbig <= howsmall) return howsmall;
+    return howsmall + (rand() % (howbig - howsmall));
+}
+
+long random(long howbig) { return random(0, howbig); }
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t val) {}
+int digitalRead(uint8_t pin) { return HIGH; }
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {}
+void detachInterrupt(uint8_t pin) {}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n > 0 ? n : 0;
+}
+
+String::String(float value, unsigned int decimals) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    _s = buf;
+}
+
+std::string String::format(long value, unsigned char base) {
+    if (value < 0 && base == DEC) {
+        return "-" + format((unsigned long)(-value), base);
+    }
+    return format((unsigned long)value, base);
+}
+
+std::string String::format(unsigned long value, unsigned char base) {
+    if (base < 2 || base > 16) base = DEC;
+    const char* digits = "0123456789abcdef";
+    std::string out;
+    do {
+        out.insert(out.begin(), digits[value % base]);
+        value /= base;
+    } while (value > 0);
+    return out;
+}
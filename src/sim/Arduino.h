@@ -0,0 +1,160 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// Host stand-in for the Arduino-ESP32 core, used by the native simulator.
+// Time is virtual: delay() advances the clock instead of sleeping, so a
+// scripted run is deterministic and as fast as the host allows.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+using std::min;
+using std::max;
+
+#define IRAM_ATTR
+#define HEX 16
+#define DEC 10
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define LOW 0x0
+#define HIGH 0x1
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+// Virtual clock
+namespace sim {
+    void advanceMicros(uint64_t us);
+    uint64_t nowMicros();
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+long random(long howsmall, long howbig);
+long random(long howbig);
+
+// GPIO - no-ops on the host
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+// Minimal Arduino String
+class String {
+public:
+    String(const char* s = "") : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int value, unsigned char base = DEC) : _s(format((long)value, base)) {}
+    String(unsigned int value, unsigned char base = DEC) : _s(format((unsigned long)value, base)) {}
+    String(long value, unsigned char base = DEC) : _s(format(value, base)) {}
+    String(unsigned long value, unsigned char base = DEC) : _s(format(value, base)) {}
+    String(float value, unsigned int decimals = 2);
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return _s.length(); }
+    bool isEmpty() const { return _s.empty(); }
+
+    String& operator+=(const String& rhs) { _s += rhs._s; return *this; }
+    friend String operator+(const String& lhs, const String& rhs) { return String(lhs._s + rhs._s); }
+    friend String operator+(const String& lhs, const char* rhs) { return String(lhs._s + rhs); }
+    friend String operator+(const char* lhs, const String& rhs) { return String(lhs + rhs._s); }
+    bool operator==(const String& rhs) const { return _s == rhs._s; }
+    bool operator!=(const String& rhs) const { return _s != rhs._s; }
+
+private:
+    std::string _s;
+    static std::string format(long value, unsigned char base);
+    static std::string format(unsigned long value, unsigned char base);
+};
+
+// Serial goes to stdout
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) {}
+    int available() { return 0; }  // No serial input on the host
+    int read() { return -1; }
+    size_t print(const char* s) { return fputs(s, stdout) >= 0 ? strlen(s) : 0; }
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(int value) { return printf("%d", value); }
+    size_t println(const char* s = "") { size_t n = print(s); fputc('\n', stdout); return n + 1; }
+    size_t println(const String& s) { return println(s.c_str()); }
+    size_t println(int value) { return printf("%d\n", value); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+extern HardwareSerial Serial;
+
+// Chip info reports a CrowPanel-like configuration
+class EspClass {
+public:
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getFreeHeap() { return 300000; }
+    uint32_t getPsramSize() { return 8 * 1024 * 1024; }
+    uint32_t getFreePsram() { return 8 * 1024 * 1024; }
+    uint64_t getEfuseMac() { return 0x0000A1B2C3D4E5F6ULL; }
+    void restart() { exit(0); }
+};
+extern EspClass ESP;
+
+inline bool psramFound() { return true; }
+inline void* ps_malloc(size_t size) { return malloc(size); }
+
+// FreeRTOS - there is no scheduler on the host. Creation calls fail, so
+// subsystems with a polling fallback (e.g. TouchManager) use it.
+typedef void* QueueHandle_t;
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define configMAX_PRIORITIES 25
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portYIELD_FROM_ISR(...)
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) { return nullptr; }
+inline void vQueueDelete(QueueHandle_t queue) {}
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait) { return pdFALSE; }
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait) { return pdFALSE; }
+inline BaseType_t xTaskCreatePinnedToCore(void (*task)(void*), const char* name, uint32_t stack,
+                                          void* arg, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    return pdFAIL;
+}
+inline void vTaskDelete(TaskHandle_t task) {}
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+inline TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken) {}
+inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait) { return 0; }
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) { return pdPASS; }
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }  // Schedulers fall back to vTaskDelay
+// Single-threaded host: critical sections have nothing to exclude
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return nullptr; }
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return nullptr; }
+inline void vSemaphoreDelete(SemaphoreHandle_t sem) {}
+inline BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t* woken) { return pdTRUE; }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait) { return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) { return pdTRUE; }
+
+#endif // SIM_ARDUINO_H
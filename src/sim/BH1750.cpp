@@ -0,0 +1,37 @@
+#include "BH1750.h"
+#include <vector>
+
+namespace sim {
+    struct LuxStep {
+        uint32_t ms;
+        float lux;
+    };
+
+    static std::vector<LuxStep> luxSteps = {{0, 200.0f}};
+
+    bool parseLuxSchedule(const char* text) {
+        std::vector<LuxStep> steps;
+        const char* p = text;
+        while (*p) {
+            unsigned ms;
+            float lux;
+            int consumed = 0;
+            if (sscanf(p, "%u:%f%n", &ms, &lux, &consumed) != 2 || lux < 0) return false;
+            steps.push_back({ms, lux});
+            p += consumed;
+            if (*p == ',') p++;
+        }
+        if (steps.empty()) return false;
+        luxSteps = steps;
+        return true;
+    }
+}
+
+float BH1750::readLightLevel() {
+    float lux = sim::luxSteps[0].lux;
+    for (const sim::LuxStep& step : sim::luxSteps) {
+        if (step.ms > millis()) break;
+        lux = step.lux;
+    }
+    return lux;
+}
@@ -0,0 +1,34 @@
+#ifndef SIM_BH1750_H
+#define SIM_BH1750_H
+
+#include "Arduino.h"
+#include "Wire.h"
+
+// Stand-in for the claws/BH1750 driver: readLightLevel() reports the
+// ambient light the --lux schedule gives for the current virtual time
+class BH1750 {
+public:
+    enum Mode {
+        UNCONFIGURED = 0,
+        CONTINUOUS_HIGH_RES_MODE = 0x10,
+        CONTINUOUS_HIGH_RES_MODE_2 = 0x11,
+        CONTINUOUS_LOW_RES_MODE = 0x13,
+        ONE_TIME_HIGH_RES_MODE = 0x20,
+        ONE_TIME_HIGH_RES_MODE_2 = 0x21,
+        ONE_TIME_LOW_RES_MODE = 0x23
+    };
+
+    BH1750(uint8_t addr = 0x23) {}
+
+    bool begin(Mode mode = CONTINUOUS_HIGH_RES_MODE, uint8_t addr = 0x23, TwoWire* i2c = nullptr) { return true; }
+    bool measurementReady(bool maxWait = false) { return true; }
+    float readLightLevel();
+};
+
+namespace sim {
+    // Lux schedule "<ms>:<lux>[,<ms>:<lux>...]" in virtual time; each
+    // level holds until the next. Defaults to a constant 200 lux.
+    bool parseLuxSchedule(const char* text);
+}
+
+#endif // SIM_BH1750_H
@@ -0,0 +1,315 @@
+#include "SimLGFX.h"
+
+// Glyph cell metrics approximating the LovyanGFX bitmap fonts
+namespace fonts {
+    const lgfx::IFont Font0 = {6, 8};
+    const lgfx::IFont Font2 = {8, 16};
+    const lgfx::IFont Font4 = {14, 26};
+    const lgfx::IFont Font6 = {27, 48};
+    const lgfx::IFont Font7 = {32, 48};
+    const lgfx::IFont Font8 = {55, 75};
+}
+
+LovyanGFX::LovyanGFX()
+    : _fb(nullptr),
+      _width(0),
+      _height(0),
+      _font(&fonts::Font0),
+      _textFg(TFT_WHITE),
+      _textBg(TFT_BLACK),
+      _textBgSet(false),
+      _textSize(1),
+      _datum(TL_DATUM),
+      _cursorX(0),
+      _cursorY(0) {
+    clearClipRect();
+}
+
+LovyanGFX::~LovyanGFX() {
+    delete[] _fb;
+}
+
+LGFX::LGFX() : _brightness(255) {
+    _width = WIDTH;
+    _height = HEIGHT;
+    _fb = new uint16_t[WIDTH * HEIGHT];
+    memset(_fb, 0, sizeof(uint16_t) * WIDTH * HEIGHT);
+    clearClipRect();
+}
+
+void* LGFX_Sprite::createSprite(int32_t w, int32_t h) {
+    deleteSprite();
+    if (w <= 0 || h <= 0) return nullptr;
+
+    _fb = new uint16_t[w * h];
+    memset(_fb, 0, sizeof(uint16_t) * w * h);
+    _width = w;
+    _height = h;
+    clearClipRect();
+    return _fb;
+}
+
+void LGFX_Sprite::deleteSprite() {
+    delete[] _fb;
+    _fb = nullptr;
+    _width = 0;
+    _height = 0;
+    clearClipRect();
+}
+
+uint16_t LovyanGFX::color565(uint32_t rgb888) {
+    return ((rgb888 >> 8) & 0xF800) | ((rgb888 >> 5) & 0x07E0) | ((rgb888 >> 3) & 0x001F);
+}
+
+void LovyanGFX::setClipRect(int32_t x, int32_t y, int32_t w, int32_t h) {
+    _clipX0 = max(x, (int32_t)0);
+    _clipY0 = max(y, (int32_t)0);
+    _clipX1 = min(x + w, _width);
+    _clipY1 = min(y + h, _height);
+}
+
+void LovyanGFX::clearClipRect() {
+    _clipX0 = 0;
+    _clipY0 = 0;
+    _clipX1 = _width;
+    _clipY1 = _height;
+}
+
+void LovyanGFX::plot(int32_t x, int32_t y, uint16_t c) {
+    if (x < _clipX0 || x >= _clipX1 || y < _clipY0 || y >= _clipY1) return;
+    _fb[y * _width + x] = c;
+}
+
+void LovyanGFX::fillSpan(int32_t x0, int32_t x1, int32_t y, uint16_t c) {
+    if (y < _clipY0 || y >= _clipY1) return;
+    x0 = max(x0, _clipX0);
+    x1 = min(x1, _clipX1);
+    uint16_t* row = _fb + y * _width;
+    for (int32_t x = x0; x < x1; x++) {
+        row[x] = c;
+    }
+}
+
+uint16_t LovyanGFX::readPixel(int32_t x, int32_t y) const {
+    if (x < 0 || x >= _width || y < 0 || y >= _height) return 0;
+    return _fb[y * _width + x];
+}
+
+void LovyanGFX::fillScreen(uint32_t color) {
+    fillRect(0, 0, _width, _height, color);
+}
+
+void LovyanGFX::drawPixel(int32_t x, int32_t y, uint32_t color) {
+    plot(x, y, color565(color));
+}
+
+void LovyanGFX::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    uint16_t c = color565(color);
+    int32_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int32_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+    for (;;) {
+        plot(x0, y0, c);
+        if (x0 == x1 && y0 == y1) break;
+        int32_t e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+void LovyanGFX::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+    fillSpan(x, x + w, y, color565(color));
+}
+
+void LovyanGFX::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+    uint16_t c = color565(color);
+    for (int32_t i = 0; i < h; i++) {
+        plot(x, y + i, c);
+    }
+}
+
+void LovyanGFX::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    if (w <= 0 || h <= 0) return;
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+void LovyanGFX::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    uint16_t c = color565(color);
+    int32_t y1 = min(y + h, _clipY1);
+    for (int32_t row = max(y, _clipY0); row < y1; row++) {
+        fillSpan(x, x + w, row, c);
+    }
+}
+
+void LovyanGFX::drawCircle(int32_t cx, int32_t cy, int32_t r, uint32_t color) {
+    uint16_t c = color565(color);
+    int32_t x = r, y = 0, err = 1 - r;
+    while (x >= y) {
+        plot(cx + x, cy + y, c); plot(cx - x, cy + y, c);
+        plot(cx + x, cy - y, c); plot(cx - x, cy - y, c);
+        plot(cx + y, cy + x, c); plot(cx - y, cy + x, c);
+        plot(cx + y, cy - x, c); plot(cx - y, cy - x, c);
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+void LovyanGFX::fillCircle(int32_t cx, int32_t cy, int32_t r, uint32_t color) {
+    uint16_t c = color565(color);
+    for (int32_t dy = -r; dy <= r; dy++) {
+        int32_t half = (int32_t)sqrtf((float)(r * r - dy * dy));
+        fillSpan(cx - half, cx + half + 1, cy + dy, c);
+    }
+}
+
+void LovyanGFX::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    r = min(r, min(w, h) / 2);
+    uint16_t c = color565(color);
+    fillSpan(x + r, x + w - r, y, c);
+    fillSpan(x + r, x + w - r, y + h - 1, c);
+    for (int32_t i = y + r; i < y + h - r; i++) {
+        plot(x, i, c);
+        plot(x + w - 1, i, c);
+    }
+    // Corner arcs
+    for (int32_t dy = 0; dy <= r; dy++) {
+        int32_t dx = r - (int32_t)sqrtf((float)(r * r - (r - dy) * (r - dy)));
+        plot(x + dx, y + dy, c);
+        plot(x + w - 1 - dx, y + dy, c);
+        plot(x + dx, y + h - 1 - dy, c);
+        plot(x + w - 1 - dx, y + h - 1 - dy, c);
+    }
+}
+
+void LovyanGFX::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    r = min(r, min(w, h) / 2);
+    uint16_t c = color565(color);
+    for (int32_t row = 0; row < h; row++) {
+        int32_t inset = 0;
+        int32_t edge = row < r ? r - row : (row >= h - r ? row - (h - r - 1) : 0);
+        if (edge > 0) {
+            inset = r - (int32_t)sqrtf((float)(r * r - edge * edge));
+        }
+        fillSpan(x + inset, x + w - inset, y + row, c);
+    }
+}
+
+void LovyanGFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
+    if (!data) return;
+    for (int32_t row = 0; row < h; row++) {
+        int32_t py = y + row;
+        if (py < _clipY0 || py >= _clipY1) continue;
+        for (int32_t col = 0; col < w; col++) {
+            plot(x + col, py, data[row * w + col]);
+        }
+    }
+}
+
+int32_t LovyanGFX::textWidth(const char* text) const {
+    if (!text) return 0;
+    return (int32_t)(strlen(text) * _font->width * _textSize);
+}
+
+int32_t LovyanGFX::fontHeight() const {
+    return (int32_t)(_font->height * _textSize);
+}
+
+size_t LovyanGFX::drawText(const char* text, int32_t x, int32_t y, uint8_t datum) {
+    if (!text) return 0;
+
+    int32_t w = textWidth(text);
+    int32_t h = fontHeight();
+
+    // Horizontal: low bits (0 left, 1 center, 2 right); vertical: 0 top, 4 middle, 8 bottom
+    if ((datum & 3) == 1) x -= w / 2;
+    else if ((datum & 3) == 2) x -= w;
+    if ((datum & 12) == 4) y -= h / 2;
+    else if ((datum & 12) == 8) y -= h;
+
+    int32_t cw = (int32_t)(_font->width * _textSize);
+    uint16_t fg = color565(_textFg);
+    uint16_t bg = color565(_textBg);
+
+    for (const char* p = text; *p; p++) {
+        int32_t gx = x + (p - text) * cw;
+        if (_textBgSet) {
+            for (int32_t row = 0; row < h; row++) {
+                fillSpan(gx, gx + cw, y + row, bg);
+            }
+        }
+        if (*p != ' ') {
+            // Solid block inset from the cell so adjacent glyphs stay distinct
+            int32_t inX = max(cw / 8, (int32_t)1);
+            int32_t inY = max(h / 8, (int32_t)1);
+            for (int32_t row = inY; row < h - inY; row++) {
+                fillSpan(gx + inX, gx + cw - inX, y + row, fg);
+            }
+        }
+    }
+
+    return strlen(text);
+}
+
+size_t LovyanGFX::drawString(const char* text, int32_t x, int32_t y) {
+    return drawText(text, x, y, _datum);
+}
+
+size_t LovyanGFX::drawCentreString(const char* text, int32_t x, int32_t y) {
+    return drawText(text, x, y, TC_DATUM);
+}
+
+size_t LovyanGFX::drawRightString(const char* text, int32_t x, int32_t y) {
+    return drawText(text, x, y, TR_DATUM);
+}
+
+size_t LovyanGFX::print(const char* text) {
+    size_t n = drawText(text, _cursorX, _cursorY, TL_DATUM);
+    _cursorX += textWidth(text);
+    return n;
+}
+
+size_t LovyanGFX::print(int value) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", value);
+    return print(buf);
+}
+
+size_t LovyanGFX::println(const char* text) {
+    size_t n = print(text);
+    _cursorX = 0;
+    _cursorY += fontHeight();
+    return n;
+}
+
+size_t LovyanGFX::println(int value) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", value);
+    return println(buf);
+}
+
+bool LGFX::writePPM(const char* path) const {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    fprintf(f, "P6\n%d %d\n255\n", (int)_width, (int)_height);
+    for (int32_t i = 0; i < _width * _height; i++) {
+        uint16_t c = _fb[i];
+        uint8_t rgb[3] = {
+            (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+            (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+            (uint8_t)((c & 0x1F) * 255 / 31)
+        };
+        fwrite(rgb, 1, 3, f);
+    }
+
+    fclose(f);
+    return true;
+}
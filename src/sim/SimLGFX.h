@@ -0,0 +1,184 @@
+#ifndef SIM_LGFX_H
+#define SIM_LGFX_H
+
+// Host stand-in for the LovyanGFX device configured in LGFX_CrowPanel.h.
+// Renders into an in-memory 800x480 RGB565 framebuffer that can be dumped
+// to a PPM image or compared pixel-for-pixel. Text is drawn as solid glyph
+// blocks with each font's cell metrics - enough for layout, draw-cost and
+// regression checks, not for reading.
+
+#include "Arduino.h"
+
+namespace lgfx {
+    struct IFont {
+        uint8_t width;   // Average glyph advance
+        uint8_t height;
+    };
+
+    // Native-order RGB565 pixel
+    struct rgb565_t {
+        uint16_t raw;
+    };
+}
+
+namespace fonts {
+    extern const lgfx::IFont Font0;
+    extern const lgfx::IFont Font2;
+    extern const lgfx::IFont Font4;
+    extern const lgfx::IFont Font6;
+    extern const lgfx::IFont Font7;
+    extern const lgfx::IFont Font8;
+}
+
+// Colors (RGB565 values, as in LovyanGFX)
+static const int TFT_BLACK       = 0x0000;
+static const int TFT_NAVY        = 0x000F;
+static const int TFT_DARKGREEN   = 0x03E0;
+static const int TFT_DARKCYAN    = 0x03EF;
+static const int TFT_MAROON      = 0x7800;
+static const int TFT_PURPLE      = 0x780F;
+static const int TFT_OLIVE       = 0x7BE0;
+static const int TFT_LIGHTGREY   = 0xD69A;
+static const int TFT_DARKGREY    = 0x7BEF;
+static const int TFT_BLUE        = 0x001F;
+static const int TFT_GREEN       = 0x07E0;
+static const int TFT_CYAN        = 0x07FF;
+static const int TFT_RED         = 0xF800;
+static const int TFT_MAGENTA     = 0xF81F;
+static const int TFT_YELLOW      = 0xFFE0;
+static const int TFT_WHITE       = 0xFFFF;
+static const int TFT_ORANGE      = 0xFDA0;
+static const int TFT_GREENYELLOW = 0xB7E0;
+static const int TFT_PINK        = 0xFE19;
+
+// Text datums
+static const uint8_t TL_DATUM = 0;
+static const uint8_t TC_DATUM = 1;
+static const uint8_t TR_DATUM = 2;
+static const uint8_t ML_DATUM = 4;
+static const uint8_t MC_DATUM = 5;
+static const uint8_t MR_DATUM = 6;
+static const uint8_t BL_DATUM = 8;
+static const uint8_t BC_DATUM = 9;
+static const uint8_t BR_DATUM = 10;
+
+// Drawing surface shared by the device and sprites (lgfx::LovyanGFX)
+class LovyanGFX {
+public:
+    LovyanGFX();
+    virtual ~LovyanGFX();
+
+    int32_t width() const { return _width; }
+    int32_t height() const { return _height; }
+
+    // Clipping
+    void setClipRect(int32_t x, int32_t y, int32_t w, int32_t h);
+    void clearClipRect();
+
+    // Primitives. 32-bit colors are interpreted as RGB888, matching how
+    // LovyanGFX converts uint32_t color arguments.
+    void fillScreen(uint32_t color);
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const lgfx::rgb565_t* data) {
+        pushImage(x, y, w, h, reinterpret_cast<const uint16_t*>(data));
+    }
+
+    // Text
+    void setFont(const lgfx::IFont* font) { _font = font ? font : &fonts::Font0; }
+    void setTextColor(uint32_t color) { _textFg = color; _textBgSet = false; }
+    void setTextColor(uint32_t fg, uint32_t bg) { _textFg = fg; _textBg = bg; _textBgSet = true; }
+    void setTextSize(float size) { _textSize = size > 0 ? size : 1; }
+    void setTextDatum(uint8_t datum) { _datum = datum; }
+    void setCursor(int32_t x, int32_t y) { _cursorX = x; _cursorY = y; }
+    uint8_t getTextDatum() const { return _datum; }
+    int32_t getCursorX() const { return _cursorX; }
+    int32_t getCursorY() const { return _cursorY; }
+    int32_t textWidth(const char* text) const;
+    int32_t fontHeight() const;
+    size_t drawString(const char* text, int32_t x, int32_t y);
+    size_t drawCentreString(const char* text, int32_t x, int32_t y);
+    size_t drawRightString(const char* text, int32_t x, int32_t y);
+    size_t print(const char* text);
+    size_t print(int value);
+    size_t println(const char* text);
+    size_t println(int value);
+
+    // Simulator access
+    const uint16_t* getFramebuffer() const { return _fb; }
+    uint16_t readPixel(int32_t x, int32_t y) const;
+    static uint16_t color565(uint32_t rgb888);
+
+protected:
+    uint16_t* _fb;
+    int32_t _width;
+    int32_t _height;
+
+    int32_t _clipX0, _clipY0, _clipX1, _clipY1;  // Inclusive-exclusive
+
+    const lgfx::IFont* _font;
+    uint32_t _textFg;
+    uint32_t _textBg;
+    bool _textBgSet;
+    float _textSize;
+    uint8_t _datum;
+    int32_t _cursorX, _cursorY;
+
+    void fillSpan(int32_t x0, int32_t x1, int32_t y, uint16_t c);  // x1 exclusive
+    void plot(int32_t x, int32_t y, uint16_t c);
+    size_t drawText(const char* text, int32_t x, int32_t y, uint8_t datum);
+};
+
+namespace lgfx {
+    typedef ::LovyanGFX LovyanGFX;
+}
+
+class LGFX : public LovyanGFX {
+public:
+    static const int32_t WIDTH = 800;
+    static const int32_t HEIGHT = 480;
+
+    LGFX();
+
+    bool init() { return true; }
+    void setRotation(uint8_t rotation) {}
+    void setBrightness(uint8_t brightness) { _brightness = brightness; }
+    uint8_t getBrightness() const { return _brightness; }
+    void display() {}  // Panel_RGB cache write-back; nothing to do here
+
+    bool writePPM(const char* path) const;
+
+private:
+    uint8_t _brightness;
+};
+
+// Off-screen RGB565 canvas (LGFX_Sprite)
+class LGFX_Sprite : public LovyanGFX {
+public:
+    explicit LGFX_Sprite(LovyanGFX* parent = nullptr) : _parent(parent) {}
+
+    void setColorDepth(uint8_t bits) {}  // Always 16-bit
+    void setPsram(bool enabled) {}
+    void* createSprite(int32_t w, int32_t h);
+    void deleteSprite();
+    void* getBuffer() const { return _fb; }
+
+    void pushSprite(int32_t x, int32_t y) { pushSprite(_parent, x, y); }
+    void pushSprite(LovyanGFX* dst, int32_t x, int32_t y) {
+        if (dst && _fb) dst->pushImage(x, y, _width, _height, _fb);
+    }
+
+private:
+    LovyanGFX* _parent;
+};
+
+#endif // SIM_LGFX_H
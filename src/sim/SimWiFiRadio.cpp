@@ -0,0 +1,186 @@
+#include "SimWiFiRadio.h"
+
+// wifi_err_reason_t values the fake produces
+static const uint8_t REASON_ASSOC_LEAVE = 8;
+static const uint8_t REASON_4WAY_HANDSHAKE_TIMEOUT = 15;
+static const uint8_t REASON_BEACON_TIMEOUT = 200;
+static const uint8_t REASON_NO_AP_FOUND = 201;
+
+// wl_status_t values
+static const int STATUS_NO_SSID_AVAIL = 1;
+static const int STATUS_CONNECTED = 3;
+static const int STATUS_DISCONNECTED = 6;
+
+// The DHCP lease the AP hands out (IPAddress byte order)
+static const uint32_t LEASE_IP = 0x3201A8C0;       // 192.168.1.50
+static const uint32_t GATEWAY_IP = 0x0101A8C0;     // 192.168.1.1
+static const uint32_t SUBNET_MASK = 0x00FFFFFF;    // 255.255.255.0
+static const uint8_t AP_BSSID[6] = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+
+SimWiFiRadio::SimWiFiRadio()
+    : _callback(nullptr),
+      _context(nullptr),
+      _apChannel(6),
+      _apUp(true),
+      _connected(false),
+      _provisioning(false),
+      _attempting(false),
+      _attemptProvisioned(false),
+      _attemptDue(0),
+      _attemptSucceeds(false),
+      _attemptReason(0),
+      _channel(0),
+      _ip(0),
+      _connectCalls(0),
+      _fastJoins(0) {
+    _apSsid[0] = '\0';
+    _apPassword[0] = '\0';
+}
+
+void SimWiFiRadio::begin(EventCallback callback, void* context) {
+    _callback = callback;
+    _context = context;
+}
+
+void SimWiFiRadio::connect(const char* ssid, const char* password, const WiFiFastConnect* fast) {
+    _connectCalls++;
+    _connected = false;
+    _attempting = true;
+    _attemptProvisioned = false;
+
+    bool known = _apUp && !strcmp(ssid, _apSsid);
+    if (fast) {
+        _fastJoins++;
+
+        // Targeted join: quick if the AP is still where it was, otherwise
+        // the probe goes unanswered and the station just sits there (the
+        // caller's fast-connect timeout covers this)
+        _attemptSucceeds = known && !strcmp(password, _apPassword) && fast->channel == _apChannel &&
+                           !memcmp(fast->bssid, AP_BSSID, sizeof(AP_BSSID));
+        _attemptDue = millis() + (_attemptSucceeds ? FAST_CONNECT_MS : UINT32_MAX / 2);
+        _attemptReason = 0;
+        _ip = LEASE_IP;
+        Serial.printf("[SimRadio] fast join ch %u (AP %s ch %u)\n", fast->channel,
+                      _apUp ? "up" : "down", _apChannel);
+        return;
+    }
+
+    _attemptDue = millis() + SCAN_CONNECT_MS;
+    _attemptSucceeds = known && !strcmp(password, _apPassword);
+    _attemptReason = !known ? REASON_NO_AP_FOUND : REASON_4WAY_HANDSHAKE_TIMEOUT;
+    _ip = LEASE_IP;
+    Serial.printf("[SimRadio] scan join (AP %s ch %u)\n", _apUp ? "up" : "down", _apChannel);
+}
+
+void SimWiFiRadio::disconnect(bool radioOff) {
+    bool wasActive = _connected || _attempting;
+    _connected = false;
+    _attempting = false;
+    if (wasActive) {
+        emit(WIFI_EVT_DISCONNECTED, REASON_ASSOC_LEAVE);
+    }
+}
+
+int SimWiFiRadio::getStatus() {
+    if (_connected) return STATUS_CONNECTED;
+    return _apUp ? STATUS_DISCONNECTED : STATUS_NO_SSID_AVAIL;
+}
+
+bool SimWiFiRadio::getConnection(WiFiFastConnect& info) {
+    memset(&info, 0, sizeof(info));
+    if (!_connected) return false;
+
+    memcpy(info.ssid, _apSsid, strnlen(_apSsid, sizeof(info.ssid) - 1));  // info is zeroed
+    memcpy(info.bssid, AP_BSSID, sizeof(info.bssid));
+    info.channel = _channel;
+    info.ip = _ip;
+    info.gateway = GATEWAY_IP;
+    info.subnet = SUBNET_MASK;
+    info.dns = GATEWAY_IP;
+    return true;
+}
+
+void SimWiFiRadio::startProvisioning() {
+    Serial.println("[SimRadio] provisioning started");
+    _provisioning = true;
+}
+
+const char* SimWiFiRadio::getReasonName(uint8_t reason) {
+    switch (reason) {
+        case REASON_ASSOC_LEAVE: return "ASSOC_LEAVE";
+        case REASON_4WAY_HANDSHAKE_TIMEOUT: return "4WAY_HANDSHAKE_TIMEOUT";
+        case REASON_BEACON_TIMEOUT: return "BEACON_TIMEOUT";
+        case REASON_NO_AP_FOUND: return "NO_AP_FOUND";
+        default: return "UNSPECIFIED";
+    }
+}
+
+void SimWiFiRadio::setNetwork(const char* ssid, const char* password, uint8_t channel) {
+    strncpy(_apSsid, ssid, sizeof(_apSsid) - 1);
+    _apSsid[sizeof(_apSsid) - 1] = '\0';
+    strncpy(_apPassword, password, sizeof(_apPassword) - 1);
+    _apPassword[sizeof(_apPassword) - 1] = '\0';
+    if (channel) _apChannel = channel;
+    _apUp = true;
+}
+
+void SimWiFiRadio::setAccessPoint(bool up, uint8_t channel) {
+    if (channel) _apChannel = channel;
+    _apUp = up;
+
+    // Stations notice a vanished AP by missed beacons
+    if (!up && _connected) {
+        dropLink(REASON_BEACON_TIMEOUT);
+    }
+}
+
+void SimWiFiRadio::dropLink(uint8_t reason) {
+    if (!_connected) return;
+    _connected = false;
+    emit(WIFI_EVT_DISCONNECTED, reason);
+}
+
+bool SimWiFiRadio::provision(const char* ssid, const char* password) {
+    if (!_provisioning) {
+        Serial.println("[SimRadio] not provisioning, credentials ignored");
+        return false;
+    }
+
+    // The provisioning manager stores and tries the credentials itself
+    emit(WIFI_EVT_PROV_CRED_RECV, 0, ssid, password);
+    connect(ssid, password, nullptr);
+    _attemptProvisioned = true;
+    return true;
+}
+
+void SimWiFiRadio::update() {
+    if (!_attempting || (long)(millis() - _attemptDue) < 0) return;
+
+    _attempting = false;
+    if (_attemptSucceeds) {
+        _connected = true;
+        _channel = _apChannel;
+        if (_attemptProvisioned) {
+            _provisioning = false;
+            emit(WIFI_EVT_PROV_SUCCESS);
+        }
+        emit(WIFI_EVT_GOT_IP);
+    } else if (_attemptProvisioned) {
+        emit(WIFI_EVT_PROV_FAIL);
+    } else {
+        emit(WIFI_EVT_DISCONNECTED, _attemptReason);
+    }
+}
+
+void SimWiFiRadio::emit(WiFiStackEventType type, uint8_t reason, const char* ssid, const char* password) {
+    if (!_callback) return;
+
+    WiFiStackEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.timestamp = millis();
+    event.reason = reason;
+    if (ssid) strncpy(event.ssid, ssid, sizeof(event.ssid) - 1);
+    if (password) strncpy(event.password, password, sizeof(event.password) - 1);
+    _callback(event, _context);
+}
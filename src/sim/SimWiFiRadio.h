@@ -0,0 +1,67 @@
+#ifndef SIM_WIFI_RADIO_H
+#define SIM_WIFI_RADIO_H
+
+#include <Arduino.h>
+#include "../WiFiRadio.h"
+
+// Scripted stand-in for the WiFi stack. One access point that a script can
+// take down, bring back on another channel or kick the station off; joins
+// complete after the latencies of a real scan/DHCP or targeted join, all on
+// the virtual clock. Events are delivered from update().
+class SimWiFiRadio : public WiFiRadio {
+public:
+    static const uint32_t SCAN_CONNECT_MS = 2800;  // Channel scan + DHCP
+    static const uint32_t FAST_CONNECT_MS = 900;   // Known BSSID/channel + DHCP
+
+    SimWiFiRadio();
+
+    // WiFiRadio
+    void begin(EventCallback callback, void* context) override;
+    uint32_t now() override { return millis(); }
+    void connect(const char* ssid, const char* password, const WiFiFastConnect* fast) override;
+    void disconnect(bool radioOff = false) override;
+    bool isConnected() override { return _connected; }
+    int getStatus() override;
+    bool getConnection(WiFiFastConnect& info) override;
+    int8_t getRSSI() override { return _connected ? -55 : 0; }
+    void startProvisioning() override;
+    const char* getReasonName(uint8_t reason) override;
+
+    // Script controls
+    void setNetwork(const char* ssid, const char* password, uint8_t channel);
+    void setAccessPoint(bool up, uint8_t channel = 0);  // 0 keeps the channel
+    void dropLink(uint8_t reason);                        // Station kicked off
+    bool provision(const char* ssid, const char* password);  // Phone app sends credentials
+
+    void update();  // Deliver events that are due
+
+    uint32_t getConnectCalls() const { return _connectCalls; }
+    uint32_t getFastJoins() const { return _fastJoins; }      // Of those, targeted BSSID/channel joins
+
+private:
+    EventCallback _callback;
+    void* _context;
+
+    // Access point
+    char _apSsid[33];
+    char _apPassword[65];
+    uint8_t _apChannel;
+    bool _apUp;
+
+    // Station
+    bool _connected;
+    bool _provisioning;
+    bool _attempting;
+    bool _attemptProvisioned;  // Started by provision(), reports PROV_* first
+    uint32_t _attemptDue;
+    bool _attemptSucceeds;
+    uint8_t _attemptReason;    // Disconnect reason when it fails
+    uint8_t _channel;
+    uint32_t _ip;
+    uint32_t _connectCalls;
+    uint32_t _fastJoins;
+
+    void emit(WiFiStackEventType type, uint8_t reason = 0, const char* ssid = nullptr, const char* password = nullptr);
+};
+
+#endif // SIM_WIFI_RADIO_H
@@ -0,0 +1,85 @@
+#include "TAMC_GT911.h"
+#include <vector>
+
+namespace sim {
+    struct TouchFrame {
+        uint32_t ms;
+        uint8_t count;
+        uint16_t x[5];
+        uint16_t y[5];
+    };
+
+    static std::vector<TouchFrame> touchFrames;
+
+    bool parseTouchScript(const char* text) {
+        touchFrames.clear();
+
+        const char* line = text;
+        while (line && *line) {
+            const char* end = strchr(line, '\n');
+            std::string s(line, end ? end - line : strlen(line));
+            line = end ? end + 1 : nullptr;
+
+            if (s.empty() || s[0] == '#') continue;
+
+            TouchFrame frame = {};
+            unsigned ms;
+            int consumed = 0;
+            if (sscanf(s.c_str(), "%u%n", &ms, &consumed) != 1) continue;
+            frame.ms = ms;
+
+            const char* p = s.c_str() + consumed;
+            while (*p == ' ' || *p == '\t') p++;
+
+            if (strncmp(p, "up", 2) != 0) {
+                unsigned x, y;
+                int n;
+                while (frame.count < 5 && sscanf(p, "%u %u%n", &x, &y, &n) == 2) {
+                    frame.x[frame.count] = x;
+                    frame.y[frame.count] = y;
+                    frame.count++;
+                    p += n;
+                }
+            }
+            touchFrames.push_back(frame);
+        }
+
+        return !touchFrames.empty();
+    }
+
+    bool loadTouchScript(const char* path) {
+        FILE* f = fopen(path, "r");
+        if (!f) return false;
+
+        std::string text;
+        char buf[256];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+            text.append(buf, n);
+        }
+        fclose(f);
+
+        return parseTouchScript(text.c_str());
+    }
+
+    uint32_t touchScriptEndMs() {
+        return touchFrames.empty() ? 0 : touchFrames.back().ms;
+    }
+}
+
+void TAMC_GT911::read() {
+    // Latest frame at or before now
+    uint32_t now = millis();
+    const sim::TouchFrame* current = nullptr;
+    for (size_t i = 0; i < sim::touchFrames.size(); i++) {
+        if (sim::touchFrames[i].ms > now) break;
+        current = &sim::touchFrames[i];
+    }
+
+    touches = current ? current->count : 0;
+    isTouched = touches > 0;
+    for (uint8_t i = 0; i < touches; i++) {
+        // Finger slot doubles as the track id, like the GT911 for steady contacts
+        points[i] = TP_Point(i, current->x[i], current->y[i], 10);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef SIM_TAMC_GT911_H
+#define SIM_TAMC_GT911_H
+
+#include "Arduino.h"
+
+#define ROTATION_LEFT      0
+#define ROTATION_INVERTED  1
+#define ROTATION_RIGHT     2
+#define ROTATION_NORMAL    3
+
+class TP_Point {
+public:
+    TP_Point() : id(0), x(0), y(0), size(0) {}
+    TP_Point(uint8_t id, uint16_t x, uint16_t y, uint16_t size) : id(id), x(x), y(y), size(size) {}
+
+    uint8_t id;
+    uint16_t x;
+    uint16_t y;
+    uint8_t size;
+};
+
+// Scripted stand-in for the GT911 driver: read() reports whatever the
+// loaded touch script says is on the panel at the current virtual time
+class TAMC_GT911 {
+public:
+    TAMC_GT911(uint8_t sda, uint8_t scl, uint8_t intPin, uint8_t rstPin, uint16_t width, uint16_t height) {}
+
+    void begin(uint8_t address = 0x5D) {}
+    void setRotation(uint8_t rotation) {}
+    void read();
+
+    bool isTouched = false;
+    uint8_t touches = 0;
+    TP_Point points[5];
+};
+
+namespace sim {
+    // Touch script, one frame per line (times in ms of virtual time):
+    //   <ms> up
+    //   <ms> <x> <y> [<x2> <y2> ...]    up to 5 fingers
+    // Each frame holds until the next one. Lines starting with # are comments.
+    bool loadTouchScript(const char* path);
+    bool parseTouchScript(const char* text);
+    uint32_t touchScriptEndMs();  // Time of the last frame
+}
+
+#endif // SIM_TAMC_GT911_H
@@ -0,0 +1,133 @@
+#include "WiFiScript.h"
+#include "SimWiFiRadio.h"
+#include "../WiFiManager.h"
+#include "../StorageManager.h"
+
+static void printWiFiState(WiFiState state) {
+    printf("[%7lu ms] state -> %s\n", millis(), WiFiManager::getStateString(state));
+}
+
+int sim::runWiFiScript(const char* path, uint32_t runMs) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "ERROR: could not open WiFi script %s\n", path);
+        return -1;
+    }
+
+    static const uint8_t MAX_STEPS = 128;
+    struct Step {
+        uint32_t ms;
+        char command[16];
+        char arg1[65];
+        char arg2[65];
+        char arg3[16];
+        char rest[65];     // Everything after the command, for expect
+    };
+    static Step steps[MAX_STEPS];
+    uint8_t stepCount = 0;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) && stepCount < MAX_STEPS) {
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        line[strcspn(line, "\r\n")] = '\0';
+
+        Step& step = steps[stepCount];
+        memset(&step, 0, sizeof(step));
+        int consumed = 0;
+        unsigned long ms;
+        if (sscanf(line, "%lu %15s %n", &ms, step.command, &consumed) < 2) continue;
+        step.ms = ms;
+        strncpy(step.rest, line + consumed, sizeof(step.rest) - 1);
+        sscanf(step.rest, "%64s %64s %15s", step.arg1, step.arg2, step.arg3);
+        stepCount++;
+    }
+    fclose(file);
+
+    StorageManager::clearWiFiCredentials();
+
+    SimWiFiRadio radio;
+    WiFiManager wifi(&radio);
+    BackoffRetryPolicy policy;
+    wifi.onStateChange(printWiFiState);
+
+    // Time-0 setup that has to exist before begin()
+    uint8_t next = 0;
+    while (next < stepCount && steps[next].ms == 0 &&
+           (!strcmp(steps[next].command, "creds") || !strcmp(steps[next].command, "network") ||
+            !strcmp(steps[next].command, "policy"))) {
+        const Step& step = steps[next++];
+        if (!strcmp(step.command, "creds")) {
+            StorageManager::saveWiFiCredentials(step.arg1, step.arg2);
+        } else if (!strcmp(step.command, "policy")) {
+            policy = BackoffRetryPolicy(strtoul(step.arg1, nullptr, 10), strtoul(step.arg2, nullptr, 10),
+                                        atoi(step.arg3));
+            wifi.setRetryPolicy(&policy);
+        } else {
+            radio.setNetwork(step.arg1, step.arg2, atoi(step.arg3));
+        }
+    }
+
+    wifi.begin();
+
+    uint32_t start = millis();
+    uint32_t endMs = runMs ? runMs : (stepCount ? steps[stepCount - 1].ms : 0) + 1000;
+    int failures = 0;
+
+    while (millis() - start <= endMs) {
+        uint32_t now = millis() - start;
+        while (next < stepCount && steps[next].ms <= now) {
+            const Step& step = steps[next++];
+            printf("[%7lu ms] > %s %s\n", millis(), step.command, step.rest);
+
+            if (!strcmp(step.command, "network")) {
+                radio.setNetwork(step.arg1, step.arg2, atoi(step.arg3));
+            } else if (!strcmp(step.command, "ap")) {
+                radio.setAccessPoint(!strcmp(step.arg1, "up"), atoi(step.arg2));
+            } else if (!strcmp(step.command, "drop")) {
+                radio.dropLink(step.arg1[0] ? atoi(step.arg1) : 200);
+            } else if (!strcmp(step.command, "prov")) {
+                radio.provision(step.arg1, step.arg2);
+            } else if (!strcmp(step.command, "reconnect")) {
+                wifi.reconnect();
+            } else if (!strcmp(step.command, "reset")) {
+                wifi.resetCredentials();
+            } else if (!strcmp(step.command, "dump")) {
+                wifi.dumpMetrics();
+            } else if (!strcmp(step.command, "expect")) {
+                if (strcmp(wifi.getStateString(), step.rest) != 0) {
+                    printf("FAIL: expected %s, state is %s\n", step.rest, wifi.getStateString());
+                    failures++;
+                }
+            } else if (!strcmp(step.command, "expect-calls")) {
+                uint32_t calls = strtoul(step.arg1, nullptr, 10);
+                if (radio.getConnectCalls() != calls ||
+                    (step.arg2[0] && radio.getFastJoins() != strtoul(step.arg2, nullptr, 10))) {
+                    printf("FAIL: expected %s joins, radio saw %u (%u fast)\n", step.rest,
+                           radio.getConnectCalls(), radio.getFastJoins());
+                    failures++;
+                }
+            } else if (!strcmp(step.command, "expect-ip")) {
+                uint32_t ip = wifi.getIP();
+                char actual[16];
+                snprintf(actual, sizeof(actual), "%u.%u.%u.%u", (unsigned)(ip & 0xFF),
+                         (unsigned)((ip >> 8) & 0xFF), (unsigned)((ip >> 16) & 0xFF), (unsigned)(ip >> 24));
+                if (strcmp(actual, step.arg1) != 0) {
+                    printf("FAIL: expected IP %s, got %s\n", step.arg1, actual);
+                    failures++;
+                }
+            } else {
+                fprintf(stderr, "WARNING: unknown WiFi script command '%s'\n", step.command);
+            }
+        }
+
+        radio.update();
+        wifi.update();
+        delay(10);
+    }
+
+    wifi.dumpMetrics();
+    printf("\nWiFi script done: %u steps, %u connect calls, %d failed expects\n",
+           stepCount, radio.getConnectCalls(), failures);
+    return failures;
+}
@@ -0,0 +1,28 @@
+#ifndef SIM_WIFI_SCRIPT_H
+#define SIM_WIFI_SCRIPT_H
+
+#include <Arduino.h>
+
+namespace sim {
+    // Runs WiFiManager alone against SimWiFiRadio, replaying a script on
+    // the virtual clock. Each line is "<ms> <command> [args]", in time
+    // order, ms counted from the start of the script; '#' starts a comment:
+    //   creds <ssid> <password>      saved credentials (time 0 only, before begin)
+    //   network <ssid> <password> [channel]   the access point's configuration
+    //   policy <baseMs> <maxMs> [jitter%]     backoff schedule, jitter defaults to 0 (time 0 only)
+    //   ap up [channel] | ap down    power the AP (optionally on a new channel)
+    //   drop [reason]                kick the station off (default BEACON_TIMEOUT)
+    //   prov <ssid> <password>       credentials arriving over BLE provisioning
+    //   reconnect | reset            WiFiManager::reconnect() / resetCredentials()
+    //   dump                         print WiFiManager metrics
+    //   expect <state>               fail unless in this state (getStateString)
+    //   expect-calls <n> [fast]      fail unless the radio saw n joins so far,
+    //                                fast of them targeted (BSSID/channel)
+    //   expect-ip <a.b.c.d>          fail unless WiFiManager reports this address
+    // Saved WiFi credentials are wiped first, so scripts don't see each
+    // other's state. runMs = 0 runs until a second after the last line.
+    // Returns the number of failed expects, -1 if the script can't be read.
+    int runWiFiScript(const char* path, uint32_t runMs = 0);
+}
+
+#endif // SIM_WIFI_SCRIPT_H
@@ -0,0 +1,19 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include "Arduino.h"
+
+// I2C is not simulated; devices are stood in for at the driver level
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+    void beginTransmission(uint8_t address) {}
+    uint8_t endTransmission(bool sendStop = true) { return 2; }  // NACK - no device
+    uint8_t requestFrom(uint8_t address, uint8_t quantity) { return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+    size_t write(uint8_t data) { return 1; }
+};
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
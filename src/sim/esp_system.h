@@ -0,0 +1,11 @@
+#ifndef SIM_ESP_SYSTEM_H
+#define SIM_ESP_SYSTEM_H
+
+#include "Arduino.h"
+
+// Nothing restarts in the simulator, so shutdown handlers never run
+typedef void (*shutdown_handler_t)(void);
+inline int esp_register_shutdown_handler(shutdown_handler_t handler) { return 0; }
+inline int esp_unregister_shutdown_handler(shutdown_handler_t handler) { return 0; }
+
+#endif // SIM_ESP_SYSTEM_H
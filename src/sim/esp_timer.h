@@ -0,0 +1,8 @@
+#ifndef SIM_ESP_TIMER_H
+#define SIM_ESP_TIMER_H
+
+#include "Arduino.h"
+
+inline int64_t esp_timer_get_time() { return (int64_t)sim::nowMicros(); }
+
+#endif // SIM_ESP_TIMER_H
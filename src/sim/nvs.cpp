@@ -0,0 +1,184 @@
+#include "nvs.h"
+#include <map>
+#include <vector>
+
+namespace {
+
+struct Value {
+    nvs_type_t type;
+    std::vector<uint8_t> data;
+};
+
+typedef std::map<std::string, Value> Namespace;
+
+std::map<std::string, Namespace> store;
+std::map<nvs_handle_t, std::string> handles;
+nvs_handle_t nextHandle = 1;
+
+Namespace* lookup(nvs_handle_t handle) {
+    auto it = handles.find(handle);
+    return it == handles.end() ? nullptr : &store[it->second];
+}
+
+esp_err_t setValue(nvs_handle_t handle, const char* key, nvs_type_t type, const void* value, size_t length) {
+    Namespace* ns = lookup(handle);
+    if (!ns || strlen(key) >= NVS_KEY_NAME_MAX_SIZE) return ESP_ERR_INVALID_ARG;
+
+    Value& entry = (*ns)[key];
+    entry.type = type;
+    entry.data.assign((const uint8_t*)value, (const uint8_t*)value + length);
+    return ESP_OK;
+}
+
+const Value* getValue(nvs_handle_t handle, const char* key, nvs_type_t type, esp_err_t& err) {
+    Namespace* ns = lookup(handle);
+    if (!ns) {
+        err = ESP_ERR_INVALID_ARG;
+        return nullptr;
+    }
+    auto it = ns->find(key);
+    if (it == ns->end()) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+        return nullptr;
+    }
+    if (it->second.type != type) {
+        err = ESP_ERR_NVS_TYPE_MISMATCH;
+        return nullptr;
+    }
+    err = ESP_OK;
+    return &it->second;
+}
+
+esp_err_t getVariable(nvs_handle_t handle, const char* key, nvs_type_t type, void* out, size_t* length) {
+    esp_err_t err;
+    const Value* value = getValue(handle, key, type, err);
+    if (!value) return err;
+
+    if (!out) {
+        *length = value->data.size();
+        return ESP_OK;
+    }
+    if (*length < value->data.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+
+    memcpy(out, value->data.data(), value->data.size());
+    *length = value->data.size();
+    return ESP_OK;
+}
+
+}  // namespace
+
+struct sim_nvs_iterator {
+    std::string ns;
+    nvs_type_t type;
+    Namespace::const_iterator it;
+};
+
+const char* esp_err_to_name(esp_err_t err) {
+    switch (err) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+        case ESP_ERR_NVS_INVALID_LENGTH: return "ESP_ERR_NVS_INVALID_LENGTH";
+        case ESP_ERR_NVS_TYPE_MISMATCH: return "ESP_ERR_NVS_TYPE_MISMATCH";
+        default: return "ESP_FAIL";
+    }
+}
+
+esp_err_t nvs_open(const char* name, nvs_open_mode_t open_mode, nvs_handle_t* out_handle) {
+    if (open_mode == NVS_READONLY && store.find(name) == store.end()) {
+        return ESP_ERR_NVS_NOT_FOUND;  // Namespaces exist from their first write
+    }
+    store[name];
+    *out_handle = nextHandle++;
+    handles[*out_handle] = name;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) { handles.erase(handle); }
+esp_err_t nvs_commit(nvs_handle_t handle) { return lookup(handle) ? ESP_OK : ESP_ERR_INVALID_ARG; }
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char* key, uint8_t value) {
+    return setValue(handle, key, NVS_TYPE_U8, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char* key, uint32_t value) {
+    return setValue(handle, key, NVS_TYPE_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char* key, const char* value) {
+    return setValue(handle, key, NVS_TYPE_STR, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length) {
+    return setValue(handle, key, NVS_TYPE_BLOB, value, length);
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char* key, uint8_t* out_value) {
+    size_t length = sizeof(*out_value);
+    return getVariable(handle, key, NVS_TYPE_U8, out_value, &length);
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char* key, uint32_t* out_value) {
+    size_t length = sizeof(*out_value);
+    return getVariable(handle, key, NVS_TYPE_U32, out_value, &length);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char* key, char* out_value, size_t* length) {
+    return getVariable(handle, key, NVS_TYPE_STR, out_value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length) {
+    return getVariable(handle, key, NVS_TYPE_BLOB, out_value, length);
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+    Namespace* ns = lookup(handle);
+    if (!ns) return ESP_ERR_INVALID_ARG;
+    return ns->erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle) {
+    Namespace* ns = lookup(handle);
+    if (!ns) return ESP_ERR_INVALID_ARG;
+    ns->clear();
+    return ESP_OK;
+}
+
+static nvs_iterator_t skipToMatch(nvs_iterator_t iterator) {
+    const Namespace& ns = store[iterator->ns];
+    while (iterator->it != ns.end() && iterator->type != NVS_TYPE_ANY && iterator->it->second.type != iterator->type) {
+        ++iterator->it;
+    }
+    if (iterator->it == ns.end()) {
+        delete iterator;
+        return nullptr;
+    }
+    return iterator;
+}
+
+nvs_iterator_t nvs_entry_find(const char* part_name, const char* namespace_name, nvs_type_t type) {
+    auto found = store.find(namespace_name);
+    if (found == store.end()) return nullptr;
+
+    nvs_iterator_t iterator = new sim_nvs_iterator;
+    iterator->ns = namespace_name;
+    iterator->type = type;
+    iterator->it = found->second.begin();
+    return skipToMatch(iterator);
+}
+
+nvs_iterator_t nvs_entry_next(nvs_iterator_t iterator) {
+    if (!iterator) return nullptr;
+    ++iterator->it;
+    return skipToMatch(iterator);
+}
+
+void nvs_entry_info(nvs_iterator_t iterator, nvs_entry_info_t* out_info) {
+    strncpy(out_info->namespace_name, iterator->ns.c_str(), sizeof(out_info->namespace_name) - 1);
+    out_info->namespace_name[sizeof(out_info->namespace_name) - 1] = '\0';
+    strncpy(out_info->key, iterator->it->first.c_str(), sizeof(out_info->key) - 1);
+    out_info->key[sizeof(out_info->key) - 1] = '\0';
+    out_info->type = iterator->it->second.type;
+}
+
+void nvs_release_iterator(nvs_iterator_t iterator) { delete iterator; }
@@ -0,0 +1,156 @@
+// Native simulator entry point. Runs the firmware's setup()/loop() against
+// the host stand-ins in this directory on a virtual clock, replaying a
+// scripted touch sequence, then dumps the framebuffer.
+//
+//   simulator [--script touches.txt] [--ms 2000] [--out frame.ppm] [--lux 0:200,5000:3] [--bench-hit 500]
+//   simulator --wifi-script wifi.txt [--ms n]
+//
+// --wifi-script runs WiFiManager alone against SimWiFiRadio (see
+// WiFiScript.h for the script format) and exits non-zero when an expect
+// fails.
+
+#include <Arduino.h>
+#include <chrono>
+#include "TAMC_GT911.h"
+#include "BH1750.h"
+#include "../DisplayManager.h"
+#include "../UI/HitGrid.h"
+#include "WiFiScript.h"
+
+// Unit test builds (pio test -e native) bring their own main()
+#ifndef PIO_UNIT_TESTING
+void setup();
+void loop();
+extern DisplayManager display;
+
+// Fixed-size widget for hit-test benchmarking
+class BenchWidget : public UIElement {
+public:
+    BenchWidget(int32_t x, int32_t y, int32_t w, int32_t h) : UIElement(x, y, w, h) {}
+    void draw(DisplayManager* display) override {}
+    bool onTouch(TouchPoint touch) override { return hitTest(touch.x, touch.y); }
+};
+
+static double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Compare grid dispatch against the linear walk it replaced
+static int benchHitTest(uint16_t widgetCount) {
+    const uint32_t LOOKUPS = 200000;
+    srand(1);
+
+    // Keyboard-sized targets scattered over the panel
+    UIElement** widgets = new UIElement*[widgetCount];
+    for (uint16_t i = 0; i < widgetCount; i++) {
+        widgets[i] = new BenchWidget(rand() % 760, rand() % 440, 30 + rand() % 50, 30 + rand() % 30);
+    }
+
+    int16_t* xs = new int16_t[LOOKUPS];
+    int16_t* ys = new int16_t[LOOKUPS];
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+        xs[i] = rand() % 800;
+        ys[i] = rand() % 480;
+    }
+
+    HitGrid grid;
+    auto start = std::chrono::steady_clock::now();
+    grid.build(widgets, widgetCount);
+    double buildNs = elapsedNs(start);
+
+    uint32_t linearHits = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+        for (uint16_t w = widgetCount; w > 0; w--) {
+            if (widgets[w - 1]->hitTest(xs[i], ys[i])) {
+                linearHits++;
+                break;
+            }
+        }
+    }
+    double linearNs = elapsedNs(start);
+
+    uint32_t gridHits = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+        if (grid.hitTest(xs[i], ys[i])) {
+            gridHits++;
+        }
+    }
+    double gridNs = elapsedNs(start);
+
+    printf("Hit-test benchmark: %u widgets, %u lookups\n", widgetCount, LOOKUPS);
+    printf("  grid build:  %.1f us (%u cell entries)\n", buildNs / 1000, grid.getEntryCount());
+    printf("  linear walk: %.1f ns/lookup (%u hits)\n", linearNs / LOOKUPS, linearHits);
+    printf("  grid lookup: %.1f ns/lookup (%u hits)\n", gridNs / LOOKUPS, gridHits);
+
+    for (uint16_t i = 0; i < widgetCount; i++) {
+        delete widgets[i];
+    }
+    delete[] widgets;
+    delete[] xs;
+    delete[] ys;
+
+    return linearHits == gridHits ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    const char* scriptPath = nullptr;
+    const char* outPath = "frame.ppm";
+    const char* wifiScriptPath = nullptr;
+    uint32_t runMs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--script") && i + 1 < argc) {
+            scriptPath = argv[++i];
+        } else if (!strcmp(argv[i], "--ms") && i + 1 < argc) {
+            runMs = strtoul(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (!strcmp(argv[i], "--lux") && i + 1 < argc) {
+            if (!sim::parseLuxSchedule(argv[++i])) {
+                fprintf(stderr, "ERROR: bad lux schedule %s (want <ms>:<lux>,...)\n", argv[i]);
+                return 2;
+            }
+        } else if (!strcmp(argv[i], "--wifi-script") && i + 1 < argc) {
+            wifiScriptPath = argv[++i];
+        } else if (!strcmp(argv[i], "--bench-hit")) {
+            uint16_t count = (i + 1 < argc) ? atoi(argv[++i]) : 500;
+            return benchHitTest(count > 0 ? count : 500);
+        } else {
+            fprintf(stderr, "usage: %s [--script file] [--ms n] [--out file.ppm] [--lux schedule] [--bench-hit n] [--wifi-script file]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (wifiScriptPath) {
+        int failures = sim::runWiFiScript(wifiScriptPath, runMs);
+        return failures == 0 ? 0 : 1;
+    }
+
+    if (scriptPath && !sim::loadTouchScript(scriptPath)) {
+        fprintf(stderr, "ERROR: could not load touch script %s\n", scriptPath);
+        return 1;
+    }
+
+    setup();
+
+    // Run past the end of the script so the last release is processed
+    uint32_t endMs = millis() + (runMs ? runMs : sim::touchScriptEndMs() + 500);
+    uint32_t loops = 0;
+    while (millis() < endMs) {
+        loop();
+        loops++;
+    }
+
+    printf("\nSimulated %u loops (%lu ms), last frame wrote %u bytes\n",
+           loops, millis(), display.getFrameBytesWritten());
+
+    if (!display.getLGFX()->writePPM(outPath)) {
+        fprintf(stderr, "ERROR: could not write %s\n", outPath);
+        return 1;
+    }
+    printf("Framebuffer written to %s\n", outPath);
+    return 0;
+}
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,64 @@
+// BrightnessManager fades against the simulated BH1750 and panel: full
+// range down and back up, the backlight moving one way only and settling
+// on the curve's end points.
+//   pio test -e native
+#include <unity.h>
+#include "BH1750.h"
+#include "../../src/DisplayManager.h"
+#include "../../src/SettingsManager.h"
+#include "../../src/BrightnessManager.h"
+
+static DisplayManager display;
+static SettingsManager settings;
+static BrightnessManager brightness;
+
+// Runs the manager until untilMs (virtual time), failing if the output
+// ever moves against direction (+1 up, -1 down); returns the PWM writes
+static uint32_t runFade(uint32_t untilMs, int direction) {
+    uint32_t writesBefore = brightness.getStats().writes;
+    uint8_t last = display.getBrightness();
+    while ((int32_t)(millis() - untilMs) < 0) {
+        delay(brightness.update());
+        uint8_t level = display.getBrightness();
+        if (direction > 0) {
+            TEST_ASSERT_TRUE_MESSAGE(level >= last, "backlight dropped during a fade up");
+        } else {
+            TEST_ASSERT_TRUE_MESSAGE(level <= last, "backlight rose during a fade down");
+        }
+        last = level;
+    }
+    return brightness.getStats().writes - writesBefore;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_full_range_fades() {
+    const SettingsData& config = settings.get();
+    uint8_t low = config.brightnessCurve[0].level;
+    uint8_t high = config.brightnessCurve[BRIGHTNESS_CURVE_POINTS - 1].level;
+
+    // Dark room from full brightness, then daylight
+    uint32_t start = millis();
+    TEST_ASSERT_TRUE(sim::parseLuxSchedule("0:0,20000:100000"));
+    display.setBrightness(255);
+
+    runFade(start + 20000, -1);
+    TEST_ASSERT_EQUAL_UINT8(low, display.getBrightness());
+
+    uint32_t writes = runFade(start + 40000, +1);
+    TEST_ASSERT_EQUAL_UINT8(high, display.getBrightness());
+    TEST_ASSERT_EQUAL_UINT8(high, brightness.getTargetLevel());
+    // One write per level at most, not a wrapped fade going round again
+    TEST_ASSERT_TRUE(writes <= (uint32_t)(high - low));
+}
+
+int main(int argc, char** argv) {
+    display.begin();
+    settings.begin();
+    brightness.begin(&display, &settings, nullptr);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_full_range_fades);
+    return UNITY_END();
+}
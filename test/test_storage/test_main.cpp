@@ -0,0 +1,67 @@
+// StorageManager's NVS transactions and WiFi key cache against the
+// in-memory NVS stand-in. Each check reads through the cache, then again
+// after reloading it from "flash", so the two can't disagree.
+//   pio test -e native
+#include <unity.h>
+#include "../../src/StorageManager.h"
+
+static void assertCredentials(const char* ssid, const char* password) {
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) StorageManager::beginCache();  // As after a reboot
+
+        String savedSsid, savedPassword;
+        TEST_ASSERT_TRUE(StorageManager::loadWiFiCredentials(savedSsid, savedPassword));
+        TEST_ASSERT_EQUAL_STRING(ssid, savedSsid.c_str());
+        TEST_ASSERT_EQUAL_STRING(password, savedPassword.c_str());
+    }
+}
+
+void setUp() {
+    StorageManager::clearWiFiCredentials();
+    StorageManager::beginCache();
+    TEST_ASSERT_TRUE(StorageManager::saveWiFiCredentials("HomeNet", "secret123"));
+}
+
+void tearDown() {}
+
+static void test_unchanged_write_is_skipped() {
+    uint32_t writes = StorageManager::getStats().writes;
+    TEST_ASSERT_TRUE(StorageManager::saveWiFiCredentials("HomeNet", "secret123"));
+    TEST_ASSERT_EQUAL_UINT32(writes, StorageManager::getStats().writes);
+    assertCredentials("HomeNet", "secret123");
+}
+
+static void test_erase_then_put_same_value() {
+    NVSTransaction tx(StorageManager::CACHED_NAMESPACE);
+    tx.eraseAll();
+    tx.putString("ssid", "HomeNet");
+    tx.putString("password", "secret123");
+    tx.putBool("provisioned", true);
+    TEST_ASSERT_TRUE(tx.commit());
+    assertCredentials("HomeNet", "secret123");
+}
+
+static void test_remove_then_put_same_value() {
+    NVSTransaction tx(StorageManager::CACHED_NAMESPACE);
+    tx.remove("ssid");
+    tx.putString("ssid", "HomeNet");
+    TEST_ASSERT_TRUE(tx.commit());
+    assertCredentials("HomeNet", "secret123");
+}
+
+static void test_clear_removes_credentials() {
+    StorageManager::clearWiFiCredentials();
+    String ssid, password;
+    TEST_ASSERT_FALSE(StorageManager::loadWiFiCredentials(ssid, password));
+    StorageManager::beginCache();
+    TEST_ASSERT_FALSE(StorageManager::loadWiFiCredentials(ssid, password));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unchanged_write_is_skipped);
+    RUN_TEST(test_erase_then_put_same_value);
+    RUN_TEST(test_remove_then_put_same_value);
+    RUN_TEST(test_clear_removes_credentials);
+    return UNITY_END();
+}
@@ -0,0 +1,32 @@
+// WiFiManager against SimWiFiRadio: replays the .wifi scripts next to this
+// file on the virtual clock and fails on any unmet expect line.
+//   pio test -e native
+// A failing script's trace is on stdout; run it alone with
+//   .pio/build/native/program --wifi-script test/test_wifi/<name>.wifi
+#include <string>
+#include <unity.h>
+#include "WiFiScript.h"
+
+static void runScript(const char* name) {
+    std::string path = __FILE__;
+    path.erase(path.find_last_of("/\\") + 1);
+    path += name;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, sim::runWiFiScript(path.c_str()), path.c_str());
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_outage_backs_off() { runScript("outage_backoff.wifi"); }
+static void test_ap_channel_change() { runScript("channel_change.wifi"); }
+static void test_fast_connect_falls_back_to_scan() { runScript("fast_connect_fallback.wifi"); }
+static void test_provisioning() { runScript("provisioning.wifi"); }
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_outage_backs_off);
+    RUN_TEST(test_ap_channel_change);
+    RUN_TEST(test_fast_connect_falls_back_to_scan);
+    RUN_TEST(test_provisioning);
+    return UNITY_END();
+}